@@ -7,59 +7,406 @@
 //
 
 //#define DEBUG_TRIANGLES 1
+//#define CHECK_SIMD_TESSELLATION 1
 
 #include "vector_display.h"
 #include "vector_display_utils.h"
+#include "vector_display_simd.h"
+#include "vector_display_soft.h"
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <float.h>
 #include <math.h>
+#include <stdio.h>
 
 #include "vector_display_glinc.h"
 
+// expanding lines on the GPU needs instanced drawing and gl_VertexID
+#if defined(GL_ES_VERSION_3_0) || defined(GL_VERSION_3_3)
+#    define HAVE_GPU_LINES 1
+#endif
+
+// uploads can map buffers with OpenGL 3.0 or OpenGL ES 3.0
+#if defined(GL_ES_VERSION_3_0) || defined(GL_VERSION_3_0)
+#    define HAVE_MAP_BUFFER_RANGE 1
+#endif
+
+// vertex array objects come with OpenGL 3.0 and OpenGL ES 3.0, or OES_vertex_array_object on ES 2.0
+#if defined(GL_ES_VERSION_3_0) || defined(GL_VERSION_3_0)
+#    define HAVE_VERTEX_ARRAYS 1
+#elif defined(GL_OES_vertex_array_object)
+#    define HAVE_VERTEX_ARRAYS 1
+#    define glGenVertexArrays    glGenVertexArraysOES
+#    define glBindVertexArray    glBindVertexArrayOES
+#    define glDeleteVertexArrays glDeleteVertexArraysOES
+#endif
+
+// accumulated frames fade in half floats where the context can render to them,
+// and otherwise in 8 bits, where they are taken off half a step every update
+// so they always reach black. Half floats only need a much smaller step.
+#define ACCUM_FADE_RGBA8 (0.5 / 255.0)
+#define ACCUM_FADE_HALF  (1.0 / 65536.0)
+
 #define TEXTURE_SIZE 64
 #define HALF_TEXTURE_SIZE (TEXTURE_SIZE/2)
 
+// line vertex positions are stored as 16-bit fixed point, with as many
+// subdivisions per pixel as the size of the display leaves room for: 8 up to
+// 4095 pixels, 4 up to 8191 and so on. Geometry beyond the range is clamped,
+// which only affects lines that leave the screen. Each mesh keeps the
+// subdivisions it was packed with, as the display can be resized since.
+#define MAX_POSITION_SUBPIXELS (8)
+#define MAX_POSITION           (32767)
+
 #define min(x,y) ((x) < (y) ? (x) : (y))
 #define max(x,y) ((x) > (y) ? (x) : (y))
+#define countof(a) (sizeof(a) / sizeof((a)[0]))
+
+// atomic exchange and load of an int, ordered with the memory they hand over
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#    define atomic_swap(p, v)   _InterlockedExchange((volatile long*)(p), (v))
+#    define atomic_get(p)       _InterlockedOr((volatile long*)(p), 0)
+#else
+#    define atomic_swap(p, v)   __atomic_exchange_n((p), (v), __ATOMIC_ACQ_REL)
+#    define atomic_get(p)       __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#endif
 
 typedef struct {
     float x, y, z;
     float u, v;
 } nocolor_point_t;
 
+//
+// Packed line vertex: 12 bytes, vs. 36 bytes for x,y,z,r,g,b,a,u,v as floats.
+// z is constant so it lives in the shader instead of the vertex.
+//
 typedef struct {
-    float x, y, z;
-    float r, g, b, a;
-    float u, v;
+    GLshort  x, y;                             // position, in 1/subpixels pixels of the mesh
+    GLubyte  r, g, b, a;                       // color, normalized
+    GLushort u, v;                             // line texture coordinates, normalized
 } point_t;
 
+//
+// One line segment for the GPU line path, drawn as one instance. The vertex
+// shader builds the body, caps and join fan that draw_lines would have built
+// on the CPU, using the neighboring segments to work out the joins.
+//
+#define SEGMENT_LINKS_PREV (1)              // (xp, yp) -> (x0, y0) is joined to this segment
+#define SEGMENT_LINKS_NEXT (2)              // (x1, y1) -> (xn, yn) is joined to this segment
+
+typedef struct {
+    GLshort  xp, yp;                           // start of the previous segment
+    GLubyte  r, g, b, a;                       // color, normalized
+    GLshort  x0, y0, x1, y1;                   // this segment
+    GLshort  xn, yn;                           // end of the next segment
+    GLushort thickness;                        // in 1/subpixels pixels of the mesh
+    GLushort links;                            // SEGMENT_LINKS_*
+} segment_t;
+
 typedef struct {
     double x, y;
 } pending_point_t;
 
-struct vector_display {
+//
+// A run of triangles drawn with one glDrawElements call. Indices are 16-bit
+// and relative to first_point, so each batch addresses at most 65536 points.
+//
+#define MAX_BATCH_POINTS (65536)
+
+typedef struct {
+    int first_point;
+    int first_index;
+    int npoints;
+    int nindices;
+} batch_t;
+
+//
+// Tessellated output: shared vertices plus triangle indices into them, and
+// segments for the GPU to expand itself.
+//
+typedef struct {
+    int subpixels;                             // positions are in 1/subpixels pixels
+    int both_lines;                            // lines went in as triangles and as segments, see gpu_lines_pending
+
+    int cpoints;
+    int npoints;
+    point_t *points;
+
+    int cindices;
+    int nindices;
+    GLushort *indices;
+
+    int cbatches;
+    int nbatches;
+    batch_t *batches;
+
+    int csegments;
+    int nsegments;
+    segment_t *segments;
+} mesh_t;
+
+//
+// Vertex array objects for a vertex, index and segment buffer, made when the
+// buffers are first drawn. Batches each point the attributes at their first
+// point, so the batch attributes are only set again when the first point
+// changes.
+//
+typedef struct {
+    GLuint batches;
+    GLuint segments;
+    int    base_point;                         // first point the batch attributes point at, or -1
+} vertex_arrays_t;
+
+//
+// A recorded display list. Lists are reference counted: the owner holds one
+// reference, and every frame or decay history step that draws the list holds
+// another. Lists whose count drops to zero are collected at the next update
+// or teardown, when the OpenGL context is known to be current, and kept with
+// their memory and buffers for vector_display_list_new to hand out again.
+//
+struct vector_display_list {
+    vector_display_t      *display;
+    vector_display_list_t *next;               // all lists of the display
+    int    refs;
+
+    mesh_t mesh;
+    int    uploaded;                           // the buffers hold mesh
+    int    bounds[4];                          // min x, min y, max x, max y of the recorded positions
+
+    GLuint vertexbuffer;
+    GLuint indexbuffer;
+    GLuint segmentbuffer;
+    vertex_arrays_t arrays;
+};
+
+//
+// One replay of a display list, with the transform it was replayed with.
+//
+typedef struct {
+    vector_display_list_t *list;
+    float offset_x, offset_y, scale;
+} list_draw_t;
+
+//
+// One frame of the decay history, as uploaded to the GPU. The buffers keep
+// their storage from frame to frame, and only reallocate it to grow.
+//
+typedef struct {
+    GLuint vertexbuffer;
+    GLuint indexbuffer;
+    size_t vertexbytes;                        // storage size of vertexbuffer
+    size_t indexbytes;
+    int cbatches;
+    int nbatches;
+    batch_t *batches;
+
+    GLuint segmentbuffer;
+    size_t segmentbytes;
+    int nsegments;
+
+    int clist_draws;
+    int nlist_draws;
+    list_draw_t *list_draws;
+
+    vertex_arrays_t arrays;
+    int subpixels;                             // of the positions in the buffers
+
+    mesh_t mesh;                               // the frame, kept here instead by the software renderer
+} history_t;
+
+//
+// Scratch memory for the draw path, handed out by bumping a pointer and all
+// released at once by scratch_reset. When a frame needs more than the first
+// block holds, further blocks are chained on; the next reset replaces the
+// chain with a single block of the high-water size, so a scene that has been
+// drawn once draws again without allocating.
+//
+#define SCRATCH_ALIGN          (16)
+#define SCRATCH_ROUND(n)       (((n) + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1))
+#define SCRATCH_MIN_BLOCK_SIZE (16384)
+
+typedef struct scratch_block scratch_block_t;
+struct scratch_block {
+    scratch_block_t *next;
+    size_t size;                                // usable bytes after the header
+    size_t used;
+};
+
+typedef struct {
+    scratch_block_t *blocks;                    // current block first
+    size_t used;                                // bytes in use across all blocks
+    size_t high_water;                          // most bytes ever in use at once
+} scratch_t;
+
+//
+// The OpenGL state update last set, so that it isn't set again. Update forgets
+// it when it starts, since the application may change any of it in between,
+// except for uniform values, which only our own programs hold. Vertex array
+// state only describes vertex array 0, which is all that is drawn with when
+// vertex array objects aren't available.
+//
+#define GL_STATE_UNKNOWN ((GLuint)~0u)
+
+typedef struct {
+    GLuint program;
+    GLuint framebuffer;
+    GLuint texture;
+    GLuint array_buffer;
+    GLuint element_buffer;
+    GLuint vertex_array;
+    GLuint quad_attribs;                       // quad buffer the attributes point into
+    GLuint enabled_attribs;                    // one bit per attribute
+    GLuint blend;
+    GLenum blend_src, blend_dst;
+    GLenum blend_rgb, blend_alpha;
+    GLint  viewport_x, viewport_y, viewport_width, viewport_height;
+} gl_state_t;
+
+#define UNIFORM_CACHE_SIZE (64)
+
+typedef struct {
+    GLuint  program;
+    GLuint  location;
+    GLfloat value[16];
+} uniform_value_t;
+
+//
+// A compiled blur program, cached by its kernel. Programs no display is using
+// are kept until there are more than BLUR_PROGRAM_CACHE_SIZE programs.
+//
+#define BLUR_PROGRAM_CACHE_SIZE (4)
+
+typedef struct {
+    double sigma;
+    int radius;
+    int refs;                   // displays using it
+    unsigned last_used;
+    int pending;                // build hasn't been finished
+    vector_display_program_t build;
+    GLuint program;
+    GLuint uniform_modelview;
+    GLuint uniform_projection;
+    GLuint uniform_scale;
+    GLuint uniform_alpha;
+    GLuint uniform_mult;
+} blur_program_t;
+
+//
+// A line program that works out the beam's profile in the fragment shader
+// instead of reading it from the line texture. Only compiled for displays that
+// ask for it.
+//
+typedef struct {
+    int tried;
+    int pending;                // build hasn't been finished
+    vector_display_program_t build;
+    GLuint program;
+    GLuint uniform_modelview;
+    GLuint uniform_projection;
+    GLuint uniform_alpha;
+    GLuint uniform_falloff;
+} beam_program_t;
+
+//
+// The programs every display needs, built together by setup_shared.
+//
+enum {
+    SHARED_FB_PROGRAM,
+    SHARED_SCREEN_PROGRAM,
+    SHARED_DECAY_PROGRAM,
+    SHARED_BLOOM_DOWN_PROGRAM,
+    SHARED_BLOOM_UP_PROGRAM,
+    SHARED_NPROGRAMS
+};
+
+//
+// What the displays set up in one OpenGL context can share: programs, the line
+// texture and the unit quad. They are created by the first display to be set
+// up and deleted when the last one is torn down.
+//
+struct vector_display_shared {
+    vector_display_alloc_cb_t cb_alloc;
+    void *alloc_ud;
+
+    int refs;                   // the creator's reference and the displays holding it
+    int setups;                 // displays set up with it
+    int setup_rc;               // what setting up the shared resources returned
+
+    int programs_pending;       // builds haven't been finished
+    vector_display_program_t builds[SHARED_NPROGRAMS];
+
     GLuint fb_program;       // program for drawing to the fb
     GLuint fb_uniform_modelview;
     GLuint fb_uniform_projection;
     GLuint fb_uniform_alpha;
 
+    int tried_segment_program;  // segment_program is only compiled for displays that want it
+    int segment_pending;        // segment_build hasn't been finished
+    vector_display_program_t segment_build;
+    GLuint segment_program;     // program for expanding segments to lines on the GPU
+    GLuint segment_uniform_modelview;
+    GLuint segment_uniform_projection;
+    GLuint segment_uniform_alpha;
+
+    beam_program_t fb_beam;     // fb_program and segment_program with the analytic beam profile
+    beam_program_t segment_beam;
+
     GLuint screen_program;       // program for blitting to the screen
     GLuint screen_uniform_modelview;
     GLuint screen_uniform_projection;
     GLuint screen_uniform_alpha;
     GLuint screen_uniform_mult;
 
+    blur_program_t *blur_programs;
+    int cblur_programs;
+    int nblur_programs;
+    unsigned blur_uses;
+
+    GLuint decay_program;       // program for fading accumulated frames
+    GLuint decay_uniform_modelview;
+    GLuint decay_uniform_projection;
+    GLuint decay_uniform_decay;
+    GLuint decay_uniform_fade;
+
+    GLuint bloom_down_program;  // programs for the bloom mip chain
+    GLuint bloom_down_uniform_modelview;
+    GLuint bloom_down_uniform_projection;
+    GLuint bloom_down_uniform_halfpixel;
+    GLuint bloom_up_program;
+    GLuint bloom_up_uniform_modelview;
+    GLuint bloom_up_uniform_projection;
+    GLuint bloom_up_uniform_halfpixel;
+    GLuint bloom_up_uniform_mult;
+
+    GLuint unit_vertexbuffer;           // covers (0,0) to (1,1), for targets of any size
+    GLuint unit_vertexarray;            // for it, if vertex_arrays
+
+    int vertex_arrays;                  // vertex array objects are in use
+
+    // uniform values are kept with the programs, whichever display set them
+    uniform_value_t uniforms[UNIFORM_CACHE_SIZE];
+    int nuniforms;
+
+    GLuint linetexid;
+};
+
+struct vector_display {
+    vector_display_alloc_cb_t cb_alloc;
+    void *alloc_ud;
+
+    vector_display_shared_t *shared;    // NULL until set or set up
+
     GLuint fb_scene;                  // framebuffer object
     GLuint fb_scene_texid;
 
-    GLuint blur_program;       // program for gaussian blur
-    GLuint blur_uniform_modelview;
-    GLuint blur_uniform_projection;
-    GLuint blur_uniform_scale;
-    GLuint blur_uniform_alpha;
-    GLuint blur_uniform_mult;
+    double blur_sigma;          // blur kernel for the glow
+    int blur_radius;
+    int blur;                   // index of the program for it in blur_programs, -1 if none
+
+    double beam_falloff;        // beam profile worked out in the shader, if > 0, else the line texture
 
     GLuint fb_glow0;            // framebuffer for glow0
     GLuint fb_glow0_texid;      // texture for blur
@@ -67,35 +414,71 @@ struct vector_display {
     GLuint fb_glow1;            // framebuffer for glow1
     GLuint fb_glow1_texid;      // texture for blur
 
+    GLuint fb_accum[2];         // framebuffers for accumulated frames, read and written in turn
+    GLuint fb_accum_texid[2];
+    int accum_read;             // the one holding the frames before this one
+    double accum_fade;          // taken off accumulated frames every update, for their format
+
+    int bloom_levels;           // glow through this many halved levels instead of blur passes, if > 0
+    double bloom_weights[VECTOR_DISPLAY_MAX_BLOOM_LEVELS];
+    GLuint fb_bloom[VECTOR_DISPLAY_MAX_BLOOM_LEVELS];
+    GLuint fb_bloom_texid[VECTOR_DISPLAY_MAX_BLOOM_LEVELS];
+    int bloom_width[VECTOR_DISPLAY_MAX_BLOOM_LEVELS];
+    int bloom_height[VECTOR_DISPLAY_MAX_BLOOM_LEVELS];
+
     double width, height;
     double glow_width, glow_height;
+    int subpixels;              // position subdivisions of the meshes started from now on
 
     int steps;
+    int ring_steps;             // decay steps asked for, kept while accumulating
+    int accumulate;             // fade through fb_accum instead of the history ring
     double decay;
     double r, g, b, a;
+    GLubyte color[4];           // r, g, b, a packed for point_t
 
     int nvectors;
 
-    int cpoints;
-    int npoints;
-    point_t *points;
+    mesh_t mesh;
+    mesh_t *target;             // where tessellated lines go: mesh, or the list being recorded
+
+    vector_display_list_t *lists;
+    vector_display_list_t *free_lists;         // collected, for reuse
+    vector_display_list_t *recording;
+
+    int clist_draws;            // display lists replayed this frame
+    int nlist_draws;
+    list_draw_t *list_draws;
 
     int pending_cpoints;
     int pending_npoints;
     pending_point_t *pending_points;
 
+    vector_display_t *owner;            // the display a recorder records for, NULL for displays
+    vector_display_t *recorders;        // in the order they were created
+    vector_display_t *next_recorder;
+
+    mesh_t *frames;                     // a frame recorder's published frames, else NULL
+    int frame_back;                     // the frame mesh is moved into when published
+    int frame_front;                    // the frame update draws
+    int frame_middle;                   // the frame between them, atomic, | FRAME_FRESH if newer than the front
+
     int step;
-    GLuint *buffers;
-    GLuint *buffernpoints;
+    history_t *history;
 
-    GLuint screen2screen_vertexbuffer;
-    GLuint screen2glow_vertexbuffer;
-    GLuint glow2screen_vertexbuffer;
-    GLuint glow2glow_vertexbuffer;
+    scratch_t scratch;
 
-    GLuint linetexid;
+    gl_state_t gl;
+
+    vector_display_soft_t *soft;        // renders on the CPU instead, if set up for it
 
     int did_setup;
+    int ready;                  // 1 once its programs are linked, -1 if they failed
+
+    int use_gpu_lines;          // GPU line expansion is wanted, if the context can do it
+    int gpu_lines;              // GPU line expansion is in use
+    int gpu_lines_pending;      // it may still fall back, so lines are tessellated here as well
+    int map_buffers;            // uploads go through glMapBufferRange
 
     double initial_decay;
 
@@ -112,558 +495,1802 @@ struct vector_display {
 #define VERTEX_COLOR_INDEX     (1)
 #define VERTEX_TEXCOORD_INDEX  (2)
 
-static double effective_thickness(vector_display_t *self) {
-    if (self->custom_thickness) {
-        return self->thickness * self->scale / 2;
-    } else {
-        // this makes thickness=16 at 2048x1536
-        double v = (0.01 * (self->width + self->height) / 2.0) * self->scale / 2;
-        return max(v, 6);
-    }
+#define SEGMENT_PREV_INDEX     (0)
+#define SEGMENT_COLOR_INDEX    (1)
+#define SEGMENT_START_INDEX    (2)
+#define SEGMENT_END_INDEX      (3)
+#define SEGMENT_NEXT_INDEX     (4)
+#define SEGMENT_INFO_INDEX     (5)
+#define SEGMENT_NATTRIBS       (6)
+
+// triangles per segment: 2 for the body, 2 for each endcap and 4 for the fan
+#define SEGMENT_VERTICES       (30)
+
+static void reset_gl_state(vector_display_t *self, GLuint framebuffer) {
+    gl_state_t *gl = &self->gl;
+    gl->program         = GL_STATE_UNKNOWN;
+    gl->framebuffer     = framebuffer;
+    gl->texture         = GL_STATE_UNKNOWN;
+    gl->array_buffer    = GL_STATE_UNKNOWN;
+    gl->element_buffer  = GL_STATE_UNKNOWN;
+    gl->vertex_array    = GL_STATE_UNKNOWN;
+    gl->quad_attribs    = GL_STATE_UNKNOWN;
+    gl->enabled_attribs = GL_STATE_UNKNOWN;
+    gl->blend           = GL_STATE_UNKNOWN;
+    gl->blend_src       = gl->blend_dst   = GL_STATE_UNKNOWN;
+    gl->blend_rgb       = gl->blend_alpha = GL_STATE_UNKNOWN;
+    gl->viewport_x      = gl->viewport_y = 0;
+    gl->viewport_width  = gl->viewport_height = -1;
 }
 
-static int vector_display_init(vector_display_t *self, double width, double height) {
-    self->steps = VECTOR_DISPLAY_DEFAULT_DECAY_STEPS;
-    self->buffers = (GLuint*)calloc(sizeof(GLuint), self->steps);
-    self->buffernpoints = (GLuint*)calloc(sizeof(GLuint), self->steps);
+static void use_program(vector_display_t *self, GLuint program) {
+    if (self->gl.program == program) return;
+    glUseProgram(program);
+    self->gl.program = program;
+}
 
-    self->cpoints = 60;
-    self->points = (point_t*)calloc(sizeof(point_t), self->cpoints);
+static void bind_framebuffer(vector_display_t *self, GLuint framebuffer) {
+    if (self->gl.framebuffer == framebuffer) return;
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    self->gl.framebuffer = framebuffer;
+}
 
-    self->pending_cpoints = 60;
-    self->pending_points = (pending_point_t*)calloc(sizeof(pending_point_t), self->pending_cpoints);
+static void bind_texture(vector_display_t *self, GLuint texture) {
+    if (self->gl.texture == texture) return;
+    glBindTexture(GL_TEXTURE_2D, texture);
+    self->gl.texture = texture;
+}
 
-    self->decay = VECTOR_DISPLAY_DEFAULT_DECAY;
-    self->r = self->g = self->b = self->a = 1.0f;
-    self->width       = width;
-    self->height      = height;
-    self->glow_width  = width  / 3.0;
-    self->glow_height = height / 3.0;
-    self->initial_decay = VECTOR_DISPLAY_DEFAULT_INITIAL_DECAY;
+static void bind_buffer(vector_display_t *self, GLenum target, GLuint buffer) {
+    GLuint *bound = target == GL_ARRAY_BUFFER ? &self->gl.array_buffer : &self->gl.element_buffer;
+    if (*bound == buffer) return;
+    glBindBuffer(target, buffer);
+    *bound = buffer;
+}
 
-    self->offset_x   = VECTOR_DISPLAY_DEFAULT_OFFSET_X;
-    self->offset_y   = VECTOR_DISPLAY_DEFAULT_OFFSET_Y;
-    self->scale      = VECTOR_DISPLAY_DEFAULT_SCALE;
-    self->brightness = VECTOR_DISPLAY_DEFAULT_BRIGHTNESS;
+static void bind_vertex_array(vector_display_t *self, GLuint vertex_array) {
+#if HAVE_VERTEX_ARRAYS
+    if (self->gl.vertex_array == vertex_array) return;
+    glBindVertexArray(vertex_array);
+    self->gl.vertex_array   = vertex_array;
+    self->gl.element_buffer = GL_STATE_UNKNOWN;     // part of the vertex array
+#endif
+}
 
-    return 0;
+static void enable_attribs(vector_display_t *self, GLuint mask) {
+    GLuint enabled = self->gl.enabled_attribs == GL_STATE_UNKNOWN ? 0 : self->gl.enabled_attribs;
+    int i;
+    for (i = 0; i < SEGMENT_NATTRIBS; i++) {
+        if ((mask & (1u << i)) && !(enabled & (1u << i))) glEnableVertexAttribArray(i);
+    }
+    self->gl.enabled_attribs = enabled | mask;
 }
 
-int vector_display_set_transform(vector_display_t *self, double offset_x, double offset_y, double scale) {
-    vector_display_clear(self);
-    self->offset_x = offset_x;
-    self->offset_y = offset_y;
-    self->scale    = scale;
-    return 0;
+static void set_blend(vector_display_t *self, GLuint enable) {
+    if (self->gl.blend == enable) return;
+    if (enable) glEnable(GL_BLEND); else glDisable(GL_BLEND);
+    self->gl.blend = enable;
 }
 
-int vector_display_new(vector_display_t **out_self, double width, double height) {
-    vector_display_t *self = (vector_display_t*)calloc(sizeof(vector_display_t), 1);
-    if (self == NULL) return -1;
-    vector_display_init(self, width, height);
-    *out_self = self;
-    return 0;
+static void set_blend_func(vector_display_t *self, GLenum src, GLenum dst) {
+    if (self->gl.blend_src == src && self->gl.blend_dst == dst) return;
+    glBlendFunc(src, dst);
+    self->gl.blend_src = src;
+    self->gl.blend_dst = dst;
 }
 
-int vector_display_setup_res_dependent(vector_display_t *self) {
-    if (!self->did_setup) return 0;
+static void set_blend_equation(vector_display_t *self, GLenum rgb, GLenum alpha) {
+    if (self->gl.blend_rgb == rgb && self->gl.blend_alpha == alpha) return;
+    glBlendEquationSeparate(rgb, alpha);
+    self->gl.blend_rgb   = rgb;
+    self->gl.blend_alpha = alpha;
+}
 
-    GLuint origdrawbuffer;
-    glGetIntegerv(GL_FRAMEBUFFER_BINDING, (GLint*)&origdrawbuffer);
+static void set_viewport(vector_display_t *self, GLint x, GLint y, GLint width, GLint height) {
+    if (self->gl.viewport_x == x && self->gl.viewport_y == y &&
+        self->gl.viewport_width == width && self->gl.viewport_height == height) return;
+    glViewport(x, y, width, height);
+    self->gl.viewport_x      = x;
+    self->gl.viewport_y      = y;
+    self->gl.viewport_width  = width;
+    self->gl.viewport_height = height;
+}
 
-    // set up the framebuffer for the scene
-    glGenFramebuffers(1, &self->fb_scene);                                                                      vector_display_check_error("glGenFramebuffers");
-    glGenTextures(1, &self->fb_scene_texid);                                                                    vector_display_check_error("glGenTextures");
-    glBindFramebuffer(GL_FRAMEBUFFER, self->fb_scene);                                                          vector_display_check_error("glBindFramebuffer");
-    glBindTexture(GL_TEXTURE_2D, self->fb_scene_texid);                                                         vector_display_check_error("glBindTexture");
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, self->width, self->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);     vector_display_check_error("glTexImage2D");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);                                           vector_display_check_error("glTexParameteri GL_TEXTURE_MIN_FILTER");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);                                           vector_display_check_error("glTexParameteri GL_TEXTURE_MAG_FILTER");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);                                        vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_S");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);                                        vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_T");
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, self->fb_scene_texid, 0);       vector_display_check_error("glFramebufferTexture2D");
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) return -1;
+//
+// Returns whether a uniform of the current program is changing to value, and
+// remembers the new value. Values that don't fit in the cache always change.
+//
+static int uniform_changed(vector_display_t *self, GLuint location, const GLfloat *value, int n) {
+    vector_display_shared_t *shared = self->shared;
+    uniform_value_t *uniform;
+    int i;
+    for (i = 0; i < shared->nuniforms; i++) {
+        uniform = &shared->uniforms[i];
+        if (uniform->program != self->gl.program || uniform->location != location) continue;
+        if (memcmp(uniform->value, value, sizeof(GLfloat) * n) == 0) return 0;
+        memcpy(uniform->value, value, sizeof(GLfloat) * n);
+        return 1;
+    }
+    if (shared->nuniforms < UNIFORM_CACHE_SIZE) {
+        uniform = &shared->uniforms[shared->nuniforms++];
+        uniform->program  = self->gl.program;
+        uniform->location = location;
+        memcpy(uniform->value, value, sizeof(GLfloat) * n);
+    }
+    return 1;
+}
 
-    // set up the glow0 framebuffer
-    glGenFramebuffers(1, &self->fb_glow0);                                                                            vector_display_check_error("glGenFramebuffers");
-    glGenTextures(1, &self->fb_glow0_texid);                                                                          vector_display_check_error("glGenTextures");
-    glBindFramebuffer(GL_FRAMEBUFFER, self->fb_glow0);                                                                vector_display_check_error("glBindFramebuffer");
-    glBindTexture(GL_TEXTURE_2D, self->fb_glow0_texid);                                                               vector_display_check_error("glBindTexture");
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, self->glow_width, self->glow_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL); vector_display_check_error("glTexImage2D");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);                                                 vector_display_check_error("glTexParameteri GL_TEXTURE_MIN_FILTER");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);                                                 vector_display_check_error("glTexParameteri GL_TEXTURE_MAG_FILTER");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);                                              vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_S");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);                                              vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_T");
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, self->fb_glow0_texid, 0);             vector_display_check_error("glFramebufferTexture2D");
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) return -1;
+//
+// Forget the uniform values of a program that is being deleted, or of all
+// programs if program is 0, since their names may be handed out again.
+//
+static void forget_uniforms(vector_display_shared_t *shared, GLuint program) {
+    int i;
+    for (i = 0; i < shared->nuniforms; ) {
+        if (program == 0 || shared->uniforms[i].program == program) {
+            shared->uniforms[i] = shared->uniforms[--shared->nuniforms];
+        } else {
+            i++;
+        }
+    }
+}
 
-    // set up the glow1 framebuffer
-    glGenFramebuffers(1, &self->fb_glow1);                                                                            vector_display_check_error("glGenFramebuffers");
-    glGenTextures(1, &self->fb_glow1_texid);                                                                          vector_display_check_error("glGenTextures");
-    glBindFramebuffer(GL_FRAMEBUFFER, self->fb_glow1);                                                                vector_display_check_error("glBindFramebuffer");
-    glBindTexture(GL_TEXTURE_2D, self->fb_glow1_texid);                                                               vector_display_check_error("glBindTexture");
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, self->glow_width, self->glow_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL); vector_display_check_error("glTexImage2D");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);                                                 vector_display_check_error("glTexParameteri GL_TEXTURE_MIN_FILTER");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);                                                 vector_display_check_error("glTexParameteri GL_TEXTURE_MAG_FILTER");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);                                              vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_S");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);                                              vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_T");
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, self->fb_glow1_texid, 0);             vector_display_check_error("glFramebufferTexture2D");
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) return -1;
+static void set_uniform1f(vector_display_t *self, GLuint location, GLfloat x) {
+    if (uniform_changed(self, location, &x, 1)) glUniform1f(location, x);
+}
 
-    // set up vertex buffer for painting from glow-sized texture to screen-sized texture
-    nocolor_point_t glow2screen_points[] = {
-    //    x                 y                  z           u, v
-    //   ------------------------------------------------------------
-        { 0,                0,                 10000,      0, 1 },        // upper left triangle
-        { self->width,      self->height,      10000,      1, 0 },
-        { self->width,      0,                 10000,      1, 1 },
+static void set_uniform2f(vector_display_t *self, GLuint location, GLfloat x, GLfloat y) {
+    GLfloat value[2] = { x, y };
+    if (uniform_changed(self, location, value, 2)) glUniform2f(location, x, y);
+}
 
-        { 0,                0,                 10000,      0, 1 },        // lower right triangle
-        { 0,                self->height,      10000,      0, 0 },
-        { self->width, self->height,           10000,      1, 0 },
-    };
+static void set_uniform_matrix4(vector_display_t *self, GLuint location, const GLfloat *matrix) {
+    if (uniform_changed(self, location, matrix, 16)) glUniformMatrix4fv(location, 1, GL_FALSE, matrix);
+}
 
-    // load up vertex buffer
-    glBindBuffer(GL_ARRAY_BUFFER, self->glow2screen_vertexbuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glow2screen_points), glow2screen_points, GL_STATIC_DRAW);
+static void quad_attrib_pointers(void) {
+    glVertexAttribPointer(VERTEX_POS_INDEX,   3, GL_FLOAT, GL_TRUE,  sizeof(nocolor_point_t), 0);
+    glVertexAttribPointer(VERTEX_TEXCOORD_INDEX, 2, GL_FLOAT, GL_TRUE, sizeof(nocolor_point_t), (void*)(3 * sizeof(float)));
+}
 
-    // set up vertex buffer for painting from screen-sized texture to glow-sized texture
-    nocolor_point_t screen2glow_points[] = {
-    //    x                 y                  z           u, v
-    //   ------------------------------------------------------------
-        { 0,                0,                 10000,      0, 1 },        // upper left triangle
-        { self->glow_width, self->glow_height, 10000,      1, 0 },
-        { self->glow_width, 0,                 10000,      1, 1 },
+//
+// Set up to draw one of the fullscreen quad buffers.
+//
+static void bind_quad(vector_display_t *self, GLuint vertexbuffer, GLuint vertexarray) {
+    if (self->shared->vertex_arrays) {
+        bind_vertex_array(self, vertexarray);
+        return;
+    }
+    bind_buffer(self, GL_ARRAY_BUFFER, vertexbuffer);
+    if (self->gl.quad_attribs != vertexbuffer) {
+        quad_attrib_pointers();
+        self->gl.quad_attribs = vertexbuffer;
+    }
+    enable_attribs(self, (1u << VERTEX_POS_INDEX) | (1u << VERTEX_TEXCOORD_INDEX));
+}
 
-        { 0,                0,                 10000,      0, 1 },        // lower right triangle
-        { 0,                self->glow_height, 10000,      0, 0 },
-        { self->glow_width, self->glow_height, 10000,      1, 0 },
-    };
-    // load up vertex buffer
-    glBindBuffer(GL_ARRAY_BUFFER, self->screen2glow_vertexbuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(screen2glow_points), screen2glow_points, GL_STATIC_DRAW);
+#if HAVE_VERTEX_ARRAYS
+static GLuint gen_quad_vertexarray(GLuint vertexbuffer) {
+    GLuint vertexarray;
+    glGenVertexArrays(1, &vertexarray);
+    glBindVertexArray(vertexarray);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexbuffer);
+    quad_attrib_pointers();
+    glEnableVertexAttribArray(VERTEX_POS_INDEX);
+    glEnableVertexAttribArray(VERTEX_TEXCOORD_INDEX);
+    glBindVertexArray(0);
+    return vertexarray;
+}
+#endif
 
-    // set up vertex buffer for painting from screen-sized texture to screen-sized texture
-    nocolor_point_t screen2screen_points[] = {
-    //    x                 y                  z           u, v
-    //   ------------------------------------------------------------
-        { 0,                0,                 10000,      0, 1 },        // upper left triangle
-        { self->width,      self->height,      10000,      1, 0 },
-        { self->width,      0,                 10000,      1, 1 },
+static void delete_vertex_arrays(vertex_arrays_t *arrays) {
+#if HAVE_VERTEX_ARRAYS
+    if (arrays->batches)  glDeleteVertexArrays(1, &arrays->batches);
+    if (arrays->segments) glDeleteVertexArrays(1, &arrays->segments);
+#endif
+    arrays->batches  = 0;
+    arrays->segments = 0;
+}
 
-        { 0,                0,                 10000,      0, 1 },        // lower right triangle
-        { 0,                self->height,      10000,      0, 0 },
-        { self->width,      self->height,      10000,      1, 0 },
-    };
-    // load up vertex buffer
-    glBindBuffer(GL_ARRAY_BUFFER, self->screen2screen_vertexbuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(screen2screen_points), screen2screen_points, GL_STATIC_DRAW);
+static double effective_thickness(vector_display_t *self) {
+    if (self->custom_thickness) {
+        return self->thickness * self->scale / 2;
+    } else {
+        // this makes thickness=16 at 2048x1536
+        double v = (0.01 * (self->width + self->height) / 2.0) * self->scale / 2;
+        return max(v, 6);
+    }
+}
 
-    // set up vertex buffer for painting from glow-sized texture to glow-sized texture
+static GLubyte pack_unorm8(double v) {
+    if (v <= 0.0) return 0;
+    if (v >= 1.0) return 0xff;
+    return (GLubyte)(v * 0xff + 0.5);
+}
 
-    // load up vertex buffer
-    nocolor_point_t glow2glow_points[] = {
-    //    x                 y                  z           u, v
-    //   ------------------------------------------------------------
-        { 0,                0,                 10000,      0, 1 },        // upper left triangle
-        { self->glow_width, self->glow_height, 10000,      1, 0 },
-        { self->glow_width, 0,                 10000,      1, 1 },
-
-        { 0,                0,                 10000,      0, 1 },        // lower right triangle
-        { 0,                self->glow_height, 10000,      0, 0 },
-        { self->glow_width, self->glow_height, 10000,      1, 0 },
-    };
-    glBindBuffer(GL_ARRAY_BUFFER, self->glow2glow_vertexbuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glow2glow_points), glow2glow_points, GL_STATIC_DRAW);
-
-    // put back old framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, origdrawbuffer);
-
-    return 0;
-}
-
-int vector_display_teardown_res_dependent(vector_display_t *self) {
-    if (!self->did_setup) return 0;
-
-    glDeleteFramebuffers(1, &self->fb_scene);
-    glDeleteTextures(1, &self->fb_scene_texid);
-
-    glDeleteFramebuffers(1, &self->fb_glow0);
-    glDeleteTextures(1, &self->fb_glow0_texid);
-
-    glDeleteFramebuffers(1, &self->fb_glow1);
-    glDeleteTextures(1, &self->fb_glow1_texid);
-
-    return 0;
-}
-
-int vector_display_resize(vector_display_t *self, double width, double height) {
-    vector_display_teardown_res_dependent(self);
-    self->width = width;
-    self->height = height;
-    self->glow_width = width   / 3.0;
-    self->glow_height = height / 3.0;
-    vector_display_setup_res_dependent(self);
-    vector_display_clear(self);
-    return 0;
+static GLushort pack_unorm16(double v) {
+    if (v <= 0.0) return 0;
+    if (v >= 1.0) return 0xffff;
+    return (GLushort)(v * 0xffff + 0.5);
 }
 
-int vector_display_set_initial_decay(vector_display_t *self, double initial_decay) {
-    if (initial_decay < 0.0f || initial_decay >= 1.0f) return -1;
-    self->initial_decay = initial_decay;
-    return 0;
+static GLshort pack_position(double v, int subpixels) {
+    v *= subpixels;
+    if (v < -MAX_POSITION) v = -MAX_POSITION;
+    if (v >  MAX_POSITION) v =  MAX_POSITION;
+    return (GLshort)lrint(v);
 }
 
-int vector_display_set_thickness(vector_display_t *self, double thickness) {
-    if (thickness <= 0) return -1;
-    self->custom_thickness = 1;
-    self->thickness = thickness;
-    return 0;
+// a position packed with one number of subdivisions, in another, unclamped
+static int rescale_position(int v, int from, int to) {
+    int ratio;
+    if (from <= to) return v * (to / from);
+    ratio = from / to;
+    return (v + (v < 0 ? -ratio : ratio) / 2) / ratio;
 }
 
-int vector_display_set_default_thickness(vector_display_t *self) {
-    self->custom_thickness = 0;
-    return 0;
+static GLshort clamp_position(int v) {
+    return (GLshort)min(max(v, -MAX_POSITION), MAX_POSITION);
 }
 
-int vector_display_clear(vector_display_t *self) {
-    self->npoints = 0;
-    return 0;
+//
+// The most subdivisions that keep the whole display in range. Displays too
+// large even for whole pixels draw, but lose what is beyond MAX_POSITION pixels.
+//
+static void size_positions(vector_display_t *self) {
+    double size = max(self->width, self->height);
+    self->subpixels = MAX_POSITION_SUBPIXELS;
+    while (self->subpixels > 1 && size * self->subpixels > MAX_POSITION) self->subpixels /= 2;
+    if (size > MAX_POSITION) {
+        vector_display_debugf("display size %g is beyond the position range, clamping", size);
+    }
 }
 
-int vector_display_set_color(vector_display_t *self, double r, double g, double b) {
-    self->r = r;
-    self->g = g;
-    self->b = b;
-    return 0;
+static void pack_color(vector_display_t *self) {
+    self->color[0] = pack_unorm8(self->r);
+    self->color[1] = pack_unorm8(self->g);
+    self->color[2] = pack_unorm8(self->b);
+    self->color[3] = pack_unorm8(self->a);
 }
 
-static void ensure_pending_points(vector_display_t *self, int npoints) {
-    if (self->pending_cpoints < npoints) {
-        pending_point_t *newpoints = (pending_point_t*)calloc(sizeof(pending_point_t), self->pending_cpoints * 2);
-        self->pending_cpoints *= 2;
-        memcpy(newpoints, self->points, sizeof(pending_point_t) * self->pending_npoints);
-        free(self->pending_points);
-        self->pending_points = newpoints;
+static void *default_alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+    (void)ud;
+    (void)osize;
+    if (nsize == 0) {
+        free(ptr);
+        return NULL;
     }
+    return realloc(ptr, nsize);
 }
 
-static void ensure_points(vector_display_t *self, int npoints) {
-    if (self->cpoints < npoints) {
-        point_t *newpoints = (point_t*)calloc(sizeof(point_t), self->cpoints * 2);
-        self->cpoints *= 2;
-        memcpy(newpoints, self->points, sizeof(point_t) * self->npoints);
-        free(self->points);
-        self->points = newpoints;
+//
+// All memory owned by a display goes through these. Running out of memory in
+// the middle of tessellation can't be reported through the draw calls, so
+// allocation failures abort.
+//
+static void *vector_display_realloc(vector_display_t *self, void *ptr, size_t osize, size_t nsize) {
+    void *p = self->cb_alloc(self->alloc_ud, ptr, osize, nsize);
+    if (p == NULL && nsize != 0) {
+        vector_display_debugf("out of memory allocating %lu bytes", (unsigned long)nsize);
+        abort();
     }
+    return p;
 }
 
-static void append_texpoint(vector_display_t *self, double x, double y, double u, double v) {
-    ensure_points(self, self->npoints + 1);
+void vector_display_free(vector_display_t *self, void *ptr, size_t size) {
+    if (ptr != NULL) self->cb_alloc(self->alloc_ud, ptr, size, 0);
+}
 
-    self->points[self->npoints].x = x;
-    self->points[self->npoints].y = y;
-    self->points[self->npoints].z = 10000.0;
-    self->points[self->npoints].r = self->r;
-    self->points[self->npoints].g = self->g;
-    self->points[self->npoints].b = self->b;
-    self->points[self->npoints].a = self->a;
-    self->points[self->npoints].u = u / TEXTURE_SIZE;
-    self->points[self->npoints].v = 1.0f - v / TEXTURE_SIZE;
-    self->npoints++;
+// for memory kept on behalf of a display, which reports failures instead
+void *vector_display_alloc(vector_display_t *self, size_t size) {
+    return self->cb_alloc(self->alloc_ud, NULL, 0, size);
 }
 
-int vector_display_begin_draw(vector_display_t *self, double x, double y) {
-    if (self->pending_npoints != 0) {
-        vector_display_debugf("assertion failure");
+static void *shared_realloc(vector_display_shared_t *shared, void *ptr, size_t osize, size_t nsize) {
+    void *p = shared->cb_alloc(shared->alloc_ud, ptr, osize, nsize);
+    if (p == NULL && nsize != 0) {
+        vector_display_debugf("out of memory allocating %lu bytes", (unsigned long)nsize);
         abort();
     }
-    ensure_pending_points(self, self->pending_npoints + 1);
-    self->pending_points[self->pending_npoints].x = x * self->scale + self->offset_x;
-    self->pending_points[self->pending_npoints].y = y * self->scale + self->offset_y;
-    self->pending_npoints++;
-    return 0;
+    return p;
 }
 
-int vector_display_draw_to(vector_display_t *self, double x, double y) {
-    ensure_pending_points(self, self->pending_npoints + 1);
-    self->pending_points[self->pending_npoints].x = x * self->scale + self->offset_x;
-    self->pending_points[self->pending_npoints].y = y * self->scale + self->offset_y;
-    self->pending_npoints++;
-    return 0;
+//
+// Grow an array of elemsize-byte elements to hold at least needed elements,
+// at least doubling its capacity each time so that appending is amortized
+// O(1). The contents are kept.
+//
+static void grow_array(vector_display_t *self, void **array, int *capacity, int needed, size_t elemsize) {
+    if (*capacity >= needed) return;
+    int newcapacity = max(*capacity, 16);
+    while (newcapacity < needed) newcapacity *= 2;
+    *array    = vector_display_realloc(self, *array, elemsize * *capacity, elemsize * newcapacity);
+    *capacity = newcapacity;
 }
 
-static float normalizef(float a) {
-    while (a > 2*M_PI + FLT_EPSILON) a -= 2*M_PI;
-    while (a < 0 - FLT_EPSILON)      a += 2*M_PI;
-    return a;
+static void ensure_pending_points(vector_display_t *self, int npoints) {
+    grow_array(self, (void**)&self->pending_points, &self->pending_cpoints, npoints, sizeof(pending_point_t));
 }
 
-/*
-static double normalize(double a) {
-    while (a > 2*M_PI + DBL_EPSILON) a -= 2*M_PI;
-    while (a < 0 - DBL_EPSILON)      a += 2*M_PI;
-    return a;
+static void ensure_points(vector_display_t *self, mesh_t *mesh, int npoints) {
+    grow_array(self, (void**)&mesh->points, &mesh->cpoints, npoints, sizeof(point_t));
 }
-*/
-
-typedef struct {
-    float x0, y0, x1, y1;                      // nominal points
-    float a;                                   // angle
-    float sin_a, cos_a;                        // precomputed trig
-
-    float xl0, yl0, xl1, yl1;                  // left side of the box
-    float xr0, yr0, xr1, yr1;                  // right side of the box
 
-    int is_first, is_last;
-    int has_next, has_prev;                     // booleans indicating whether this line connects to prev/next
+static void ensure_indices(vector_display_t *self, mesh_t *mesh, int nindices) {
+    grow_array(self, (void**)&mesh->indices, &mesh->cindices, nindices, sizeof(GLushort));
+}
 
-    float xlt0, ylt0, xlt1, ylt1;              // coordinates of endcaps (if !has_prev/!has_next)
-    float xrt0, yrt0, xrt1, yrt1;              // coordinates of endcaps (if !has_prev/!has_next)
+static void ensure_batches(vector_display_t *self, mesh_t *mesh, int nbatches) {
+    grow_array(self, (void**)&mesh->batches, &mesh->cbatches, nbatches, sizeof(batch_t));
+}
 
-    float tl0, tl1, tr0, tr1;
+static void ensure_segments(vector_display_t *self, mesh_t *mesh, int nsegments) {
+    grow_array(self, (void**)&mesh->segments, &mesh->csegments, nsegments, sizeof(segment_t));
+}
 
-    float s0, s1;                              // shorten line by this amount
+static void free_mesh(vector_display_t *self, mesh_t *mesh) {
+    vector_display_free(self, mesh->points,   sizeof(point_t)   * mesh->cpoints);
+    vector_display_free(self, mesh->indices,  sizeof(GLushort)  * mesh->cindices);
+    vector_display_free(self, mesh->batches,  sizeof(batch_t)   * mesh->cbatches);
+    vector_display_free(self, mesh->segments, sizeof(segment_t) * mesh->csegments);
+    memset(mesh, 0, sizeof(*mesh));
+}
 
-    float len;
-} line_t;
+static void *scratch_block_data(scratch_block_t *block) {
+    return (char*)block + SCRATCH_ROUND(sizeof(scratch_block_t));
+}
 
-void draw_fan(vector_display_t *self, float cx, float cy, float pa, float a, float t, float s, float e) {
-    float *angles;
-    int     nsteps;
-    float  pa2a        = normalizef(a - pa);
-    float  a2pa        = normalizef(pa - a);
+static scratch_block_t *scratch_new_block(vector_display_t *self, size_t size) {
+    scratch_block_t *block = (scratch_block_t*)vector_display_realloc(self, NULL, 0, SCRATCH_ROUND(sizeof(scratch_block_t)) + size);
+    block->next = self->scratch.blocks;
+    block->size = size;
+    block->used = 0;
+    self->scratch.blocks = block;
+    return block;
+}
 
-    int i;
-    if (a2pa < pa2a) {
-        t = -t;
-        nsteps = max(1, round(a2pa / (M_PI / 8)));
-        angles = alloca(sizeof(float) * (nsteps + 1));
-        for (i = 0; i <= nsteps; i++)
-            angles[i] = a + i * a2pa / nsteps;
-        //vector_display_debugf("%fd in %d steps", a2pa, nsteps);
-    } else {
-        nsteps = max(1, round(pa2a / (M_PI / 8)));
-        angles = alloca(sizeof(float) * (nsteps + 1));
-        for (i = 0; i <= nsteps; i++)
-            angles[i] = pa + i * pa2a / nsteps;
-        //vector_display_debugf("%fd in %d steps", pa2a, nsteps);
+static void scratch_free_blocks(vector_display_t *self) {
+    scratch_block_t *block = self->scratch.blocks, *next;
+    for (; block != NULL; block = next) {
+        next = block->next;
+        vector_display_free(self, block, SCRATCH_ROUND(sizeof(scratch_block_t)) + block->size);
     }
-    //vector_display_debugf("---- %f -> %f nsteps=%d", 360*pa/M_PI/2, 360*a/M_PI/2, 360*pa2a/M_PI/2, 360*a2pa/M_PI/2, nsteps);
+    self->scratch.blocks = NULL;
+}
 
-    for (i = 1; i <= nsteps; i++) {
-#if DEBUG_TRIANGLES
-        self->a = 0.5;
-        append_texpoint(self, cx + t * sin(angles[i-1]), cy - t * cos(angles[i-1]), HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
-        append_texpoint(self, cx, cy,                                               HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
-        append_texpoint(self, cx + t * sin(angles[i]),   cy - t * cos(angles[i]),   HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
-        self->a = 1.0;
-#else
-        append_texpoint(self, cx + t * sin(angles[i-1]), cy - t * cos(angles[i-1]), e, HALF_TEXTURE_SIZE);
-        append_texpoint(self, cx, cy,                                               s, HALF_TEXTURE_SIZE);
-        append_texpoint(self, cx + t * sin(angles[i]),   cy - t * cos(angles[i]),   e, HALF_TEXTURE_SIZE);
-#endif
+//
+// Returns uninitialized memory, aligned to SCRATCH_ALIGN bytes, that stays
+// valid until the next scratch_reset.
+//
+static void *scratch_alloc(vector_display_t *self, size_t size) {
+    scratch_t       *scratch = &self->scratch;
+    scratch_block_t *block   = scratch->blocks;
+    size = SCRATCH_ROUND(size);
+    if (block == NULL || block->size - block->used < size) {
+        block = scratch_new_block(self, max(size, max(scratch->high_water, SCRATCH_MIN_BLOCK_SIZE)));
     }
+    void *p = (char*)scratch_block_data(block) + block->used;
+    block->used    += size;
+    scratch->used  += size;
+    scratch->high_water = max(scratch->high_water, scratch->used);
+    return p;
 }
 
-static void draw_lines(vector_display_t *self, line_t *lines, int nlines) {
-    int    i;
-    float t = effective_thickness(self);
-
-    for (i = 0; i < nlines; i++) {
-        line_t *line  = &lines[i], *pline = &lines[(nlines+i-1)%nlines];
-
-        if (line->has_prev) {   // draw fan for connection to previous
-            float  pa2a = normalizef(pline->a -  line->a);
-            float  a2pa = normalizef( line->a - pline->a);
-            if (a2pa < pa2a) {  // inside of fan on right
-                draw_fan(self, line->xr0, line->yr0, pline->a, line->a, line->tl0 + line->tr0, HALF_TEXTURE_SIZE + (line->tr0 / t * HALF_TEXTURE_SIZE), 0);
-            } else {            // inside of fan on left
-                draw_fan(self, line->xl0, line->yl0, pline->a, line->a, line->tl0 + line->tr0, HALF_TEXTURE_SIZE - (line->tl0 / t * HALF_TEXTURE_SIZE), TEXTURE_SIZE);
-            }
-        }
-
-        float tl0 = HALF_TEXTURE_SIZE - (line->tl0 / t) * HALF_TEXTURE_SIZE;
-        float tl1 = HALF_TEXTURE_SIZE - (line->tl1 / t) * HALF_TEXTURE_SIZE;
-
-        float tr0 = HALF_TEXTURE_SIZE + (line->tr0 / t) * HALF_TEXTURE_SIZE;
-        float tr1 = HALF_TEXTURE_SIZE + (line->tr1 / t) * HALF_TEXTURE_SIZE;
-
-#if DEBUG_TRIANGLES
-        self->a = 0.5;
-        self->r = 1.0; self->g = 0.8; self->b = 0.8;
-        append_texpoint(self, line->xr0,  line->yr0,  HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
-        append_texpoint(self, line->xr1,  line->yr1,  HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
-        append_texpoint(self, line->xl1,  line->yl1,  HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
-        append_texpoint(self, line->xl0,  line->yl0,  HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
-        append_texpoint(self, line->xr0,  line->yr0,  HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
-        append_texpoint(self, line->xl1,  line->yl1,  HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
-        self->r = 1.0; self->g = 1.0; self->b = 1.0;
-        self->a = 1.0;
-#else
-        append_texpoint(self, line->xr0,  line->yr0,  tr0, HALF_TEXTURE_SIZE);
-        append_texpoint(self, line->xr1,  line->yr1,  tr1, HALF_TEXTURE_SIZE);
-        append_texpoint(self, line->xl1,  line->yl1,  tl1, HALF_TEXTURE_SIZE);
-        append_texpoint(self, line->xl0,  line->yl0,  tl0, HALF_TEXTURE_SIZE);
-        append_texpoint(self, line->xr0,  line->yr0,  tr0, HALF_TEXTURE_SIZE);
-        append_texpoint(self, line->xl1,  line->yl1,  tl1, HALF_TEXTURE_SIZE);
-#endif
-
-        if (!line->has_prev) { // draw startcap
-            append_texpoint(self, line->xl0,  line->yl0,  tl0,          HALF_TEXTURE_SIZE);
-            append_texpoint(self, line->xlt0, line->ylt0, tl0,          0.0f);
-            append_texpoint(self, line->xr0,  line->yr0,  tr0,          HALF_TEXTURE_SIZE);
-            append_texpoint(self, line->xr0,  line->yr0,  tr0,          HALF_TEXTURE_SIZE);
-            append_texpoint(self, line->xlt0, line->ylt0, tl0,          0.0f);
-            append_texpoint(self, line->xrt0, line->yrt0, tr0,          0.0f);
-        }
+static void scratch_reset(vector_display_t *self) {
+    scratch_t *scratch = &self->scratch;
+    if (scratch->blocks != NULL && scratch->blocks->next != NULL) {
+        scratch_free_blocks(self);
+        scratch_new_block(self, scratch->high_water);
+    }
+    if (scratch->blocks != NULL) scratch->blocks->used = 0;
+    scratch->used = 0;
+}
 
-        if (!line->has_next) { // draw endcap
-            append_texpoint(self, line->xlt1, line->ylt1, tl1,          0.0f);
-            append_texpoint(self, line->xl1,  line->yl1,  tl1,          HALF_TEXTURE_SIZE);
-            append_texpoint(self, line->xr1,  line->yr1,  tr1,          HALF_TEXTURE_SIZE);
-            append_texpoint(self, line->xlt1, line->ylt1, tl1,          0.0f);
-            append_texpoint(self, line->xr1,  line->yr1,  tr1,          HALF_TEXTURE_SIZE);
-            append_texpoint(self, line->xrt1, line->yrt1, tr1,          0.0f);
-        }
+static void alloc_history(vector_display_t *self) {
+    self->history = (history_t*)vector_display_realloc(self, NULL, 0, sizeof(history_t) * self->steps);
+    if (self->history != NULL) memset(self->history, 0, sizeof(history_t) * self->steps);
+}
 
+static void retain_list_draws(list_draw_t *draws, int ndraws) {
+    int i;
+    for (i = 0; i < ndraws; i++) {
+        draws[i].list->refs++;
     }
 }
 
-int vector_display_end_draw(vector_display_t *self) {
-    if (self->pending_npoints < 2) {
-        self->pending_npoints = 0;
-        return 0;
+static void release_list_draws(list_draw_t *draws, int ndraws) {
+    int i;
+    for (i = 0; i < ndraws; i++) {
+        draws[i].list->refs--;
     }
+}
 
-    float t = effective_thickness(self);
+static void free_history(vector_display_t *self) {
     int i;
-    int  first_last_same = abs(self->pending_points[0].x - self->pending_points[self->pending_npoints-1].x) < 0.1 &&
-                           abs(self->pending_points[0].y - self->pending_points[self->pending_npoints-1].y) < 0.1;
+    for (i = 0; i < self->steps; i++) {
+        release_list_draws(self->history[i].list_draws, self->history[i].nlist_draws);
+        vector_display_free(self, self->history[i].batches, sizeof(batch_t) * self->history[i].cbatches);
+        vector_display_free(self, self->history[i].list_draws, sizeof(list_draw_t) * self->history[i].clist_draws);
+        free_mesh(self, &self->history[i].mesh);
+    }
+    vector_display_free(self, self->history, sizeof(history_t) * self->steps);
+    self->history = NULL;
+}
 
-    // from the list of points, build a list of lines
-    int     nlines = self->pending_npoints-1;
-    line_t *lines  = (line_t*)alloca((self->pending_npoints-1) * sizeof(line_t));
+static int vector_display_init(vector_display_t *self, double width, double height) {
+    self->target = &self->mesh;
+    ensure_points(self, &self->mesh, 64);
+    ensure_indices(self, &self->mesh, 96);
+    ensure_batches(self, &self->mesh, 1);
 
-    // compute basics
-    for (i = 1; i < self->pending_npoints; i++) {
-        line_t *line = &lines[i-1];
-        line->is_first = i == 1;
-        line->is_last  = i == self->pending_npoints - 1;
+    ensure_pending_points(self, 64);
 
-        // precomputed info for current line
-        line->x0    = self->pending_points[i-1].x;
-        line->y0    = self->pending_points[i-1].y;
-        line->x1    = self->pending_points[i].x;
-        line->y1    = self->pending_points[i].y;
-        line->a     = atan2(line->y1 - line->y0, line->x1 - line->x0); // angle from positive x axis, increasing ccw, [-pi, pi]
-        line->sin_a = sin(line->a);
-        line->cos_a = cos(line->a);
-        line->len   = sqrt(pow(line->x1-line->x0, 2) + pow(line->y1-line->y0, 2));
+    self->decay = VECTOR_DISPLAY_DEFAULT_DECAY;
+    self->r = self->g = self->b = self->a = 1.0f;
+    pack_color(self);
+    self->width       = width;
+    self->height      = height;
+    self->glow_width  = width  / 3.0;
+    self->glow_height = height / 3.0;
+    size_positions(self);
+    self->mesh.subpixels = self->subpixels;
+    self->initial_decay = VECTOR_DISPLAY_DEFAULT_INITIAL_DECAY;
 
-        // figure out what connections we have
-        line->has_prev = (!line->is_first || (line->is_first && first_last_same));
-        line->has_next = (!line->is_last  || (line->is_last  && first_last_same));
+    self->offset_x   = VECTOR_DISPLAY_DEFAULT_OFFSET_X;
+    self->offset_y   = VECTOR_DISPLAY_DEFAULT_OFFSET_Y;
+    self->scale      = VECTOR_DISPLAY_DEFAULT_SCALE;
+    self->brightness = VECTOR_DISPLAY_DEFAULT_BRIGHTNESS;
+    self->blur_sigma  = VECTOR_DISPLAY_DEFAULT_BLUR_SIGMA;
+    self->blur_radius = VECTOR_DISPLAY_DEFAULT_BLUR_RADIUS;
+    self->blur        = -1;
 
-        // initialize thicknesses/shortens to default values
-        line->tl0 = line->tl1 = line->tr0 = line->tr1 = t;
-        line->s0 = line->s1 = 0.0;
+    int i;
+    for (i = 0; i < VECTOR_DISPLAY_MAX_BLOOM_LEVELS; i++) {
+        self->bloom_weights[i] = VECTOR_DISPLAY_DEFAULT_BLOOM_WEIGHT;
     }
 
-    // compute adjustments for connected line segments
-    for (i = 0; i < nlines; i++) {
-        line_t *line  = &lines[i], *pline = &lines[(nlines+i-1)%nlines];
+    self->use_gpu_lines = 1;
 
-        if (line->has_prev) {
-            float pa2a       = normalizef(pline->a -  line->a);
-            float a2pa       = normalizef( line->a - pline->a);
-            float maxshorten = min(line->len, pline->len) / 2.0;
+    return 0;
+}
 
-            if (min(a2pa, pa2a) <= (M_PI / 2 + FLT_EPSILON)) {
-                if (a2pa < pa2a) {
-                    float shorten = t * sin(a2pa/2) / cos(a2pa/2);
-                    float a       = (M_PI - a2pa) / 2;
-                    if (shorten > maxshorten) {
-                        line->s0  = pline->s1  = maxshorten;
-                        line->tr0 = pline->tr1 = maxshorten * sin(a) / cos(a);
-                    } else {
-                        line->s0 = pline->s1 = shorten;
-                    }
-                    //vector_display_debugf("ad =  %f, shorten by %f (len=%f), rthickness %f (from %f)", a, line->s0, line->len, line->tr0, t);
-                } else {
-                    float shorten = t * sin(pa2a/2) / cos(pa2a/2);
-                    float a       = (M_PI - pa2a) / 2;
-                    if (shorten > maxshorten) {
-                        line->s0  = pline->s1  = maxshorten;
-                        line->tl0 = pline->tl1 = maxshorten * sin(a) / cos(a);
-                    } else {
-                        line->s0 = pline->s1 = shorten;
-                    }
-                    //vector_display_debugf("ad =  %f, shorten by %f (len=%f), rthickness by %f (from %f)", a, line->s0, line->len, line->tl0, t);
-                }
-            } else {
-                line->has_prev  = 0;
-            }
-        }
+int vector_display_set_transform(vector_display_t *self, double offset_x, double offset_y, double scale) {
+    vector_display_clear(self);
+    self->offset_x = offset_x;
+    self->offset_y = offset_y;
+    self->scale    = scale;
+    return 0;
+}
 
-        if (!line->has_prev) pline->has_next = 0;
-    }
+int vector_display_new(vector_display_t **out_self, double width, double height) {
+    return vector_display_new_with_alloc(out_self, width, height, default_alloc, NULL);
+}
 
-    // compute line geometry
-    for (i = 0; i < nlines; i++) {
-        line_t *line  = &lines[i];
+int vector_display_new_with_alloc(vector_display_t **out_self, double width, double height,
+                                  vector_display_alloc_cb_t cb_alloc, void *ud) {
+    if (cb_alloc == NULL) return -1;
+    vector_display_t *self = (vector_display_t*)cb_alloc(ud, NULL, 0, sizeof(vector_display_t));
+    if (self == NULL) return -1;
+    memset(self, 0, sizeof(vector_display_t));
+    self->cb_alloc = cb_alloc;
+    self->alloc_ud = ud;
+    vector_display_init(self, width, height);
+    self->steps = VECTOR_DISPLAY_DEFAULT_DECAY_STEPS;
+    self->ring_steps = VECTOR_DISPLAY_DEFAULT_DECAY_STEPS;
+    alloc_history(self);
+    *out_self = self;
+    return 0;
+}
 
-        // shorten lines if needed
-        line->x0 = line->x0 + line->s0 * line->cos_a; line->y0 = line->y0 + line->s0 * line->sin_a;
-        line->x1 = line->x1 - line->s1 * line->cos_a; line->y1 = line->y1 - line->s1 * line->sin_a;
+int vector_display_shared_new(vector_display_shared_t **out_shared) {
+    return vector_display_shared_new_with_alloc(out_shared, default_alloc, NULL);
+}
 
-        // compute initial values for left,right,leftcenter,rightcenter points
-        line->xl0 = line->x0 + line->tl0 * line->sin_a; line->yl0 = line->y0 - line->tl0 * line->cos_a;
-        line->xr0 = line->x0 - line->tr0 * line->sin_a; line->yr0 = line->y0 + line->tr0 * line->cos_a;
-        line->xl1 = line->x1 + line->tl1 * line->sin_a; line->yl1 = line->y1 - line->tl1 * line->cos_a;
-        line->xr1 = line->x1 - line->tr1 * line->sin_a; line->yr1 = line->y1 + line->tr1 * line->cos_a;
+int vector_display_shared_new_with_alloc(vector_display_shared_t **out_shared,
+                                         vector_display_alloc_cb_t cb_alloc, void *ud) {
+    if (cb_alloc == NULL) return -1;
+    vector_display_shared_t *shared = (vector_display_shared_t*)cb_alloc(ud, NULL, 0, sizeof(vector_display_shared_t));
+    if (shared == NULL) return -1;
+    memset(shared, 0, sizeof(vector_display_shared_t));
+    shared->cb_alloc = cb_alloc;
+    shared->alloc_ud = ud;
+    shared->refs     = 1;
+    *out_shared = shared;
+    return 0;
+}
 
-        // compute tips
-        line->xlt0 = line->xl0 - t * line->cos_a; line->ylt0 = line->yl0 - t * line->sin_a;
-        line->xrt0 = line->xr0 - t * line->cos_a; line->yrt0 = line->yr0 - t * line->sin_a;
-        line->xlt1 = line->xl1 + t * line->cos_a; line->ylt1 = line->yl1 + t * line->sin_a;
-        line->xrt1 = line->xr1 + t * line->cos_a; line->yrt1 = line->yr1 + t * line->sin_a;
+void vector_display_shared_release(vector_display_shared_t *shared) {
+    if (--shared->refs > 0) return;
+    if (shared->blur_programs != NULL) {
+        shared->cb_alloc(shared->alloc_ud, shared->blur_programs, sizeof(blur_program_t) * shared->cblur_programs, 0);
     }
+    shared->cb_alloc(shared->alloc_ud, shared, sizeof(vector_display_shared_t), 0);
+}
 
-    // draw the lines
-    draw_lines(self, lines, nlines);
-
-    self->pending_npoints = 0;
-
+int vector_display_set_shared(vector_display_t *self, vector_display_shared_t *shared) {
+    if (shared == NULL || self->did_setup || self->owner != NULL) return -1;
+    shared->refs++;
+    if (self->shared != NULL) vector_display_shared_release(self->shared);
+    self->shared = shared;
     return 0;
 }
 
-int vector_display_set_decay_steps(vector_display_t *self, int steps) {
-    if (steps < 0 || steps > VECTOR_DISPLAY_MAX_DECAY_STEPS) return -1;
-    if (self->did_setup) {
-        glDeleteBuffers(self->steps, self->buffers);
-    }
-    free(self->buffers);
-    free(self->buffernpoints);
-    self->step = 0;
-    self->steps = steps;
-    self->buffers = (GLuint*)calloc(sizeof(GLuint), self->steps);
-    self->buffernpoints = (GLuint*)calloc(sizeof(GLuint), self->steps);
-    if (self->did_setup) glGenBuffers(self->steps, self->buffers);
+int vector_display_new_recorder(vector_display_t *self, vector_display_t **out_recorder) {
+    vector_display_t **link;
+    if (self->owner != NULL) return -1;
+    vector_display_t *recorder = (vector_display_t*)vector_display_realloc(self, NULL, 0, sizeof(vector_display_t));
+    memset(recorder, 0, sizeof(vector_display_t));
+    recorder->cb_alloc = self->cb_alloc;
+    recorder->alloc_ud = self->alloc_ud;
+    vector_display_init(recorder, self->width, self->height);
+
+    // recorders have no history of their own, and tessellate like their display
+    recorder->owner             = self;
+    recorder->gpu_lines         = self->gpu_lines;
+    recorder->gpu_lines_pending = self->gpu_lines_pending;
+    recorder->thickness         = self->thickness;
+    recorder->custom_thickness  = self->custom_thickness;
+    recorder->offset_x          = self->offset_x;
+    recorder->offset_y          = self->offset_y;
+    recorder->scale             = self->scale;
+    vector_display_set_color(recorder, self->r, self->g, self->b);
+
+    for (link = &self->recorders; *link != NULL; link = &(*link)->next_recorder);
+    *link = recorder;
+    *out_recorder = recorder;
+    return 0;
+}
 
+//
+// Frame recorders hand frames from the drawing thread to update through three
+// meshes. The drawing thread owns the back one, update owns the front one, and
+// publishing and taking frames swap their own with the middle one. A frame
+// that is published over a fresh middle frame replaces it, so the older one
+// is dropped without ever being drawn.
+//
+#define FRAME_FRESH (4)
+
+int vector_display_new_frame_recorder(vector_display_t *self, vector_display_t **out_recorder) {
+    vector_display_t *recorder;
+    if (vector_display_new_recorder(self, &recorder) != 0) return -1;
+    recorder->frames = (mesh_t*)vector_display_realloc(recorder, NULL, 0, sizeof(mesh_t) * 3);
+    memset(recorder->frames, 0, sizeof(mesh_t) * 3);
+    recorder->frame_back   = 0;
+    recorder->frame_middle = 1;
+    recorder->frame_front  = 2;
+    *out_recorder = recorder;
     return 0;
 }
 
-int vector_display_set_decay(vector_display_t *self, double decay) {
-    if (decay < 0.0f || decay >= 1.0f) return -1;
-    self->decay = decay;
+int vector_display_publish(vector_display_t *self) {
+    if (self->frames == NULL || self->pending_npoints != 0) return -1;
+    self->frames[self->frame_back] = self->mesh;
+    self->frame_back = atomic_swap(&self->frame_middle, self->frame_back | FRAME_FRESH) & ~FRAME_FRESH;
+
+    // draw the next frame into what was the middle one, reusing its memory
+    self->mesh = self->frames[self->frame_back];
+    memset(&self->frames[self->frame_back], 0, sizeof(mesh_t));
+    vector_display_clear(self);
     return 0;
 }
 
-void gen_linetex(vector_display_t *self) {
-    // generate the texture
-    unsigned char texbuf[TEXTURE_SIZE * TEXTURE_SIZE * 4];
-    memset(texbuf, 0xff, sizeof(texbuf));
+//
+// Take the newest published frame of each frame recorder, if there is one.
+//
+static void take_frames(vector_display_t *self) {
+    vector_display_t *recorder;
+    for (recorder = self->recorders; recorder != NULL; recorder = recorder->next_recorder) {
+        if (recorder->frames != NULL && (atomic_get(&recorder->frame_middle) & FRAME_FRESH)) {
+            recorder->frame_front = atomic_swap(&recorder->frame_middle, recorder->frame_front) & ~FRAME_FRESH;
+        }
+    }
+}
+
+//
+// What update draws for a recorder.
+//
+static const mesh_t *recorded_mesh(const vector_display_t *recorder) {
+    return recorder->frames != NULL ? &recorder->frames[recorder->frame_front] : &recorder->mesh;
+}
+
+//
+// Recorders tessellate for their display's size and line mode, so they follow
+// it through setup, teardown and resizing.
+//
+static void sync_recorders(vector_display_t *self) {
+    vector_display_t *recorder;
+    for (recorder = self->recorders; recorder != NULL; recorder = recorder->next_recorder) {
+        recorder->width             = self->width;
+        recorder->height            = self->height;
+        recorder->subpixels         = self->subpixels;
+        recorder->gpu_lines         = self->gpu_lines;
+        recorder->gpu_lines_pending = self->gpu_lines_pending;
+    }
+}
+
+static void teardown_accumulation(vector_display_t *self) {
+    if (self->fb_accum[0] == 0) return;
+    glDeleteFramebuffers(2, self->fb_accum);
+    glDeleteTextures(2, self->fb_accum_texid);
+    self->fb_accum[0]       = self->fb_accum[1]       = 0;
+    self->fb_accum_texid[0] = self->fb_accum_texid[1] = 0;
+}
+
+//
+// Whether the context can render to half float textures, and the formats to
+// make them with: OpenGL 3.0 and OpenGL ES 3.2 can, as can earlier OpenGL ES
+// with EXT_color_buffer_half_float.
+//
+static int half_float_accumulation(GLenum *out_internal, GLenum *out_type) {
+    int major, minor, es;
+    if (!vector_display_gl_version(&major, &minor, &es)) return 0;
+#ifdef GL_HALF_FLOAT_OES
+    // OpenGL ES 2.0 also needs OES_texture_half_float, for half float textures
+    if (es && major < 3) {
+        if (!vector_display_has_extension("GL_EXT_color_buffer_half_float") ||
+            !vector_display_has_extension("GL_OES_texture_half_float")) return 0;
+        *out_internal = GL_RGBA;
+        *out_type     = GL_HALF_FLOAT_OES;
+        return 1;
+    }
+#endif
+#if defined(GL_ES_VERSION_3_0) || defined(GL_VERSION_3_0)
+    if (major >= 3 && (!es || major > 3 || minor >= 2 || vector_display_has_extension("GL_EXT_color_buffer_half_float"))) {
+        *out_internal = GL_RGBA16F;
+        *out_type     = GL_HALF_FLOAT;
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+static int make_accumulation(vector_display_t *self, GLenum internal, GLenum type) {
+    int i;
+    for (i = 0; i < 2; i++) {
+        glGenFramebuffers(1, &self->fb_accum[i]);                                                                   vector_display_check_error("glGenFramebuffers");
+        glGenTextures(1, &self->fb_accum_texid[i]);                                                                 vector_display_check_error("glGenTextures");
+        glBindFramebuffer(GL_FRAMEBUFFER, self->fb_accum[i]);                                                       vector_display_check_error("glBindFramebuffer");
+        glBindTexture(GL_TEXTURE_2D, self->fb_accum_texid[i]);                                                      vector_display_check_error("glBindTexture");
+        glTexImage2D(GL_TEXTURE_2D, 0, internal, self->width, self->height, 0, GL_RGBA, type, NULL);                vector_display_check_error("glTexImage2D");
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);                                          vector_display_check_error("glTexParameteri GL_TEXTURE_MIN_FILTER");
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);                                          vector_display_check_error("glTexParameteri GL_TEXTURE_MAG_FILTER");
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);                                        vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_S");
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);                                        vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_T");
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, self->fb_accum_texid[i], 0);    vector_display_check_error("glFramebufferTexture2D");
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) return -1;
+
+        // nothing has been drawn yet
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    return 0;
+}
+
+//
+// Accumulated frames are kept in half floats where they can be, and in 8 bits
+// otherwise, which only hold a fade of about 255 updates.
+//
+static int setup_accumulation(vector_display_t *self) {
+    GLenum internal, type;
+    self->accum_read = 0;
+    if (half_float_accumulation(&internal, &type)) {
+        if (make_accumulation(self, internal, type) == 0) {
+            self->accum_fade = ACCUM_FADE_HALF;
+            return 0;
+        }
+        teardown_accumulation(self);
+    }
+    self->accum_fade = ACCUM_FADE_RGBA8;
+    return make_accumulation(self, GL_RGBA, GL_UNSIGNED_BYTE);
+}
+
+//
+// Level 0 of the bloom chain is half the size of the scene, and each level
+// after it half the size of the one before.
+//
+static void size_bloom(vector_display_t *self) {
+    int i, w = self->width, h = self->height;
+    for (i = 0; i < self->bloom_levels; i++) {
+        w = max(w / 2, 1);
+        h = max(h / 2, 1);
+        self->bloom_width[i]  = w;
+        self->bloom_height[i] = h;
+    }
+}
+
+static int setup_bloom(vector_display_t *self) {
+    int i, w, h;
+    size_bloom(self);
+    for (i = 0; i < self->bloom_levels; i++) {
+        w = self->bloom_width[i];
+        h = self->bloom_height[i];
+        glGenFramebuffers(1, &self->fb_bloom[i]);                                                                   vector_display_check_error("glGenFramebuffers");
+        glGenTextures(1, &self->fb_bloom_texid[i]);                                                                 vector_display_check_error("glGenTextures");
+        glBindFramebuffer(GL_FRAMEBUFFER, self->fb_bloom[i]);                                                       vector_display_check_error("glBindFramebuffer");
+        glBindTexture(GL_TEXTURE_2D, self->fb_bloom_texid[i]);                                                      vector_display_check_error("glBindTexture");
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);                          vector_display_check_error("glTexImage2D");
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);                                           vector_display_check_error("glTexParameteri GL_TEXTURE_MIN_FILTER");
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);                                           vector_display_check_error("glTexParameteri GL_TEXTURE_MAG_FILTER");
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);                                        vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_S");
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);                                        vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_T");
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, self->fb_bloom_texid[i], 0);    vector_display_check_error("glFramebufferTexture2D");
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) return -1;
+    }
+    return 0;
+}
+
+static void teardown_bloom(vector_display_t *self) {
+    int i;
+    for (i = 0; i < VECTOR_DISPLAY_MAX_BLOOM_LEVELS; i++) {
+        if (self->fb_bloom[i] == 0) continue;
+        glDeleteFramebuffers(1, &self->fb_bloom[i]);
+        glDeleteTextures(1, &self->fb_bloom_texid[i]);
+        self->fb_bloom[i]       = 0;
+        self->fb_bloom_texid[i] = 0;
+    }
+}
+
+int vector_display_setup_res_dependent(vector_display_t *self) {
+    if (!self->did_setup) return 0;
+
+    GLuint origdrawbuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, (GLint*)&origdrawbuffer);
+
+    // set up the framebuffer for the scene
+    glGenFramebuffers(1, &self->fb_scene);                                                                      vector_display_check_error("glGenFramebuffers");
+    glGenTextures(1, &self->fb_scene_texid);                                                                    vector_display_check_error("glGenTextures");
+    glBindFramebuffer(GL_FRAMEBUFFER, self->fb_scene);                                                          vector_display_check_error("glBindFramebuffer");
+    glBindTexture(GL_TEXTURE_2D, self->fb_scene_texid);                                                         vector_display_check_error("glBindTexture");
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, self->width, self->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);     vector_display_check_error("glTexImage2D");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);                                           vector_display_check_error("glTexParameteri GL_TEXTURE_MIN_FILTER");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);                                           vector_display_check_error("glTexParameteri GL_TEXTURE_MAG_FILTER");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);                                        vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_S");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);                                        vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_T");
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, self->fb_scene_texid, 0);       vector_display_check_error("glFramebufferTexture2D");
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) return -1;
+
+    // set up the glow0 framebuffer
+    glGenFramebuffers(1, &self->fb_glow0);                                                                            vector_display_check_error("glGenFramebuffers");
+    glGenTextures(1, &self->fb_glow0_texid);                                                                          vector_display_check_error("glGenTextures");
+    glBindFramebuffer(GL_FRAMEBUFFER, self->fb_glow0);                                                                vector_display_check_error("glBindFramebuffer");
+    glBindTexture(GL_TEXTURE_2D, self->fb_glow0_texid);                                                               vector_display_check_error("glBindTexture");
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, self->glow_width, self->glow_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL); vector_display_check_error("glTexImage2D");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);                                                 vector_display_check_error("glTexParameteri GL_TEXTURE_MIN_FILTER");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);                                                 vector_display_check_error("glTexParameteri GL_TEXTURE_MAG_FILTER");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);                                              vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_S");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);                                              vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_T");
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, self->fb_glow0_texid, 0);             vector_display_check_error("glFramebufferTexture2D");
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) return -1;
+
+    // set up the glow1 framebuffer
+    glGenFramebuffers(1, &self->fb_glow1);                                                                            vector_display_check_error("glGenFramebuffers");
+    glGenTextures(1, &self->fb_glow1_texid);                                                                          vector_display_check_error("glGenTextures");
+    glBindFramebuffer(GL_FRAMEBUFFER, self->fb_glow1);                                                                vector_display_check_error("glBindFramebuffer");
+    glBindTexture(GL_TEXTURE_2D, self->fb_glow1_texid);                                                               vector_display_check_error("glBindTexture");
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, self->glow_width, self->glow_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL); vector_display_check_error("glTexImage2D");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);                                                 vector_display_check_error("glTexParameteri GL_TEXTURE_MIN_FILTER");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);                                                 vector_display_check_error("glTexParameteri GL_TEXTURE_MAG_FILTER");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);                                              vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_S");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);                                              vector_display_check_error("glTexParameteri GL_TEXTURE_WRAP_T");
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, self->fb_glow1_texid, 0);             vector_display_check_error("glFramebufferTexture2D");
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) return -1;
+
+    // set up the framebuffers for accumulated frames
+    if (self->accumulate && setup_accumulation(self) < 0) return -1;
+
+    // set up the bloom chain
+    if (setup_bloom(self) < 0) return -1;
+
+    // put back old framebuffer
+    glBindFramebuffer(GL_FRAMEBUFFER, origdrawbuffer);
+
+    return 0;
+}
+
+int vector_display_teardown_res_dependent(vector_display_t *self) {
+    if (!self->did_setup) return 0;
+
+    glDeleteFramebuffers(1, &self->fb_scene);
+    glDeleteTextures(1, &self->fb_scene_texid);
+
+    glDeleteFramebuffers(1, &self->fb_glow0);
+    glDeleteTextures(1, &self->fb_glow0_texid);
+
+    glDeleteFramebuffers(1, &self->fb_glow1);
+    glDeleteTextures(1, &self->fb_glow1_texid);
+
+    teardown_accumulation(self);
+    teardown_bloom(self);
+
+    return 0;
+}
+
+int vector_display_resize(vector_display_t *self, double width, double height) {
+    if (self->owner != NULL) return -1;
+    vector_display_teardown_res_dependent(self);
+    self->width = width;
+    self->height = height;
+    self->glow_width = width   / 3.0;
+    self->glow_height = height / 3.0;
+    size_positions(self);
+    sync_recorders(self);
+    vector_display_setup_res_dependent(self);
+    vector_display_clear(self);
+    return 0;
+}
+
+int vector_display_set_initial_decay(vector_display_t *self, double initial_decay) {
+    if (initial_decay < 0.0f || initial_decay >= 1.0f) return -1;
+    self->initial_decay = initial_decay;
+    return 0;
+}
+
+int vector_display_set_thickness(vector_display_t *self, double thickness) {
+    if (thickness <= 0) return -1;
+    self->custom_thickness = 1;
+    self->thickness = thickness;
+    return 0;
+}
+
+int vector_display_set_default_thickness(vector_display_t *self) {
+    self->custom_thickness = 0;
+    return 0;
+}
+
+int vector_display_clear(vector_display_t *self) {
+    self->mesh.subpixels = self->subpixels;
+    self->mesh.both_lines = 0;
+    self->mesh.npoints  = 0;
+    self->mesh.nindices = 0;
+    self->mesh.nbatches = 0;
+    self->mesh.nsegments = 0;
+    release_list_draws(self->list_draws, self->nlist_draws);
+    self->nlist_draws = 0;
+    return 0;
+}
+
+int vector_display_list_new(vector_display_t *self, vector_display_list_t **out_list) {
+    if (self->owner != NULL) return -1;
+    vector_display_list_t *list = self->free_lists;
+    if (list != NULL) {
+        // keep the mesh arrays and buffers of a collected list
+        self->free_lists     = list->next;
+        list->mesh.both_lines = 0;
+        list->mesh.npoints   = 0;
+        list->mesh.nindices  = 0;
+        list->mesh.nbatches  = 0;
+        list->mesh.nsegments = 0;
+        list->uploaded       = 0;
+        memset(list->bounds, 0, sizeof(list->bounds));
+    } else {
+        list = (vector_display_list_t*)vector_display_realloc(self, NULL, 0, sizeof(vector_display_list_t));
+        if (list == NULL) return -1;
+        memset(list, 0, sizeof(vector_display_list_t));
+    }
+    list->mesh.subpixels = self->subpixels;
+    list->display = self;
+    list->refs    = 1;
+    list->next    = self->lists;
+    self->lists   = list;
+    *out_list = list;
+    return 0;
+}
+
+void vector_display_list_delete(vector_display_list_t *list) {
+    vector_display_t *self = list->display;
+    if (self->recording == list) {
+        self->recording       = NULL;
+        self->target          = &self->mesh;
+        self->pending_npoints = 0;
+    }
+    list->refs--;
+}
+
+static void delete_list_buffers(vector_display_list_t *list) {
+    if (list->vertexbuffer)  glDeleteBuffers(1, &list->vertexbuffer);
+    if (list->indexbuffer)   glDeleteBuffers(1, &list->indexbuffer);
+    if (list->segmentbuffer) glDeleteBuffers(1, &list->segmentbuffer);
+    list->vertexbuffer = list->indexbuffer = list->segmentbuffer = 0;
+    list->uploaded     = 0;
+    delete_vertex_arrays(&list->arrays);
+}
+
+static void free_list(vector_display_t *self, vector_display_list_t *list) {
+    delete_list_buffers(list);
+    free_mesh(self, &list->mesh);
+    vector_display_free(self, list, sizeof(vector_display_list_t));
+}
+
+static void free_lists(vector_display_t *self, vector_display_list_t *lists) {
+    while (lists != NULL) {
+        vector_display_list_t *list = lists;
+        lists = list->next;
+        free_list(self, list);
+    }
+}
+
+//
+// Move the lists nobody refers to any more to the free lists. Lists are
+// created and deleted as often as every frame, for example when a changing
+// line of text is recorded again, so they are reused rather than freed.
+//
+static void collect_lists(vector_display_t *self) {
+    vector_display_list_t **link = &self->lists, *list;
+    while ((list = *link) != NULL) {
+        if (list->refs == 0) {
+            *link = list->next;
+            list->next = self->free_lists;
+            self->free_lists = list;
+        } else {
+            link = &list->next;
+        }
+    }
+}
+
+static void include_position(int *bounds, int x, int y) {
+    if (x < bounds[0]) bounds[0] = x;
+    if (y < bounds[1]) bounds[1] = y;
+    if (x > bounds[2]) bounds[2] = x;
+    if (y > bounds[3]) bounds[3] = y;
+}
+
+static void mesh_bounds(const mesh_t *mesh, int *bounds) {
+    int i;
+    bounds[0] = bounds[1] = bounds[2] = bounds[3] = 0;
+    for (i = 0; i < mesh->npoints; i++) {
+        include_position(bounds, mesh->points[i].x, mesh->points[i].y);
+    }
+    for (i = 0; i < mesh->nsegments; i++) {
+        const segment_t *seg = &mesh->segments[i];
+        include_position(bounds, seg->xp, seg->yp);
+        include_position(bounds, seg->x0, seg->y0);
+        include_position(bounds, seg->x1, seg->y1);
+        include_position(bounds, seg->xn, seg->yn);
+    }
+}
+
+int vector_display_begin_list(vector_display_t *self, vector_display_list_t *list) {
+    if (self->recording != NULL || self->pending_npoints != 0 || list->display != self) return -1;
+    list->mesh.subpixels = self->subpixels;
+    list->mesh.both_lines = 0;
+    list->mesh.npoints   = 0;
+    list->mesh.nindices  = 0;
+    list->mesh.nbatches  = 0;
+    list->mesh.nsegments = 0;
+    list->uploaded       = 0;
+    self->recording = list;
+    self->target    = &list->mesh;
+    return 0;
+}
+
+int vector_display_end_list(vector_display_t *self) {
+    if (self->recording == NULL || self->pending_npoints != 0) return -1;
+    mesh_bounds(&self->recording->mesh, self->recording->bounds);
+    self->recording->uploaded = 0;
+    self->recording = NULL;
+    self->target    = &self->mesh;
+    return 0;
+}
+
+int vector_display_draw_list(vector_display_t *self, vector_display_list_t *list, double offset_x, double offset_y, double scale) {
+    if (self->recording != NULL || list->display != self) return -1;
+    grow_array(self, (void**)&self->list_draws, &self->clist_draws, self->nlist_draws + 1, sizeof(list_draw_t));
+    list_draw_t *draw = &self->list_draws[self->nlist_draws++];
+    draw->list     = list;
+    draw->offset_x = offset_x;
+    draw->offset_y = offset_y;
+    draw->scale    = scale;
+    list->refs++;
+    return 0;
+}
+
+int vector_display_set_color(vector_display_t *self, double r, double g, double b) {
+    self->r = r;
+    self->g = g;
+    self->b = b;
+    pack_color(self);
+    return 0;
+}
+
+//
+// Make sure the current batch can take npoints more points, starting a new
+// batch if it can't. Indices handed out by append_texpoint are only valid
+// until the next call.
+//
+static void reserve_batch(vector_display_t *self, mesh_t *mesh, int npoints) {
+    batch_t *batch = mesh->nbatches ? &mesh->batches[mesh->nbatches - 1] : NULL;
+    if (batch == NULL || batch->npoints + npoints > MAX_BATCH_POINTS) {
+        ensure_batches(self, mesh, mesh->nbatches + 1);
+        batch = &mesh->batches[mesh->nbatches++];
+        batch->first_point = mesh->npoints;
+        batch->first_index = mesh->nindices;
+        batch->npoints     = 0;
+        batch->nindices    = 0;
+    }
+}
+
+static GLushort append_texpoint(vector_display_t *self, double x, double y, double u, double v) {
+    mesh_t  *mesh  = self->target;
+    batch_t *batch = &mesh->batches[mesh->nbatches - 1];
+    ensure_points(self, mesh, mesh->npoints + 1);
+
+    point_t *point = &mesh->points[mesh->npoints];
+    point->x = pack_position(x, mesh->subpixels);
+    point->y = pack_position(y, mesh->subpixels);
+    point->r = self->color[0];
+    point->g = self->color[1];
+    point->b = self->color[2];
+    point->a = self->color[3];
+    point->u = pack_unorm16(u / TEXTURE_SIZE);
+    point->v = pack_unorm16(1.0 - v / TEXTURE_SIZE);
+    mesh->npoints++;
+    return (GLushort)(batch->npoints++);
+}
+
+static void append_triangle(vector_display_t *self, GLushort i0, GLushort i1, GLushort i2) {
+    mesh_t  *mesh  = self->target;
+    batch_t *batch = &mesh->batches[mesh->nbatches - 1];
+    ensure_indices(self, mesh, mesh->nindices + 3);
+
+    mesh->indices[mesh->nindices++] = i0;
+    mesh->indices[mesh->nindices++] = i1;
+    mesh->indices[mesh->nindices++] = i2;
+    batch->nindices += 3;
+}
+
+//
+// Whether the triangles of a mesh are drawn. Until it is known whether the
+// GPU will expand lines, they go in both ways, and once it does, only the
+// segments of such meshes are drawn.
+//
+static int draws_triangles(const vector_display_t *self, const mesh_t *mesh) {
+    return !(mesh->both_lines && self->gpu_lines && !self->gpu_lines_pending);
+}
+
+static GLshort offset_position(int v, int offset) {
+    int moved = v + offset;
+    if (moved < -32767) moved = -32767;
+    if (moved >  32767) moved =  32767;
+    return (GLshort)moved;
+}
+
+int vector_display_append_list(vector_display_t *self, vector_display_list_t *list, double offset_x, double offset_y) {
+    mesh_t *src  = &list->mesh, *dst = self->target;
+    int     from = src->subpixels, to = dst->subpixels;
+    int     dx   = (int)lrint(offset_x * to);
+    int     dy   = (int)lrint(offset_y * to);
+    int     nbatches  = draws_triangles(self, src) ? src->nbatches : 0;
+    int     nsegments = !src->both_lines || self->gpu_lines ? src->nsegments : 0;
+    int     b, i;
+
+    if (self->pending_npoints != 0 || src == dst) return -1;
+    if (src->both_lines && self->gpu_lines_pending) dst->both_lines = 1;
+
+    // nothing to clamp if the whole list stays in range, which is the usual
+    // case, unless the display has been resized since it was recorded
+    int exact = from == to &&
+                list->bounds[0] + dx >= -32767 && list->bounds[2] + dx <= 32767 &&
+                list->bounds[1] + dy >= -32767 && list->bounds[3] + dy <= 32767;
+
+    // a batch always fits in an empty batch, so each one is copied whole
+    for (b = 0; b < nbatches; b++) {
+        const batch_t *sbatch = &src->batches[b];
+        reserve_batch(self, dst, sbatch->npoints);
+        ensure_points(self, dst, dst->npoints + sbatch->npoints);
+        ensure_indices(self, dst, dst->nindices + sbatch->nindices);
+
+        batch_t        *dbatch = &dst->batches[dst->nbatches - 1];
+        const point_t  *sp     = &src->points[sbatch->first_point];
+        point_t        *dp     = &dst->points[dst->npoints];
+        const GLushort *si     = &src->indices[sbatch->first_index];
+        GLushort       *di     = &dst->indices[dst->nindices];
+        GLushort        base   = (GLushort)dbatch->npoints;
+
+        if (exact) {
+            for (i = 0; i < sbatch->npoints; i++) {
+                dp[i]   = sp[i];
+                dp[i].x = (GLshort)(sp[i].x + dx);
+                dp[i].y = (GLshort)(sp[i].y + dy);
+            }
+        } else {
+            for (i = 0; i < sbatch->npoints; i++) {
+                dp[i]   = sp[i];
+                dp[i].x = offset_position(rescale_position(sp[i].x, from, to), dx);
+                dp[i].y = offset_position(rescale_position(sp[i].y, from, to), dy);
+            }
+        }
+        for (i = 0; i < sbatch->nindices; i++) {
+            di[i] = si[i] + base;
+        }
+
+        dst->npoints     += sbatch->npoints;
+        dst->nindices    += sbatch->nindices;
+        dbatch->npoints  += sbatch->npoints;
+        dbatch->nindices += sbatch->nindices;
+    }
+
+    ensure_segments(self, dst, dst->nsegments + nsegments);
+    for (i = 0; i < nsegments; i++) {
+        const segment_t *ss = &src->segments[i];
+        segment_t       *ds = &dst->segments[dst->nsegments + i];
+        *ds    = *ss;
+        ds->xp = offset_position(rescale_position(ss->xp, from, to), dx);
+        ds->yp = offset_position(rescale_position(ss->yp, from, to), dy);
+        ds->x0 = offset_position(rescale_position(ss->x0, from, to), dx);
+        ds->y0 = offset_position(rescale_position(ss->y0, from, to), dy);
+        ds->x1 = offset_position(rescale_position(ss->x1, from, to), dx);
+        ds->y1 = offset_position(rescale_position(ss->y1, from, to), dy);
+        ds->xn = offset_position(rescale_position(ss->xn, from, to), dx);
+        ds->yn = offset_position(rescale_position(ss->yn, from, to), dy);
+        ds->thickness = (GLushort)min(rescale_position(ss->thickness, from, to), 0xffff);
+    }
+    dst->nsegments += nsegments;
+
+    return 0;
+}
+
+int vector_display_begin_draw(vector_display_t *self, double x, double y) {
+    if (self->pending_npoints != 0) {
+        vector_display_debugf("assertion failure");
+        abort();
+    }
+    ensure_pending_points(self, self->pending_npoints + 1);
+    self->pending_points[self->pending_npoints].x = x * self->scale + self->offset_x;
+    self->pending_points[self->pending_npoints].y = y * self->scale + self->offset_y;
+    self->pending_npoints++;
+    return 0;
+}
+
+int vector_display_draw_to(vector_display_t *self, double x, double y) {
+    ensure_pending_points(self, self->pending_npoints + 1);
+    self->pending_points[self->pending_npoints].x = x * self->scale + self->offset_x;
+    self->pending_points[self->pending_npoints].y = y * self->scale + self->offset_y;
+    self->pending_npoints++;
+    return 0;
+}
+
+typedef struct {
+    float x0, y0, x1, y1;                      // nominal points
+    float sin_a, cos_a;                        // unit direction, a is the angle from the positive x axis
+
+    float xl0, yl0, xl1, yl1;                  // left side of the box
+    float xr0, yr0, xr1, yr1;                  // right side of the box
+
+    int is_first, is_last;
+    int has_next, has_prev;                     // booleans indicating whether this line connects to prev/next
+
+    float xlt0, ylt0, xlt1, ylt1;              // coordinates of endcaps (if !has_prev/!has_next)
+    float xrt0, yrt0, xrt1, yrt1;              // coordinates of endcaps (if !has_prev/!has_next)
+
+    float tl0, tl1, tr0, tr1;
+
+    float s0, s1;                              // shorten line by this amount
+
+    float len;
+} line_t;
+
+//
+// Most points a single line can add: 4 for the body, 2 for each endcap and
+// up to 5 for the rim of a join fan (joins turn at most 90 degrees, in steps
+// of 22.5 degrees).
+//
+#define MAX_POINTS_PER_LINE (16)
+
+//
+// A join turns by at most 90 degrees and its fan has one step per 22.5
+// degrees, rounded, so nsteps is 1 to 4. These are the cosines of the turns
+// where nsteps goes up: 1.5, 2.5 and 3.5 times 22.5 degrees.
+//
+static const float fan_step_cos[] = { 0.83146961f, 0.55557023f, 0.19509032f };
+
+//
+// Draw the fan for a join. (nx, ny) is the unit vector from the center to the
+// first rim point, and the rim sweeps counterclockwise through the turn
+// (dot, cross) = (cos, sin) of the turn angle.
+//
+static void draw_fan(vector_display_t *self, GLushort center, float cx, float cy, float nx, float ny, float dot, float cross, float t, float e) {
+    int   i, nsteps = 1;
+    float c, s;                                // cos, sin of one step
+
+    while (nsteps <= 3 && dot < fan_step_cos[nsteps - 1]) nsteps++;
+
+    // split the turn into nsteps equal steps without going through angles
+    c = dot; s = fabsf(cross);
+    if (nsteps == 3) {
+        // solve cos(3x) = 4c^3 - 3c = dot, starting from the small angle estimate
+        float x = 1.0f - (1.0f - dot) / 9.0f;
+        for (i = 0; i < 3; i++) x -= (4 * x * x * x - 3 * x - dot) / (12 * x * x - 3);
+        c = x; s = sqrtf(max(0.0f, 1.0f - x * x));
+    } else {
+        for (i = 1; i < nsteps; i *= 2) {       // half angle, once for 2 steps and twice for 4
+            float hc = sqrtf(max(0.0f, (1.0f + c) / 2.0f));
+            s = hc > 0 ? s / (2.0f * hc) : 1.0f;
+            c = hc;
+        }
+    }
+
+#if DEBUG_TRIANGLES
+    self->a = 0.5; pack_color(self);
+    center = append_texpoint(self, cx, cy, HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
+    e = HALF_TEXTURE_SIZE;
+#endif
+
+    // the center point belongs to the line body, so only the rim is new
+    GLushort rim, prevrim = append_texpoint(self, cx + t * nx, cy + t * ny, e, HALF_TEXTURE_SIZE);
+    for (i = 1; i <= nsteps; i++) {
+        float rx = nx * c - ny * s;
+        float ry = nx * s + ny * c;
+        nx = rx; ny = ry;
+        rim = append_texpoint(self, cx + t * nx, cy + t * ny, e, HALF_TEXTURE_SIZE);
+        append_triangle(self, prevrim, center, rim);
+        prevrim = rim;
+    }
+
+#if DEBUG_TRIANGLES
+    self->a = 1.0; pack_color(self);
+#endif
+}
+
+static void draw_lines(vector_display_t *self, line_t *lines, int nlines) {
+    int    i;
+    float t = effective_thickness(self);
+
+    for (i = 0; i < nlines; i++) {
+        line_t *line  = &lines[i], *pline = &lines[(nlines+i-1)%nlines];
+
+        // lines don't share points with each other, so any line may start a new batch
+        reserve_batch(self, self->target, MAX_POINTS_PER_LINE);
+
+        float tl0 = HALF_TEXTURE_SIZE - (line->tl0 / t) * HALF_TEXTURE_SIZE;
+        float tl1 = HALF_TEXTURE_SIZE - (line->tl1 / t) * HALF_TEXTURE_SIZE;
+
+        float tr0 = HALF_TEXTURE_SIZE + (line->tr0 / t) * HALF_TEXTURE_SIZE;
+        float tr1 = HALF_TEXTURE_SIZE + (line->tr1 / t) * HALF_TEXTURE_SIZE;
+
+        GLushort l0, l1, r0, r1;
+#if DEBUG_TRIANGLES
+        self->a = 0.5;
+        self->r = 1.0; self->g = 0.8; self->b = 0.8;
+        pack_color(self);
+        r0 = append_texpoint(self, line->xr0,  line->yr0,  HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
+        r1 = append_texpoint(self, line->xr1,  line->yr1,  HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
+        l1 = append_texpoint(self, line->xl1,  line->yl1,  HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
+        l0 = append_texpoint(self, line->xl0,  line->yl0,  HALF_TEXTURE_SIZE, HALF_TEXTURE_SIZE);
+        self->r = 1.0; self->g = 1.0; self->b = 1.0;
+        self->a = 1.0;
+        pack_color(self);
+#else
+        r0 = append_texpoint(self, line->xr0,  line->yr0,  tr0, HALF_TEXTURE_SIZE);
+        r1 = append_texpoint(self, line->xr1,  line->yr1,  tr1, HALF_TEXTURE_SIZE);
+        l1 = append_texpoint(self, line->xl1,  line->yl1,  tl1, HALF_TEXTURE_SIZE);
+        l0 = append_texpoint(self, line->xl0,  line->yl0,  tl0, HALF_TEXTURE_SIZE);
+#endif
+        append_triangle(self, r0, r1, l1);
+        append_triangle(self, l0, r0, l1);
+
+        if (line->has_prev) {   // draw fan for connection to previous
+            float dot   = pline->cos_a * line->cos_a + pline->sin_a * line->sin_a;
+            float cross = pline->cos_a * line->sin_a - pline->sin_a * line->cos_a;
+            if (cross > 0) {    // inside of fan on right, rim sweeps from the previous line's left side to ours
+                draw_fan(self, r0, line->xr0, line->yr0,  pline->sin_a, -pline->cos_a, dot, cross, line->tl0 + line->tr0, 0);
+            } else {            // inside of fan on left, rim sweeps from our right side to the previous line's
+                draw_fan(self, l0, line->xl0, line->yl0, -line->sin_a,   line->cos_a,  dot, cross, line->tl0 + line->tr0, TEXTURE_SIZE);
+            }
+        }
+
+        if (!line->has_prev) { // draw startcap
+            GLushort lt0 = append_texpoint(self, line->xlt0, line->ylt0, tl0, 0.0f);
+            GLushort rt0 = append_texpoint(self, line->xrt0, line->yrt0, tr0, 0.0f);
+            append_triangle(self, l0, lt0, r0);
+            append_triangle(self, r0, lt0, rt0);
+        }
+
+        if (!line->has_next) { // draw endcap
+            GLushort lt1 = append_texpoint(self, line->xlt1, line->ylt1, tl1, 0.0f);
+            GLushort rt1 = append_texpoint(self, line->xrt1, line->yrt1, tr1, 0.0f);
+            append_triangle(self, lt1, l1, r1);
+            append_triangle(self, lt1, r1, rt1);
+        }
+    }
+}
+
+#if !(VF_WIDTH > 1) || CHECK_SIMD_TESSELLATION
+//
+// Reference implementation: build the list of lines for the pending points one
+// line at a time. compute_lines_simd must produce the same output.
+//
+static void compute_lines(line_t *lines, const pending_point_t *points, int nlines, int first_last_same, float t) {
+    int i;
+
+    // compute basics
+    for (i = 1; i <= nlines; i++) {
+        line_t *line = &lines[i-1];
+        line->is_first = i == 1;
+        line->is_last  = i == nlines;
+
+        // precomputed info for current line
+        line->x0    = points[i-1].x;
+        line->y0    = points[i-1].y;
+        line->x1    = points[i].x;
+        line->y1    = points[i].y;
+        line->len   = sqrtf((line->x1-line->x0) * (line->x1-line->x0) + (line->y1-line->y0) * (line->y1-line->y0));
+        if (line->len > 0) {
+            line->cos_a = (line->x1 - line->x0) / line->len;
+            line->sin_a = (line->y1 - line->y0) / line->len;
+        } else {                                // same direction atan2(0, 0) gives
+            line->cos_a = 1;
+            line->sin_a = 0;
+        }
+
+        // figure out what connections we have
+        line->has_prev = (!line->is_first || (line->is_first && first_last_same));
+        line->has_next = (!line->is_last  || (line->is_last  && first_last_same));
+
+        // initialize thicknesses/shortens to default values
+        line->tl0 = line->tl1 = line->tr0 = line->tr1 = t;
+        line->s0 = line->s1 = 0.0;
+    }
+
+    // compute adjustments for connected line segments
+    for (i = 0; i < nlines; i++) {
+        line_t *line  = &lines[i], *pline = &lines[(nlines+i-1)%nlines];
+
+        if (line->has_prev) {
+            // cos and sin of the turn from the previous line to this one
+            float dot        = pline->cos_a * line->cos_a + pline->sin_a * line->sin_a;
+            float cross      = pline->cos_a * line->sin_a - pline->sin_a * line->cos_a;
+            float maxshorten = min(line->len, pline->len) / 2.0;
+
+            if (dot >= -FLT_EPSILON) {          // turns by at most 90 degrees
+                float shorten = t * fabsf(cross) / (1 + dot);                     // t * tan(turn/2)
+                if (cross > 0) {
+                    if (shorten > maxshorten) {
+                        line->s0  = pline->s1  = maxshorten;
+                        line->tr0 = pline->tr1 = maxshorten * (1 + dot) / cross;  // maxshorten * tan((pi - turn)/2)
+                    } else {
+                        line->s0 = pline->s1 = shorten;
+                    }
+                    //vector_display_debugf("shorten by %f (len=%f), rthickness %f (from %f)", line->s0, line->len, line->tr0, t);
+                } else {
+                    if (shorten > maxshorten) {
+                        line->s0  = pline->s1  = maxshorten;
+                        line->tl0 = pline->tl1 = maxshorten * (1 + dot) / -cross;
+                    } else {
+                        line->s0 = pline->s1 = shorten;
+                    }
+                    //vector_display_debugf("shorten by %f (len=%f), lthickness by %f (from %f)", line->s0, line->len, line->tl0, t);
+                }
+            } else {
+                line->has_prev  = 0;
+            }
+        }
+
+        if (!line->has_prev) pline->has_next = 0;
+    }
+
+    // compute line geometry
+    for (i = 0; i < nlines; i++) {
+        line_t *line  = &lines[i];
+
+        // shorten lines if needed
+        line->x0 = line->x0 + line->s0 * line->cos_a; line->y0 = line->y0 + line->s0 * line->sin_a;
+        line->x1 = line->x1 - line->s1 * line->cos_a; line->y1 = line->y1 - line->s1 * line->sin_a;
+
+        // compute initial values for left,right,leftcenter,rightcenter points
+        line->xl0 = line->x0 + line->tl0 * line->sin_a; line->yl0 = line->y0 - line->tl0 * line->cos_a;
+        line->xr0 = line->x0 - line->tr0 * line->sin_a; line->yr0 = line->y0 + line->tr0 * line->cos_a;
+        line->xl1 = line->x1 + line->tl1 * line->sin_a; line->yl1 = line->y1 - line->tl1 * line->cos_a;
+        line->xr1 = line->x1 - line->tr1 * line->sin_a; line->yr1 = line->y1 + line->tr1 * line->cos_a;
+
+        // compute tips
+        line->xlt0 = line->xl0 - t * line->cos_a; line->ylt0 = line->yl0 - t * line->sin_a;
+        line->xrt0 = line->xr0 - t * line->cos_a; line->yrt0 = line->yr0 - t * line->sin_a;
+        line->xlt1 = line->xl1 + t * line->cos_a; line->ylt1 = line->yl1 + t * line->sin_a;
+        line->xrt1 = line->xr1 + t * line->cos_a; line->yrt1 = line->yr1 + t * line->sin_a;
+    }
+}
+#endif
+
+#if VF_WIDTH > 1
+//
+// Structure-of-arrays version of compute_lines, VF_WIDTH lines at a time.
+//
+// Lines are unit directions (c, s) = (cos_a, sin_a). As in compute_lines, the
+// join between a line and the previous one uses dot = cos(turn) and
+// cross = sin(turn):
+//
+//     turn <= 90 degrees          <=>  dot >= 0
+//     inside of the fan on right  <=>  cross > 0
+//     tan(turn / 2)               ==   |cross| / (1 + dot)
+//
+// Every array has one slot of padding on each side. Slot -1 holds a copy of
+// the last line (so index i-1 is the previous line, wrapping) and slot nlines
+// holds a copy of the first (so index i+1 is the next line, wrapping).
+//
+static void compute_lines_simd(vector_display_t *self, line_t *lines, const pending_point_t *points, int nlines, int first_last_same, float t) {
+    int    i, j;
+    int    stride = (nlines + VF_WIDTH - 1) / VF_WIDTH * VF_WIDTH + 2;
+    float *buf    = (float*)scratch_alloc(self, sizeof(float) * stride * 11);
+    float *x0  = buf + 1,   *y0  = x0 + stride, *x1 = y0 + stride, *y1 = x1 + stride;
+    float *c   = y1 + stride, *s = c + stride,  *len = s + stride;
+    float *js  = len + stride;                                  // shortening at the join with the previous line
+    float *jtl = js + stride, *jtr = jtl + stride;              // left/right thickness at the join
+    float *jok = jtr + stride;                                  // 1 if the join is drawn, else 0
+
+    memset(buf, 0, sizeof(float) * stride * 11);
+    for (i = 0; i < nlines; i++) {
+        x0[i] = points[i].x;   y0[i] = points[i].y;
+        x1[i] = points[i+1].x; y1[i] = points[i+1].y;
+    }
+
+    vf_t vt    = vf_set1(t);
+    vf_t zero  = vf_set1(0.0f);
+    vf_t one   = vf_set1(1.0f);
+    vf_t half  = vf_set1(0.5f);
+
+    // directions and lengths. a zero length line points along +x, like atan2(0, 0)
+    for (i = 0; i < nlines; i += VF_WIDTH) {
+        vf_t dx  = vf_sub(vf_load(x1 + i), vf_load(x0 + i));
+        vf_t dy  = vf_sub(vf_load(y1 + i), vf_load(y0 + i));
+        vf_t l   = vf_sqrt(vf_add(vf_mul(dx, dx), vf_mul(dy, dy)));
+        vf_t pos = vf_gt(l, zero);
+        vf_store(c + i,   vf_select(pos, vf_div(dx, l), one));
+        vf_store(s + i,   vf_select(pos, vf_div(dy, l), zero));
+        vf_store(len + i, l);
+    }
+    c[-1] = c[nlines-1]; s[-1] = s[nlines-1]; len[-1] = len[nlines-1];
+
+    // joins with the previous line
+    for (i = 0; i < nlines; i += VF_WIDTH) {
+        vf_t lc = vf_load(c + i),     ls = vf_load(s + i);
+        vf_t pc = vf_load(c + i - 1), ps = vf_load(s + i - 1);
+        vf_t dot   = vf_add(vf_mul(pc, lc), vf_mul(ps, ls));
+        vf_t cross = vf_sub(vf_mul(pc, ls), vf_mul(ps, lc));
+        vf_t acr   = vf_abs(cross);
+        vf_t ok    = vf_ge(dot, vf_set1(-FLT_EPSILON));
+        vf_t right = vf_gt(cross, zero);
+
+        vf_t maxshorten = vf_mul(vf_min(vf_load(len + i), vf_load(len + i - 1)), half);
+        vf_t shorten    = vf_div(vf_mul(vt, acr), vf_add(one, dot));
+        vf_t clamp      = vf_gt(shorten, maxshorten);
+        vf_t thick      = vf_select(clamp, vf_div(vf_mul(maxshorten, vf_add(one, dot)), acr), vt);
+
+        vf_store(js  + i, vf_select(ok, vf_select(clamp, maxshorten, shorten), zero));
+        vf_store(jtr + i, vf_select(vf_and(ok, right), thick, vt));
+        vf_store(jtl + i, vf_select(ok, vf_select(right, vt, thick), vt));
+        vf_store(jok + i, vf_select(ok, one, zero));
+    }
+    if (!first_last_same) {
+        js[0] = 0; jtl[0] = jtr[0] = t; jok[0] = 0;
+    }
+    js[nlines] = js[0]; jtl[nlines] = jtl[0]; jtr[nlines] = jtr[0]; jok[nlines] = jok[0];
+
+    // line geometry
+    for (i = 0; i < nlines; i += VF_WIDTH) {
+        vf_t lc  = vf_load(c + i),       ls  = vf_load(s + i);
+        vf_t s0  = vf_load(js + i),      s1  = vf_load(js + i + 1);
+        vf_t tl0 = vf_load(jtl + i),     tl1 = vf_load(jtl + i + 1);
+        vf_t tr0 = vf_load(jtr + i),     tr1 = vf_load(jtr + i + 1);
+        vf_t tc  = vf_mul(vt, lc),       ts  = vf_mul(vt, ls);
+
+        vf_t sx0 = vf_add(vf_load(x0 + i), vf_mul(s0, lc)), sy0 = vf_add(vf_load(y0 + i), vf_mul(s0, ls));
+        vf_t sx1 = vf_sub(vf_load(x1 + i), vf_mul(s1, lc)), sy1 = vf_sub(vf_load(y1 + i), vf_mul(s1, ls));
+
+        vf_t xl0 = vf_add(sx0, vf_mul(tl0, ls)), yl0 = vf_sub(sy0, vf_mul(tl0, lc));
+        vf_t xr0 = vf_sub(sx0, vf_mul(tr0, ls)), yr0 = vf_add(sy0, vf_mul(tr0, lc));
+        vf_t xl1 = vf_add(sx1, vf_mul(tl1, ls)), yl1 = vf_sub(sy1, vf_mul(tl1, lc));
+        vf_t xr1 = vf_sub(sx1, vf_mul(tr1, ls)), yr1 = vf_add(sy1, vf_mul(tr1, lc));
+
+        float o[26][VF_WIDTH];
+        vf_store(o[0],  sx0); vf_store(o[1],  sy0); vf_store(o[2],  sx1); vf_store(o[3],  sy1);
+        vf_store(o[4],  xl0); vf_store(o[5],  yl0); vf_store(o[6],  xr0); vf_store(o[7],  yr0);
+        vf_store(o[8],  xl1); vf_store(o[9],  yl1); vf_store(o[10], xr1); vf_store(o[11], yr1);
+        vf_store(o[12], vf_sub(xl0, tc)); vf_store(o[13], vf_sub(yl0, ts));
+        vf_store(o[14], vf_sub(xr0, tc)); vf_store(o[15], vf_sub(yr0, ts));
+        vf_store(o[16], vf_add(xl1, tc)); vf_store(o[17], vf_add(yl1, ts));
+        vf_store(o[18], vf_add(xr1, tc)); vf_store(o[19], vf_add(yr1, ts));
+        vf_store(o[20], tl0); vf_store(o[21], tl1); vf_store(o[22], tr0); vf_store(o[23], tr1);
+        vf_store(o[24], s0);  vf_store(o[25], s1);
+
+        for (j = 0; j < VF_WIDTH && i + j < nlines; j++) {
+            line_t *line = &lines[i + j];
+            line->is_first = i + j == 0;
+            line->is_last  = i + j == nlines - 1;
+            line->has_prev = jok[i + j]     != 0.0f;
+            line->has_next = jok[i + j + 1] != 0.0f;
+            line->cos_a = c[i + j];
+            line->sin_a = s[i + j];
+            line->len   = len[i + j];
+            line->x0   = o[0][j];  line->y0   = o[1][j];  line->x1   = o[2][j];  line->y1   = o[3][j];
+            line->xl0  = o[4][j];  line->yl0  = o[5][j];  line->xr0  = o[6][j];  line->yr0  = o[7][j];
+            line->xl1  = o[8][j];  line->yl1  = o[9][j];  line->xr1  = o[10][j]; line->yr1  = o[11][j];
+            line->xlt0 = o[12][j]; line->ylt0 = o[13][j]; line->xrt0 = o[14][j]; line->yrt0 = o[15][j];
+            line->xlt1 = o[16][j]; line->ylt1 = o[17][j]; line->xrt1 = o[18][j]; line->yrt1 = o[19][j];
+            line->tl0  = o[20][j]; line->tl1  = o[21][j]; line->tr0  = o[22][j]; line->tr1  = o[23][j];
+            line->s0   = o[24][j]; line->s1   = o[25][j];
+        }
+    }
+}
+#endif
+
+#if CHECK_SIMD_TESSELLATION && VF_WIDTH > 1
+//
+// Log every line where compute_lines_simd disagrees with compute_lines.
+//
+// Joins that turn by almost exactly 90 degrees are skipped: whether they are
+// drawn depends on the rounding of the dot product.
+//
+static void check_lines_simd(vector_display_t *self, line_t *lines, const pending_point_t *points, int nlines, int first_last_same, float t) {
+    line_t *ref = (line_t*)scratch_alloc(self, nlines * sizeof(line_t));
+    int     i, j;
+    compute_lines(ref, points, nlines, first_last_same, t);
+    for (i = 0; i < nlines; i++) {
+        line_t *pline = &ref[(nlines+i-1)%nlines], *nline = &ref[(i+1)%nlines];
+        if (fabsf(pline->cos_a * ref[i].cos_a + pline->sin_a * ref[i].sin_a) < 1e-4f ||
+            fabsf(ref[i].cos_a * nline->cos_a + ref[i].sin_a * nline->sin_a) < 1e-4f) continue;
+
+        const float *a = &lines[i].xl0, *b = &ref[i].xl0;
+        int bad = lines[i].has_prev != ref[i].has_prev || lines[i].has_next != ref[i].has_next;
+        for (j = 0; j < 8; j++) {               // xl0 .. yr1
+            if (fabsf(a[j] - b[j]) > 0.01f) bad = 1;
+        }
+        if (bad) {
+            vector_display_debugf("simd tessellation mismatch at line %d/%d: left (%f,%f) vs (%f,%f), right (%f,%f) vs (%f,%f), prev %d vs %d, next %d vs %d",
+                                  i, nlines, a[0], a[1], b[0], b[1], a[4], a[5], b[4], b[5],
+                                  lines[i].has_prev, ref[i].has_prev, lines[i].has_next, ref[i].has_next);
+        }
+    }
+}
+#endif
+
+//
+// Emit a polyline as segments for the GPU line path. Each segment carries
+// its neighbors, so all of the join and cap work is left to the vertex
+// shader. For a closed polyline, the neighbors across the wrap are placed so
+// that they have the same direction and length as the last and first lines,
+// which is what compute_lines joins.
+//
+static void append_segments(vector_display_t *self, const pending_point_t *p, int nlines, int first_last_same, double t) {
+    mesh_t   *mesh      = self->target;
+    int       subpixels = mesh->subpixels;
+    GLushort  thickness = (GLushort)lrint(min(t * subpixels, 0xffff));
+    GLshort  *q         = (GLshort*)scratch_alloc(self, sizeof(GLshort) * 2 * (nlines + 3)) + 2;
+    int       i;
+
+    // pack every point once; q[-1] and q[nlines+1] are the neighbors across the wrap
+    for (i = 0; i <= nlines; i++) {
+        q[2*i]   = pack_position(p[i].x, subpixels);
+        q[2*i+1] = pack_position(p[i].y, subpixels);
+    }
+    q[-2] = pack_position(p[0].x - (p[nlines].x - p[nlines-1].x), subpixels);
+    q[-1] = pack_position(p[0].y - (p[nlines].y - p[nlines-1].y), subpixels);
+    q[2*nlines+2] = pack_position(p[nlines].x + (p[1].x - p[0].x), subpixels);
+    q[2*nlines+3] = pack_position(p[nlines].y + (p[1].y - p[0].y), subpixels);
+
+    ensure_segments(self, mesh, mesh->nsegments + nlines);
+    for (i = 0; i < nlines; i++) {
+        segment_t *seg = &mesh->segments[mesh->nsegments++];
+        int        ip  = i - 1, in = i + 2;
+        seg->links = SEGMENT_LINKS_PREV | SEGMENT_LINKS_NEXT;
+        if (i == 0 && !first_last_same) {
+            ip = i;
+            seg->links &= ~SEGMENT_LINKS_PREV;
+        }
+        if (i == nlines - 1 && !first_last_same) {
+            in = i + 1;
+            seg->links &= ~SEGMENT_LINKS_NEXT;
+        }
+        seg->xp = q[2*ip]; seg->yp = q[2*ip+1];
+        seg->x0 = q[2*i];  seg->y0 = q[2*i+1];
+        seg->x1 = q[2*i+2]; seg->y1 = q[2*i+3];
+        seg->xn = q[2*in]; seg->yn = q[2*in+1];
+        seg->r  = self->color[0];
+        seg->g  = self->color[1];
+        seg->b  = self->color[2];
+        seg->a  = self->color[3];
+        seg->thickness = thickness;
+    }
+}
+
+//
+// Draw npoints points, already transformed to framebuffer coordinates, as
+// one polyline.
+//
+static void tessellate_polyline(vector_display_t *self, const pending_point_t *points, int npoints) {
+    if (npoints < 2) return;
+
+    float t = effective_thickness(self);
+    int  first_last_same = abs(points[0].x - points[npoints-1].x) < 0.1 &&
+                           abs(points[0].y - points[npoints-1].y) < 0.1;
+    int  nlines = npoints - 1;
+
+    if (self->gpu_lines) {
+        append_segments(self, points, nlines, first_last_same, t);
+        if (!self->gpu_lines_pending) {
+            scratch_reset(self);
+            return;
+        }
+        self->target->both_lines = 1;
+    }
+
+    // from the list of points, build a list of lines
+    line_t *lines = (line_t*)scratch_alloc(self, nlines * sizeof(line_t));
+
+#if VF_WIDTH > 1
+    compute_lines_simd(self, lines, points, nlines, first_last_same, t);
+#if CHECK_SIMD_TESSELLATION
+    check_lines_simd(self, lines, points, nlines, first_last_same, t);
+#endif
+#else
+    compute_lines(lines, points, nlines, first_last_same, t);
+#endif
+
+    // draw the lines
+    draw_lines(self, lines, nlines);
+
+    scratch_reset(self);
+}
+
+int vector_display_end_draw(vector_display_t *self) {
+    tessellate_polyline(self, self->pending_points, self->pending_npoints);
+    self->pending_npoints = 0;
+    return 0;
+}
+
+//
+// Transform n points from xy into the pending point buffer, after any points
+// already in it. Returns the first transformed point.
+//
+static pending_point_t *transform_points(vector_display_t *self, const double *xy, int n) {
+    double           scale = self->scale, offset_x = self->offset_x, offset_y = self->offset_y;
+    pending_point_t *out;
+    int              i;
+
+    ensure_pending_points(self, self->pending_npoints + n);
+    out = &self->pending_points[self->pending_npoints];
+    for (i = 0; i < n; i++) {
+        out[i].x = xy[2*i]   * scale + offset_x;
+        out[i].y = xy[2*i+1] * scale + offset_y;
+    }
+    return out;
+}
+
+static pending_point_t *transform_pointsf(vector_display_t *self, const float *xy, int n) {
+    double           scale = self->scale, offset_x = self->offset_x, offset_y = self->offset_y;
+    pending_point_t *out;
+    int              i;
+
+    ensure_pending_points(self, self->pending_npoints + n);
+    out = &self->pending_points[self->pending_npoints];
+    for (i = 0; i < n; i++) {
+        out[i].x = xy[2*i]   * scale + offset_x;
+        out[i].y = xy[2*i+1] * scale + offset_y;
+    }
+    return out;
+}
+
+static int count_points(const int *counts, int npolylines) {
+    int i, total = 0;
+    for (i = 0; i < npolylines; i++) {
+        if (counts[i] < 0) return -1;
+        total += counts[i];
+    }
+    return total;
+}
+
+static void tessellate_polylines(vector_display_t *self, const pending_point_t *points, const int *counts, int npolylines) {
+    int i;
+    for (i = 0; i < npolylines; i++) {
+        tessellate_polyline(self, points, counts[i]);
+        points += counts[i];
+    }
+}
+
+static void tessellate_segments(vector_display_t *self, const pending_point_t *points, int nsegments) {
+    int i;
+    for (i = 0; i < nsegments; i++) {
+        tessellate_polyline(self, points + 2*i, 2);
+    }
+}
+
+int vector_display_draw_polylines(vector_display_t *self, const double *xy, const int *counts, int npolylines) {
+    int npoints = count_points(counts, npolylines);
+    if (npoints < 0 || self->pending_npoints != 0) return -1;
+    tessellate_polylines(self, transform_points(self, xy, npoints), counts, npolylines);
+    return 0;
+}
+
+int vector_display_draw_polylinesf(vector_display_t *self, const float *xy, const int *counts, int npolylines) {
+    int npoints = count_points(counts, npolylines);
+    if (npoints < 0 || self->pending_npoints != 0) return -1;
+    tessellate_polylines(self, transform_pointsf(self, xy, npoints), counts, npolylines);
+    return 0;
+}
+
+int vector_display_draw_segments(vector_display_t *self, const double *xy, int nsegments) {
+    if (nsegments < 0 || self->pending_npoints != 0) return -1;
+    tessellate_segments(self, transform_points(self, xy, 2 * nsegments), nsegments);
+    return 0;
+}
+
+int vector_display_draw_segmentsf(vector_display_t *self, const float *xy, int nsegments) {
+    if (nsegments < 0 || self->pending_npoints != 0) return -1;
+    tessellate_segments(self, transform_pointsf(self, xy, 2 * nsegments), nsegments);
+    return 0;
+}
+
+static void gen_history(vector_display_t *self) {
+    int i;
+    for (i = 0; i < self->steps; i++) {
+        glGenBuffers(1, &self->history[i].vertexbuffer);
+        glGenBuffers(1, &self->history[i].indexbuffer);
+        if (self->gpu_lines) glGenBuffers(1, &self->history[i].segmentbuffer);
+    }
+}
+
+static void delete_history(vector_display_t *self) {
+    int i;
+    for (i = 0; i < self->steps; i++) {
+        glDeleteBuffers(1, &self->history[i].vertexbuffer);
+        glDeleteBuffers(1, &self->history[i].indexbuffer);
+        if (self->history[i].segmentbuffer) glDeleteBuffers(1, &self->history[i].segmentbuffer);
+        self->history[i].segmentbuffer = 0;
+        self->history[i].vertexbytes   = 0;
+        self->history[i].indexbytes    = 0;
+        self->history[i].segmentbytes  = 0;
+        self->history[i].nsegments     = 0;
+        delete_vertex_arrays(&self->history[i].arrays);
+        release_list_draws(self->history[i].list_draws, self->history[i].nlist_draws);
+        self->history[i].nlist_draws   = 0;
+    }
+}
+
+static void set_history_steps(vector_display_t *self, int steps) {
+    if (self->did_setup) {
+        delete_history(self);
+    }
+    free_history(self);
+    self->step = 0;
+    self->steps = steps;
+    alloc_history(self);
+    if (self->did_setup) gen_history(self);
+}
+
+int vector_display_set_decay_steps(vector_display_t *self, int steps) {
+    if (steps < 0 || steps > VECTOR_DISPLAY_MAX_DECAY_STEPS || self->owner != NULL) return -1;
+    self->ring_steps = steps;
+    // accumulating only keeps the current frame
+    if (!self->accumulate) set_history_steps(self, steps);
+    return 0;
+}
+
+int vector_display_set_accumulate(vector_display_t *self, int enable) {
+    if (self->owner != NULL) return -1;
+    enable = enable != 0;
+    if (enable == self->accumulate) return 0;
+    self->accumulate = enable;
+    set_history_steps(self, enable ? 1 : self->ring_steps);
+    if (!self->did_setup) return 0;
+
+    if (!enable) {
+        teardown_accumulation(self);
+        return 0;
+    }
+    GLuint origdrawbuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, (GLint*)&origdrawbuffer);
+    int rc = setup_accumulation(self);
+    glBindFramebuffer(GL_FRAMEBUFFER, origdrawbuffer);
+    return rc;
+}
+
+int vector_display_set_decay(vector_display_t *self, double decay) {
+    if (decay < 0.0f || decay >= 1.0f) return -1;
+    self->decay = decay;
+    return 0;
+}
+
+static void fill_linetex(unsigned char *texbuf) {
+    memset(texbuf, 0xff, TEXTURE_SIZE * TEXTURE_SIZE * 4);
     int x,y;
     for (x = 0; x < TEXTURE_SIZE; x++) {
         for (y = 0; y < TEXTURE_SIZE; y++) {
@@ -671,213 +2298,1308 @@ void gen_linetex(vector_display_t *self) {
 
             if (distance > 1.0) distance = 1.0;
 
-            double line = pow(16, -2 * distance);
-            double glow = pow(2,  -4 * distance) / 10.0;
-            glow = 0;
-            double val  = max(0, min(1, line + glow));                  // clamp
+            double line = pow(16, -2 * distance);
+            double glow = pow(2,  -4 * distance) / 10.0;
+            glow = 0;
+            double val  = max(0, min(1, line + glow));                  // clamp
+
+            //if (distance < 0.1) val = 1.0;
+
+            texbuf[(x + y * TEXTURE_SIZE) * 4 + 0] = 0xff;
+            texbuf[(x + y * TEXTURE_SIZE) * 4 + 1] = 0xff;
+            texbuf[(x + y * TEXTURE_SIZE) * 4 + 2] = 0xff;
+            texbuf[(x + y * TEXTURE_SIZE) * 4 + 3] = (unsigned char)(val*0xff);
+        }
+    }
+}
+
+static void gen_linetex(vector_display_shared_t *shared) {
+    // generate the texture
+    unsigned char texbuf[TEXTURE_SIZE * TEXTURE_SIZE * 4];
+    fill_linetex(texbuf);
+
+    // load and bind the texture
+    glGenTextures(1, &shared->linetexid);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, shared->linetexid);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, TEXTURE_SIZE, TEXTURE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, texbuf);
+    vector_display_check_error("glTexImage2D");
+}
+
+//
+// The beam program to draw lines with instead of the texture program, or NULL
+// if the display uses the line texture, or the program couldn't be built.
+//
+static const beam_program_t *beam_program(vector_display_t *self, const beam_program_t *beam) {
+    return self->beam_falloff > 0.0 && beam->program != 0 ? beam : NULL;
+}
+
+#if HAVE_GPU_LINES
+//
+// The #version line for the GPU line shaders, or NULL if the context can't
+// run them. They need OpenGL 3.3 or OpenGL ES 3.0.
+//
+static const char *gpu_lines_glsl_version(void) {
+    int major, minor, es;
+    if (!vector_display_gl_version(&major, &minor, &es)) return NULL;
+    if (es) {
+        return major >= 3 ? "#version 300 es\n" : NULL;
+    }
+    if (major > 3 || (major == 3 && minor >= 3)) {
+        return "#version 330\n";
+    }
+    return NULL;
+}
+
+//
+// Each instance is one segment_t, drawn as SEGMENT_VERTICES vertices:
+// triangles 0-1 are the body, 2-3 the startcap, 4-5 the endcap and 6-9 the
+// join fan, the same triangles draw_lines builds. Triangles that aren't
+// needed are collapsed to a point outside the viewport. Joins are worked out
+// from the neighboring segments exactly as compute_lines does, so two
+// segments always agree about the join between them.
+//
+static const char *segment_vertex_shader_text =
+    "    uniform mat4 inProjectionMatrix;       \n"
+    "    uniform mat4 inModelViewMatrix;        \n"
+    "                                           \n"
+    "    in vec2 inPrev;                        \n"
+    "    in vec4 inColor;                       \n"
+    "    in vec2 inStart;                       \n"
+    "    in vec2 inEnd;                         \n"
+    "    in vec2 inNext;                        \n"
+    "    in vec2 inInfo;                        \n"   // thickness, links
+    "                                           \n"
+    "    out vec4 Color;                        \n"
+    "    out vec2 TexCoord;                     \n"
+    "                                           \n"
+    "    const int corners[18] = int[18](1,3,2, 0,1,2, 0,4,1, 1,4,5, 6,2,3, 6,3,7);\n"
+    "                                           \n"
+    "    vec3 direction(vec2 a, vec2 b) {       \n"   // unit direction and length, zero length points along +x
+    "        vec2  d = b - a;                   \n"
+    "        float l = length(d);               \n"
+    "        return l > 0.0 ? vec3(d / l, l) : vec3(1.0, 0.0, 0.0);\n"
+    "    }                                      \n"
+    "                                           \n"
+    "    vec4 join(vec3 p, vec3 l, float t) {   \n"   // drawn, shorten, left and right thickness
+    "        float c = dot(p.xy, l.xy);         \n"
+    "        float s = p.x * l.y - p.y * l.x;   \n"
+    "        if (c < -1.1920929e-07) return vec4(0.0, 0.0, t, t);\n"
+    "        float maxshorten = min(p.z, l.z) / 2.0;\n"
+    "        float shorten    = t * abs(s) / (1.0 + c);\n"
+    "        float thick      = t;              \n"
+    "        if (shorten > maxshorten) {        \n"
+    "            shorten = maxshorten;          \n"
+    "            thick   = maxshorten * (1.0 + c) / abs(s);\n"
+    "        }                                  \n"
+    "        return s > 0.0 ? vec4(1.0, shorten, t, thick) : vec4(1.0, shorten, thick, t);\n"
+    "    }                                      \n"
+    "                                           \n"
+    "    void main() {                          \n"
+    "        float t  = inInfo.x;               \n"
+    "        vec3  d  = direction(inStart, inEnd);\n"
+    "        vec3  pd = direction(inPrev, inStart);\n"
+    "        vec4  j0 = mod(inInfo.y, 2.0) > 0.5 ? join(pd, d, t) : vec4(0.0, 0.0, t, t);\n"
+    "        vec4  j1 = inInfo.y > 1.5 ? join(d, direction(inEnd, inNext), t) : vec4(0.0, 0.0, t, t);\n"
+    "                                           \n"
+    "        vec2  n  = vec2(d.y, -d.x);        \n"   // toward the left side
+    "        vec2  p0 = inStart + j0.y * d.xy;  \n"
+    "        vec2  p1 = inEnd   - j1.y * d.xy;  \n"
+    "        vec2  l0 = p0 + j0.z * n, r0 = p0 - j0.w * n;\n"
+    "        vec2  l1 = p1 + j1.z * n, r1 = p1 - j1.w * n;\n"
+    "        float ul0 = 0.5 - 0.5 * j0.z / t, ur0 = 0.5 + 0.5 * j0.w / t;\n"
+    "        float ul1 = 0.5 - 0.5 * j1.z / t, ur1 = 0.5 + 0.5 * j1.w / t;\n"
+    "                                           \n"
+    "        int   tri = gl_VertexID / 3;       \n"
+    "        int   corner = gl_VertexID - 3 * tri;\n"
+    "        bool  drawn;                       \n"
+    "        vec2  pos, uv;                     \n"
+    "        if (tri < 6) {                     \n"   // body and caps
+    "            vec2 pts[8] = vec2[8](l0, r0, l1, r1, l0 - t * d.xy, r0 - t * d.xy, l1 + t * d.xy, r1 + t * d.xy);\n"
+    "            vec2 uvs[8] = vec2[8](vec2(ul0, 0.5), vec2(ur0, 0.5), vec2(ul1, 0.5), vec2(ur1, 0.5),\n"
+    "                                  vec2(ul0, 1.0), vec2(ur0, 1.0), vec2(ul1, 1.0), vec2(ur1, 1.0));\n"
+    "            int  k = corners[gl_VertexID]; \n"
+    "            pos   = pts[k];                \n"
+    "            uv    = uvs[k];                \n"
+    "            drawn = tri < 2 || (tri < 4 ? j0.x == 0.0 : j1.x == 0.0);\n"
+    "        } else {                           \n"   // join fan, the rim turns counterclockwise from start
+    "            float c = dot(pd.xy, d.xy);    \n"
+    "            float s = pd.x * d.y - pd.y * d.x;\n"
+    "            int   nsteps = 1 + int(c < 0.83146961) + int(c < 0.55557023) + int(c < 0.19509032);\n"
+    "            vec2  center = s > 0.0 ? r0 : l0;\n"
+    "            vec2  start  = s > 0.0 ? vec2(pd.y, -pd.x) : -n;\n"
+    "            float a = atan(abs(s), c) * float(tri - 6 + (corner == 2 ? 1 : 0)) / float(nsteps);\n"
+    "            if (corner == 1) {             \n"
+    "                pos = center;              \n"
+    "                uv  = s > 0.0 ? vec2(ur0, 0.5) : vec2(ul0, 0.5);\n"
+    "            } else {                       \n"
+    "                pos = center + (j0.z + j0.w) * vec2(start.x * cos(a) - start.y * sin(a), start.x * sin(a) + start.y * cos(a));\n"
+    "                uv  = vec2(s > 0.0 ? 0.0 : 1.0, 0.5);\n"
+    "            }                              \n"
+    "            drawn = j0.x != 0.0 && tri - 6 < nsteps;\n"
+    "        }                                  \n"
+    "        gl_Position = drawn ? inProjectionMatrix * inModelViewMatrix * vec4(pos, 10000.0, 1.0) : vec4(2.0, 2.0, 2.0, 1.0);\n"
+    "        Color       = inColor;             \n"
+    "        TexCoord    = uv;                  \n"
+    "    }\n";
+
+static const char *segment_fragment_shader_text =
+    "#ifdef GL_ES                               \n"
+    "    precision mediump float;               \n"
+    "#endif                                     \n"
+    "                                           \n"
+    "    uniform sampler2D tex1;                \n"
+    "    uniform float alpha;                   \n"
+    "                                           \n"
+    "    in vec4 Color;                         \n"
+    "    in vec2 TexCoord;                      \n"
+    "    out vec4 FragColor;                    \n"
+    "                                           \n"
+    "    void main() {                          \n"
+    "        vec4 texColor = texture(tex1, TexCoord.st);\n"
+    "        FragColor = Color * texColor * vec4(1.0, 1.0, 1.0, alpha);\n"
+    "    }                                      \n";
+
+static const vector_display_attrib_t segment_attribs[] = {
+    { SEGMENT_PREV_INDEX,  "inPrev" },
+    { SEGMENT_COLOR_INDEX, "inColor" },
+    { SEGMENT_START_INDEX, "inStart" },
+    { SEGMENT_END_INDEX,   "inEnd" },
+    { SEGMENT_NEXT_INDEX,  "inNext" },
+    { SEGMENT_INFO_INDEX,  "inInfo" },
+};
+
+// segment_fragment_shader_text with the beam profile worked out from TexCoord
+static const char *segment_beam_fragment_shader_text =
+    "#ifdef GL_ES                               \n"
+    "    precision mediump float;               \n"
+    "#endif                                     \n"
+    "                                           \n"
+    "    uniform float alpha;                   \n"
+    "    uniform float falloff;                 \n"
+    "                                           \n"
+    "    in vec4 Color;                         \n"
+    "    in vec2 TexCoord;                      \n"
+    "    out vec4 FragColor;                    \n"
+    "                                           \n"
+    "    void main() {                          \n"
+    "        float d = min(length(TexCoord - 0.5) * 2.0, 1.0);\n"
+    "        FragColor = Color * vec4(1.0, 1.0, 1.0, exp2(-falloff * d) * alpha);\n"
+    "    }                                      \n";
+
+static int setup_segment_program(vector_display_shared_t *shared) {
+    const char *version = gpu_lines_glsl_version();
+
+    if (version == NULL) return -1;
+
+    // finished by finish_segment_program
+    if (vector_display_begin_program(&shared->segment_build, version, segment_vertex_shader_text,
+        segment_fragment_shader_text, segment_attribs, countof(segment_attribs)) < 0) return -1;
+    shared->segment_pending = 1;
+
+    return 0;
+}
+
+static void finish_segment_program(vector_display_shared_t *shared) {
+    if (!shared->segment_pending) return;
+    shared->segment_pending = 0;
+    shared->segment_program = vector_display_end_program(&shared->segment_build);
+    if (shared->segment_program == 0) return;
+    shared->segment_uniform_modelview  = glGetUniformLocation(shared->segment_program, "inModelViewMatrix");
+    shared->segment_uniform_projection = glGetUniformLocation(shared->segment_program, "inProjectionMatrix");
+    shared->segment_uniform_alpha      = glGetUniformLocation(shared->segment_program, "alpha");
+}
+
+static void segment_attrib_pointers(void) {
+    int i;
+    glVertexAttribPointer(SEGMENT_PREV_INDEX,  2, GL_SHORT,          GL_FALSE, sizeof(segment_t), (void*)offsetof(segment_t, xp));
+    glVertexAttribPointer(SEGMENT_COLOR_INDEX, 4, GL_UNSIGNED_BYTE,  GL_TRUE,  sizeof(segment_t), (void*)offsetof(segment_t, r));
+    glVertexAttribPointer(SEGMENT_START_INDEX, 2, GL_SHORT,          GL_FALSE, sizeof(segment_t), (void*)offsetof(segment_t, x0));
+    glVertexAttribPointer(SEGMENT_END_INDEX,   2, GL_SHORT,          GL_FALSE, sizeof(segment_t), (void*)offsetof(segment_t, x1));
+    glVertexAttribPointer(SEGMENT_NEXT_INDEX,  2, GL_SHORT,          GL_FALSE, sizeof(segment_t), (void*)offsetof(segment_t, xn));
+    glVertexAttribPointer(SEGMENT_INFO_INDEX,  2, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(segment_t), (void*)offsetof(segment_t, thickness));
+    for (i = 0; i < SEGMENT_NATTRIBS; i++) {
+        glEnableVertexAttribArray(i);
+        glVertexAttribDivisor(i, 1);
+    }
+}
+
+static void draw_segments(vector_display_t *self, GLuint segmentbuffer, vertex_arrays_t *arrays, int nsegments, const GLfloat *mvmat, float alpha) {
+    const beam_program_t *beam = beam_program(self, &self->shared->segment_beam);
+    int i;
+    if (nsegments == 0) return;
+    if (beam != NULL) {
+        use_program(self, beam->program);
+        set_uniform_matrix4(self, beam->uniform_modelview, mvmat);
+        set_uniform1f(self, beam->uniform_alpha, alpha);
+    } else {
+        use_program(self, self->shared->segment_program);
+        set_uniform_matrix4(self, self->shared->segment_uniform_modelview, mvmat);
+        set_uniform1f(self, self->shared->segment_uniform_alpha, alpha);
+    }
+    if (self->shared->vertex_arrays) {
+        if (arrays->segments == 0) {
+            glGenVertexArrays(1, &arrays->segments);
+            bind_vertex_array(self, arrays->segments);
+            bind_buffer(self, GL_ARRAY_BUFFER, segmentbuffer);
+            segment_attrib_pointers();
+        }
+        bind_vertex_array(self, arrays->segments);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, SEGMENT_VERTICES, nsegments);
+        return;
+    }
+
+    bind_buffer(self, GL_ARRAY_BUFFER, segmentbuffer);
+    segment_attrib_pointers();
+
+    glDrawArraysInstanced(GL_TRIANGLES, 0, SEGMENT_VERTICES, nsegments);
+
+    // everything else draws with per-vertex attributes
+    for (i = 0; i < SEGMENT_NATTRIBS; i++) {
+        glVertexAttribDivisor(i, 0);
+        if (i > VERTEX_TEXCOORD_INDEX) glDisableVertexAttribArray(i);
+    }
+    self->gl.enabled_attribs = (1u << VERTEX_POS_INDEX) | (1u << VERTEX_COLOR_INDEX) | (1u << VERTEX_TEXCOORD_INDEX);
+    self->gl.quad_attribs    = GL_STATE_UNKNOWN;
+}
+#endif
+
+// vertex shader for painting one texture over another
+static const char *nocolor_vertex_shader_text =
+    "    uniform mat4 inProjectionMatrix;       \n"
+    "    uniform mat4 inModelViewMatrix;        \n"
+    "                                           \n"
+    "    attribute vec2 inTexCoord;             \n"
+    "    attribute vec4 inPosition;             \n"
+    "                                           \n"
+    "    varying vec2 TexCoord;                 \n"
+    "                                           \n"
+    "    void main() {                          \n"
+    "        gl_Position = inProjectionMatrix * inModelViewMatrix * inPosition;\n"
+    "        TexCoord    = inTexCoord;          \n"
+    "    }\n";
+
+static const vector_display_attrib_t nocolor_attribs[] = {
+    { VERTEX_POS_INDEX,      "inPosition" },
+    { VERTEX_TEXCOORD_INDEX, "inTexCoord" },
+};
+
+// inPosition arrives in fixed point; inModelViewMatrix scales it back to pixels
+static const char *fb_vertex_shader_text =
+    "    uniform mat4 inProjectionMatrix;       \n"
+    "    uniform mat4 inModelViewMatrix;        \n"
+    "                                           \n"
+    "    attribute vec2 inTexCoord;             \n"
+    "    attribute vec2 inPosition;             \n"
+    "    attribute vec4 inColor;                \n"
+    "                                           \n"
+    "    varying vec4 Color;                    \n"
+    "    varying vec2 TexCoord;                 \n"
+    "                                           \n"
+    "    void main() {                          \n"
+    "        gl_Position = inProjectionMatrix * inModelViewMatrix * vec4(inPosition, 10000.0, 1.0);\n"
+    "        Color       = inColor;             \n"
+    "        TexCoord    = inTexCoord;          \n"
+    "    }\n";
+
+static const vector_display_attrib_t fb_attribs[] = {
+    { VERTEX_COLOR_INDEX,    "inColor" },
+    { VERTEX_POS_INDEX,      "inPosition" },
+    { VERTEX_TEXCOORD_INDEX, "inTexCoord" },
+};
+
+//
+// The beam's profile, worked out from TexCoord instead of read from the line
+// texture. d goes from 0 at the center of the line to 1 at its edge, where
+// the texture holds 16^(-2d), so a falloff of 8 matches it.
+//
+static const char *beam_fragment_shader_text =
+    "#ifdef GL_ES                               \n"
+    "    precision mediump float;               \n"
+    "#endif                                     \n"
+    "                                           \n"
+    "    uniform float alpha;                   \n"
+    "    uniform float falloff;                 \n"
+    "                                           \n"
+    "    varying vec4 Color;                    \n"
+    "    varying vec2 TexCoord;                 \n"
+    "                                           \n"
+    "    void main() {                          \n"
+    "        float d = min(length(TexCoord - 0.5) * 2.0, 1.0);\n"
+    "        gl_FragColor = Color * vec4(1.0, 1.0, 1.0, exp2(-falloff * d) * alpha);\n"
+    "    }                                      \n";
+
+static void begin_beam_program(beam_program_t *beam, const char *version, const char *vertexSrc,
+                               const char *fragmentSrc, const vector_display_attrib_t *attribs, int nattribs) {
+    if (beam->tried) return;
+    beam->tried   = 1;
+    beam->pending = vector_display_begin_program(&beam->build, version, vertexSrc, fragmentSrc, attribs, nattribs) == 0;
+}
+
+static int beam_program_ready(const beam_program_t *beam) {
+    return !beam->pending || vector_display_program_ready(&beam->build);
+}
+
+static void finish_beam_program(beam_program_t *beam) {
+    if (!beam->pending) return;
+    beam->pending = 0;
+    beam->program = vector_display_end_program(&beam->build);
+    if (beam->program == 0) return;
+    beam->uniform_modelview  = glGetUniformLocation(beam->program, "inModelViewMatrix");
+    beam->uniform_projection = glGetUniformLocation(beam->program, "inProjectionMatrix");
+    beam->uniform_alpha      = glGetUniformLocation(beam->program, "alpha");
+    beam->uniform_falloff    = glGetUniformLocation(beam->program, "falloff");
+}
+
+static void delete_beam_program(beam_program_t *beam) {
+    finish_beam_program(beam);
+    if (beam->program) glDeleteProgram(beam->program);
+    memset(beam, 0, sizeof(*beam));
+}
+
+//
+// Start the beam programs the display's lines are drawn with.
+//
+static void setup_beam_programs(vector_display_t *self) {
+    begin_beam_program(&self->shared->fb_beam, NULL, fb_vertex_shader_text, beam_fragment_shader_text,
+        fb_attribs, countof(fb_attribs));
+#if HAVE_GPU_LINES && !DEBUG_TRIANGLES
+    if (self->gpu_lines) {
+        begin_beam_program(&self->shared->segment_beam, gpu_lines_glsl_version(), segment_vertex_shader_text,
+            segment_beam_fragment_shader_text, segment_attribs, countof(segment_attribs));
+    }
+#endif
+}
+
+static void finish_beam_programs(vector_display_t *self) {
+    finish_beam_program(&self->shared->fb_beam);
+    finish_beam_program(&self->shared->segment_beam);
+}
+
+//
+// Weights of the taps 0 to radius of a blur kernel, which is symmetric around
+// tap 0. A sigma of 0 selects the original fixed 9-tap kernel.
+//
+static void blur_kernel_weights(double sigma, int radius, double *weights) {
+    static const double fixed_weights[] = { 0.16, 0.15, 0.12, 0.09, 0.05 };
+    double sum = 0.0;
+    int i;
+    if (sigma == 0.0) {
+        for (i = 0; i <= radius; i++) weights[i] = fixed_weights[i];
+        return;
+    }
+    for (i = 0; i <= radius; i++) {
+        weights[i] = exp(-(double)(i * i) / (2.0 * sigma * sigma));
+        sum += i == 0 ? weights[i] : 2.0 * weights[i];
+    }
+    for (i = 0; i <= radius; i++) weights[i] /= sum;
+}
+
+//
+// Generate the source of a blur fragment shader. Taps 2k-1 and 2k on each side
+// are read with a single linear filtered read between them, weighted so the
+// filtering blends the two texels in the kernel's proportion. A kernel of
+// radius r takes 1 + 2 * ceil(r / 2) reads instead of 2r + 1.
+//
+static void gen_blur_shader_text(double sigma, int radius, char *text, size_t size) {
+    double weights[VECTOR_DISPLAY_MAX_BLUR_RADIUS + 1];
+    size_t len;
+    int i;
+
+    blur_kernel_weights(sigma, radius, weights);
+    len = snprintf(text, size,
+    "#ifdef GL_ES                               \n"
+    "    precision mediump float;               \n"
+    "#endif                                     \n"
+    "    uniform sampler2D tex1;                \n"
+    "    uniform vec2      scale;               \n"
+    "    varying vec2      TexCoord;            \n"
+    "    uniform float     alpha;               \n"
+    "    uniform float     mult;                \n"
+    "                                           \n"
+    "    void main() {                          \n"
+    "       vec4 color = texture2D(tex1, TexCoord)*%.8f;\n", weights[0]);
+    for (i = 1; i <= radius; i += 2) {
+        double weight = weights[i], offset = i;
+        if (i < radius) {
+            weight += weights[i+1];
+            offset  = (i * weights[i] + (i+1) * weights[i+1]) / weight;
+        }
+        len += snprintf(text + len, size - len,
+    "       color += texture2D(tex1, TexCoord - %.8f*scale)*%.8f;\n"
+    "       color += texture2D(tex1, TexCoord + %.8f*scale)*%.8f;\n", offset, weight, offset, weight);
+    }
+    snprintf(text + len, size - len,
+    "       gl_FragColor = color * vec4(mult,mult,mult,alpha*mult);\n"
+    "    }                                      \n");
+}
+
+//
+// Find the blur program for a kernel, starting to build it if it isn't cached,
+// and take a reference to it. Returns its index in blur_programs, or -1 if it
+// can't be built. The program can't be used until finish_blur_program. When
+// the cache is full, the unused program used longest ago is replaced; if every
+// program is in use, the cache grows.
+//
+static int get_blur_program(vector_display_shared_t *shared, double sigma, int radius) {
+    char text[4096];
+    blur_program_t *blur;
+    vector_display_program_t build;
+    int i, oldest = -1;
+
+    for (i = 0; i < shared->nblur_programs; i++) {
+        blur = &shared->blur_programs[i];
+        if (blur->sigma == sigma && blur->radius == radius) {
+            // it would fail again
+            if (blur->program == 0 && !blur->pending) return -1;
+            blur->refs++;
+            blur->last_used = ++shared->blur_uses;
+            return i;
+        }
+        if (blur->refs == 0 && (oldest < 0 || blur->last_used < shared->blur_programs[oldest].last_used)) oldest = i;
+    }
 
-            //if (distance < 0.1) val = 1.0;
+    gen_blur_shader_text(sigma, radius, text, sizeof(text));
+    if (vector_display_begin_program(&build, NULL, nocolor_vertex_shader_text, text,
+        nocolor_attribs, countof(nocolor_attribs)) < 0) return -1;
 
-            texbuf[(x + y * TEXTURE_SIZE) * 4 + 0] = 0xff;
-            texbuf[(x + y * TEXTURE_SIZE) * 4 + 1] = 0xff;
-            texbuf[(x + y * TEXTURE_SIZE) * 4 + 2] = 0xff;
-            texbuf[(x + y * TEXTURE_SIZE) * 4 + 3] = (unsigned char)(val*0xff);
+    if (shared->nblur_programs >= BLUR_PROGRAM_CACHE_SIZE && oldest >= 0) {
+        i = oldest;
+        forget_uniforms(shared, shared->blur_programs[i].program);
+        glDeleteProgram(shared->blur_programs[i].program);
+    } else {
+        if (shared->nblur_programs == shared->cblur_programs) {
+            int capacity = max(BLUR_PROGRAM_CACHE_SIZE, shared->cblur_programs * 2);
+            shared->blur_programs = (blur_program_t*)shared_realloc(shared, shared->blur_programs,
+                sizeof(blur_program_t) * shared->cblur_programs, sizeof(blur_program_t) * capacity);
+            shared->cblur_programs = capacity;
         }
+        i = shared->nblur_programs++;
     }
+    blur = &shared->blur_programs[i];
+    blur->sigma              = sigma;
+    blur->radius             = radius;
+    blur->refs               = 1;
+    blur->last_used          = ++shared->blur_uses;
+    blur->pending            = 1;
+    blur->build              = build;
+    blur->program            = 0;
+    return i;
+}
 
-    // load and bind the texture
-    glGenTextures(1, &self->linetexid);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, self->linetexid);
+static int finish_blur_program(vector_display_shared_t *shared, int i) {
+    blur_program_t *blur = &shared->blur_programs[i];
+    if (blur->pending) {
+        blur->pending = 0;
+        blur->program = vector_display_end_program(&blur->build);
+        if (blur->program == 0) return -1;
+        blur->uniform_modelview  = glGetUniformLocation(blur->program, "inModelViewMatrix");
+        blur->uniform_projection = glGetUniformLocation(blur->program, "inProjectionMatrix");
+        blur->uniform_scale      = glGetUniformLocation(blur->program, "scale");
+        blur->uniform_alpha      = glGetUniformLocation(blur->program, "alpha");
+        blur->uniform_mult       = glGetUniformLocation(blur->program, "mult");
+    }
+    return blur->program != 0 ? 0 : -1;
+}
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+static void release_blur_program(vector_display_t *self) {
+    if (self->blur < 0) return;
+    // programs nobody uses are never left half built
+    finish_blur_program(self->shared, self->blur);
+    blur_program_t *blur = &self->shared->blur_programs[self->blur];
+    blur->refs--;
+    blur->last_used = ++self->shared->blur_uses;
+    self->blur = -1;
+}
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, TEXTURE_SIZE, TEXTURE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, texbuf);
-    vector_display_check_error("glTexImage2D");
+static void delete_blur_programs(vector_display_shared_t *shared) {
+    int i;
+    for (i = 0; i < shared->nblur_programs; i++) {
+        glDeleteProgram(shared->blur_programs[i].program);
+    }
+    shared->nblur_programs = 0;
 }
 
-int vector_display_setup(vector_display_t *self) {
-    const char *nocolor_vertex_shader_text =
-    "    uniform mat4 inProjectionMatrix;       \n"
-    "    uniform mat4 inModelViewMatrix;        \n"
+//
+// Create the resources displays share. The programs are only started, and are
+// finished by finish_shared. Segment and blur programs are only compiled when
+// a display asks for them.
+//
+static int setup_shared(vector_display_shared_t *shared) {
+    const char *blit_fragment_shader_text =
+    "#ifdef GL_ES                               \n"
+    "    precision mediump float;               \n"
+    "#endif                                     \n"
+    "    uniform sampler2D tex1;                \n"
+    "    varying vec2 TexCoord;                 \n"
+    "    uniform float alpha;                   \n"
+    "    uniform float mult;                    \n"
     "                                           \n"
-    "    attribute vec2 inTexCoord;             \n"
-    "    attribute vec4 inPosition;             \n"
+    "    void main() {                          \n"
+    "        gl_FragColor = texture2D(tex1, TexCoord.st) * vec4(mult, mult, mult, alpha*mult);\n"
+    "    }                                      \n";
+
+    const char *fb_fragment_shader_text =
+    "#ifdef GL_ES                               \n"
+    "    precision mediump float;               \n"
+    "#endif                                     \n"
+    "                                           \n"
+    "    uniform sampler2D tex1;                \n"
+    "    uniform float alpha;                   \n"
     "                                           \n"
+    "    varying vec4 Color;                    \n"
     "    varying vec2 TexCoord;                 \n"
     "                                           \n"
     "    void main() {                          \n"
-    "        gl_Position = inProjectionMatrix * inModelViewMatrix * inPosition;\n"
-    "        TexCoord    = inTexCoord;          \n"
-    "    }\n";
+    "        vec4 texColor = texture2D(tex1, TexCoord.st);\n"
+    "        gl_FragColor = Color * texColor * vec4(1.0, 1.0, 1.0, alpha);\n"
+    "    }                                      \n";
+
+    const char *decay_fragment_shader_text =
+    "#ifdef GL_ES                               \n"
+    "#ifdef GL_FRAGMENT_PRECISION_HIGH          \n"
+    "    precision highp float;                 \n"
+    "#else                                      \n"
+    "    precision mediump float;               \n"
+    "#endif                                     \n"
+    "#endif                                     \n"
+    "    uniform sampler2D tex1;                \n"
+    "    uniform float     decay;               \n"
+    "    uniform float     fade;                \n"
+    "    varying vec2      TexCoord;            \n"
+    "                                           \n"
+    "    void main() {                          \n"
+    "       // take off fade too, so colors always reach black\n"
+    "       vec3 color = texture2D(tex1, TexCoord.st).rgb * decay - fade;\n"
+    "       gl_FragColor = vec4(clamp(color, 0.0, 1.0), 1.0);\n"
+    "    }                                      \n";
+
+    // halfpixel is half a texel of the smaller of the source and the target
+    const char *bloom_down_fragment_shader_text =
+    "#ifdef GL_ES                               \n"
+    "    precision mediump float;               \n"
+    "#endif                                     \n"
+    "    uniform sampler2D tex1;                \n"
+    "    uniform vec2      halfpixel;           \n"
+    "    varying vec2      TexCoord;            \n"
+    "                                           \n"
+    "    void main() {                          \n"
+    "       vec4 color = texture2D(tex1, TexCoord) * 4.0;\n"
+    "       color += texture2D(tex1, TexCoord - halfpixel);\n"
+    "       color += texture2D(tex1, TexCoord + halfpixel);\n"
+    "       color += texture2D(tex1, TexCoord + vec2(halfpixel.x, -halfpixel.y));\n"
+    "       color += texture2D(tex1, TexCoord - vec2(halfpixel.x, -halfpixel.y));\n"
+    "       gl_FragColor = color / 8.0;         \n"
+    "    }                                      \n";
+
+    const char *bloom_up_fragment_shader_text =
+    "#ifdef GL_ES                               \n"
+    "    precision mediump float;               \n"
+    "#endif                                     \n"
+    "    uniform sampler2D tex1;                \n"
+    "    uniform vec2      halfpixel;           \n"
+    "    uniform float     mult;                \n"
+    "    varying vec2      TexCoord;            \n"
+    "                                           \n"
+    "    void main() {                          \n"
+    "       vec4 color = vec4(0,0,0,0);         \n"
+    "       color += texture2D(tex1, TexCoord + vec2(-halfpixel.x * 2.0, 0.0));\n"
+    "       color += texture2D(tex1, TexCoord + vec2(-halfpixel.x, halfpixel.y)) * 2.0;\n"
+    "       color += texture2D(tex1, TexCoord + vec2(0.0, halfpixel.y * 2.0));\n"
+    "       color += texture2D(tex1, TexCoord + vec2(halfpixel.x, halfpixel.y)) * 2.0;\n"
+    "       color += texture2D(tex1, TexCoord + vec2(halfpixel.x * 2.0, 0.0));\n"
+    "       color += texture2D(tex1, TexCoord + vec2(halfpixel.x, -halfpixel.y)) * 2.0;\n"
+    "       color += texture2D(tex1, TexCoord + vec2(0.0, -halfpixel.y * 2.0));\n"
+    "       color += texture2D(tex1, TexCoord + vec2(-halfpixel.x, -halfpixel.y)) * 2.0;\n"
+    "       gl_FragColor = color * (mult / 12.0);\n"
+    "    }                                      \n";
+
+    // start all the programs, so the driver can build them at once
+    shared->programs_pending = 1;
+    if (vector_display_begin_program(&shared->builds[SHARED_FB_PROGRAM], NULL,
+            fb_vertex_shader_text, fb_fragment_shader_text, fb_attribs, countof(fb_attribs)) < 0 ||
+        vector_display_begin_program(&shared->builds[SHARED_SCREEN_PROGRAM], NULL,
+            nocolor_vertex_shader_text, blit_fragment_shader_text, nocolor_attribs, countof(nocolor_attribs)) < 0 ||
+        vector_display_begin_program(&shared->builds[SHARED_DECAY_PROGRAM], NULL,
+            nocolor_vertex_shader_text, decay_fragment_shader_text, nocolor_attribs, countof(nocolor_attribs)) < 0 ||
+        vector_display_begin_program(&shared->builds[SHARED_BLOOM_DOWN_PROGRAM], NULL,
+            nocolor_vertex_shader_text, bloom_down_fragment_shader_text, nocolor_attribs, countof(nocolor_attribs)) < 0 ||
+        vector_display_begin_program(&shared->builds[SHARED_BLOOM_UP_PROGRAM], NULL,
+            nocolor_vertex_shader_text, bloom_up_fragment_shader_text, nocolor_attribs, countof(nocolor_attribs)) < 0) return -1;
+
+    // generate the line texture
+    gen_linetex(shared);
+
+    // generate the vertex buffer for the blits
+    glGenBuffers(1, &shared->unit_vertexbuffer);
+
+    // a quad over the whole viewport with unit_projmat, whatever its size
+    nocolor_point_t unit_points[] = {
+    //    x                 y                  z           u, v
+    //   ------------------------------------------------------------
+        { 0,                0,                 10000,      0, 1 },        // upper left triangle
+        { 1,                1,                 10000,      1, 0 },
+        { 1,                0,                 10000,      1, 1 },
+
+        { 0,                0,                 10000,      0, 1 },        // lower right triangle
+        { 0,                1,                 10000,      0, 0 },
+        { 1,                1,                 10000,      1, 0 },
+    };
+    glBindBuffer(GL_ARRAY_BUFFER, shared->unit_vertexbuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(unit_points), unit_points, GL_STATIC_DRAW);
+
+#if HAVE_VERTEX_ARRAYS
+    {
+        int major, minor, es;
+        const char *extensions;
+        shared->vertex_arrays = vector_display_gl_version(&major, &minor, &es) && major >= 3;
+        if (!shared->vertex_arrays && (extensions = (const char*)glGetString(GL_EXTENSIONS)) != NULL) {
+            shared->vertex_arrays = strstr(extensions, "GL_OES_vertex_array_object") != NULL;
+        }
+    }
+    if (shared->vertex_arrays) shared->unit_vertexarray = gen_quad_vertexarray(shared->unit_vertexbuffer);
+#endif
+
+    return 0;
+}
+
+static int shared_programs_ready(vector_display_shared_t *shared) {
+    int i;
+    if (!shared->programs_pending) return 1;
+    for (i = 0; i < SHARED_NPROGRAMS; i++) {
+        if (!vector_display_program_ready(&shared->builds[i])) return 0;
+    }
+    return 1;
+}
+
+//
+// Finish the programs setup_shared started, waiting for the driver if it
+// hasn't linked them yet.
+//
+static int finish_shared(vector_display_shared_t *shared) {
+    if (!shared->programs_pending) return shared->setup_rc;
+    shared->programs_pending = 0;
+    shared->fb_program         = vector_display_end_program(&shared->builds[SHARED_FB_PROGRAM]);
+    shared->screen_program     = vector_display_end_program(&shared->builds[SHARED_SCREEN_PROGRAM]);
+    shared->decay_program      = vector_display_end_program(&shared->builds[SHARED_DECAY_PROGRAM]);
+    shared->bloom_down_program = vector_display_end_program(&shared->builds[SHARED_BLOOM_DOWN_PROGRAM]);
+    shared->bloom_up_program   = vector_display_end_program(&shared->builds[SHARED_BLOOM_UP_PROGRAM]);
+    if (shared->fb_program == 0 || shared->screen_program == 0 || shared->decay_program == 0 ||
+        shared->bloom_down_program == 0 || shared->bloom_up_program == 0) {
+        shared->setup_rc = -1;
+        return -1;
+    }
+
+    shared->fb_uniform_modelview  = glGetUniformLocation(shared->fb_program, "inModelViewMatrix");
+    shared->fb_uniform_projection = glGetUniformLocation(shared->fb_program, "inProjectionMatrix");
+    shared->fb_uniform_alpha      = glGetUniformLocation(shared->fb_program, "alpha");
+
+    shared->screen_uniform_modelview  = glGetUniformLocation(shared->screen_program, "inModelViewMatrix");
+    shared->screen_uniform_projection = glGetUniformLocation(shared->screen_program, "inProjectionMatrix");
+    shared->screen_uniform_alpha      = glGetUniformLocation(shared->screen_program, "alpha");
+    shared->screen_uniform_mult       = glGetUniformLocation(shared->screen_program, "mult");
+
+    shared->decay_uniform_modelview  = glGetUniformLocation(shared->decay_program, "inModelViewMatrix");
+    shared->decay_uniform_projection = glGetUniformLocation(shared->decay_program, "inProjectionMatrix");
+    shared->decay_uniform_decay      = glGetUniformLocation(shared->decay_program, "decay");
+    shared->decay_uniform_fade       = glGetUniformLocation(shared->decay_program, "fade");
+
+    shared->bloom_down_uniform_modelview  = glGetUniformLocation(shared->bloom_down_program, "inModelViewMatrix");
+    shared->bloom_down_uniform_projection = glGetUniformLocation(shared->bloom_down_program, "inProjectionMatrix");
+    shared->bloom_down_uniform_halfpixel  = glGetUniformLocation(shared->bloom_down_program, "halfpixel");
+
+    shared->bloom_up_uniform_modelview  = glGetUniformLocation(shared->bloom_up_program, "inModelViewMatrix");
+    shared->bloom_up_uniform_projection = glGetUniformLocation(shared->bloom_up_program, "inProjectionMatrix");
+    shared->bloom_up_uniform_halfpixel  = glGetUniformLocation(shared->bloom_up_program, "halfpixel");
+    shared->bloom_up_uniform_mult       = glGetUniformLocation(shared->bloom_up_program, "mult");
+
+    return 0;
+}
+
+int vector_display_setup_async(vector_display_t *self) {
+    vector_display_shared_t *shared;
+    int rc;
+
+    if (self->owner != NULL || self->soft != NULL) return -1;
+    if (self->shared == NULL &&
+        vector_display_shared_new_with_alloc(&self->shared, self->cb_alloc, self->alloc_ud) < 0) return -1;
+    shared = self->shared;
+    self->did_setup = 1;
+    self->ready     = 0;
+
+    // the first display set up with the shared resources creates them
+    if (shared->setups++ == 0) shared->setup_rc = setup_shared(shared);
+    if (shared->setup_rc < 0) return shared->setup_rc;
+
+    // Set up the program for blur
+    self->blur = get_blur_program(shared, self->blur_sigma, self->blur_radius);
+    if (self->blur < 0) return -1;
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+#if HAVE_GPU_LINES && !DEBUG_TRIANGLES
+    // expand lines on the GPU if we can, otherwise fall back to tessellating them here
+    if (self->use_gpu_lines && !shared->tried_segment_program) {
+        shared->tried_segment_program = 1;
+        setup_segment_program(shared);
+    }
+    // count on the segment program linking; finish_setup falls back if it doesn't,
+    // and lines are tessellated here as well until then
+    self->gpu_lines = self->use_gpu_lines && (shared->segment_pending || shared->segment_program != 0);
+    self->gpu_lines_pending = self->gpu_lines && shared->segment_program == 0;
+#endif
+
+    if (self->beam_falloff > 0.0) setup_beam_programs(self);
+
+#if HAVE_MAP_BUFFER_RANGE
+    {
+        int major, minor, es;
+        self->map_buffers = vector_display_gl_version(&major, &minor, &es) && major >= 3;
+    }
+#endif
+
+    sync_recorders(self);
+
+    // create vertex and index buffers for fade
+    gen_history(self);
+
+    rc = vector_display_setup_res_dependent(self);
+    if (rc < 0) return rc;
+
+    return 0;
+}
+
+static int setup_programs_ready(vector_display_t *self) {
+    vector_display_shared_t *shared = self->shared;
+    if (!shared_programs_ready(shared)) return 0;
+    if (shared->blur_programs[self->blur].pending &&
+        !vector_display_program_ready(&shared->blur_programs[self->blur].build)) return 0;
+    if (self->gpu_lines && shared->segment_pending &&
+        !vector_display_program_ready(&shared->segment_build)) return 0;
+    if (self->beam_falloff > 0.0 &&
+        !(beam_program_ready(&shared->fb_beam) && beam_program_ready(&shared->segment_beam))) return 0;
+    return 1;
+}
+
+//
+// Finish the programs the display's setup started. Unless wait is set, this
+// returns VECTOR_DISPLAY_NOT_READY instead of waiting for the driver.
+//
+static int finish_setup(vector_display_t *self, int wait) {
+    vector_display_shared_t *shared = self->shared;
+    if (self->ready != 0) return self->ready > 0 ? 0 : -1;
+    if (self->blur < 0) {
+        // setup failed before it started them
+        self->ready = -1;
+        return -1;
+    }
+    if (!wait && !setup_programs_ready(self)) return VECTOR_DISPLAY_NOT_READY;
+
+    self->ready = -1;
+    if (finish_shared(shared) < 0) return -1;
+    if (finish_blur_program(shared, self->blur) < 0) return -1;
+#if HAVE_GPU_LINES && !DEBUG_TRIANGLES
+    if (self->gpu_lines) {
+        finish_segment_program(shared);
+        if (shared->segment_program == 0) {
+            // tessellate here after all; the history's buffers depend on it
+            delete_history(self);
+            self->gpu_lines = 0;
+            gen_history(self);
+        }
+        self->gpu_lines_pending = 0;
+        sync_recorders(self);
+    }
+#endif
+    // without them, lines are drawn with the line texture
+    if (self->beam_falloff > 0.0) finish_beam_programs(self);
+    self->ready = 1;
+    return 0;
+}
+
+int vector_display_poll_setup(vector_display_t *self) {
+    if (!self->did_setup) return -1;
+    return finish_setup(self, 0);
+}
+
+int vector_display_setup(vector_display_t *self) {
+    int rc = vector_display_setup_async(self);
+    if (rc < 0) return rc;
+    return finish_setup(self, 1);
+}
+
+int vector_display_setup_software(vector_display_t *self, int nthreads) {
+    unsigned char texbuf[TEXTURE_SIZE * TEXTURE_SIZE * 4];
+
+    if (self->owner != NULL || self->did_setup || self->soft != NULL) return -1;
+    fill_linetex(texbuf);
+    if (vector_display_soft_new(&self->soft, nthreads, texbuf, TEXTURE_SIZE, self->cb_alloc, self->alloc_ud) < 0) return -1;
+
+    // lines are tessellated here, into triangles for it
+    self->gpu_lines = 0;
+    sync_recorders(self);
+    return 0;
+}
+
+static void draw_batches(vector_display_t *self, GLuint vertexbuffer, GLuint indexbuffer, vertex_arrays_t *arrays, const batch_t *batches, int nbatches, const GLfloat *mvmat, float alpha) {
+    int b;
+    const beam_program_t *beam = beam_program(self, &self->shared->fb_beam);
+    if (nbatches == 0) return;
+    if (beam != NULL) {
+        use_program(self, beam->program);
+        set_uniform_matrix4(self, beam->uniform_modelview, mvmat);
+        set_uniform1f(self, beam->uniform_alpha, alpha);
+    } else {
+        use_program(self, self->shared->fb_program);
+        set_uniform_matrix4(self, self->shared->fb_uniform_modelview, mvmat);
+        set_uniform1f(self, self->shared->fb_uniform_alpha, alpha);
+    }
+#if HAVE_VERTEX_ARRAYS
+    if (self->shared->vertex_arrays) {
+        if (arrays->batches == 0) {
+            glGenVertexArrays(1, &arrays->batches);
+            bind_vertex_array(self, arrays->batches);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexbuffer);
+            glEnableVertexAttribArray(VERTEX_POS_INDEX);
+            glEnableVertexAttribArray(VERTEX_COLOR_INDEX);
+            glEnableVertexAttribArray(VERTEX_TEXCOORD_INDEX);
+            arrays->base_point = -1;
+        }
+        bind_vertex_array(self, arrays->batches);
+    } else
+#endif
+    {
+        // vertex array 0 is shared with everything else
+        bind_buffer(self, GL_ELEMENT_ARRAY_BUFFER, indexbuffer);
+        enable_attribs(self, (1u << VERTEX_POS_INDEX) | (1u << VERTEX_COLOR_INDEX) | (1u << VERTEX_TEXCOORD_INDEX));
+        self->gl.quad_attribs = GL_STATE_UNKNOWN;
+        arrays->base_point    = -1;
+    }
+
+    // ES2 has no base vertex, so rebase the attributes for each batch
+    for (b = 0; b < nbatches; b++) {
+        const batch_t *batch = &batches[b];
+        if (batch->first_point != arrays->base_point) {
+            char *base = (char*)(sizeof(point_t) * batch->first_point);
+            bind_buffer(self, GL_ARRAY_BUFFER, vertexbuffer);
+            glVertexAttribPointer(VERTEX_POS_INDEX,      2, GL_SHORT,          GL_FALSE, sizeof(point_t), base + offsetof(point_t, x));
+            glVertexAttribPointer(VERTEX_COLOR_INDEX,    4, GL_UNSIGNED_BYTE,  GL_TRUE,  sizeof(point_t), base + offsetof(point_t, r));
+            glVertexAttribPointer(VERTEX_TEXCOORD_INDEX, 2, GL_UNSIGNED_SHORT, GL_TRUE,  sizeof(point_t), base + offsetof(point_t, u));
+            arrays->base_point = batch->first_point;
+        }
+        glDrawElements(GL_TRIANGLES, batch->nindices, GL_UNSIGNED_SHORT, (void*)(sizeof(GLushort) * batch->first_index));
+    }
+}
+
+static void draw_list(vector_display_t *self, const list_draw_t *draw, float alpha) {
+    vector_display_list_t *list = draw->list;
+
+    // the list's fixed point positions, scaled and offset in framebuffer pixels
+    GLfloat list_mvmat[] = {
+        draw->scale/list->mesh.subpixels,0,0,0,
+        0,draw->scale/list->mesh.subpixels,0,0,
+        0,0,1.0f,0,
+        draw->offset_x,draw->offset_y,-70000.0f,1.0f
+    };
+
+    if (draws_triangles(self, &list->mesh))
+        draw_batches(self, list->vertexbuffer, list->indexbuffer, &list->arrays, list->mesh.batches, list->mesh.nbatches, list_mvmat, alpha);
+#if HAVE_GPU_LINES
+    if (self->gpu_lines) draw_segments(self, list->segmentbuffer, &list->arrays, list->mesh.nsegments, list_mvmat, alpha);
+#endif
+}
+
+//
+// Writes a frame into one of the history buffers. The GPU may still be
+// drawing the buffer's last frame, so its old contents are always discarded:
+// mapped with GL_MAP_INVALIDATE_BUFFER_BIT where buffers can be mapped, and
+// orphaned with glBufferData otherwise, so the driver can hand out fresh
+// memory instead of waiting. Storage only grows, geometrically, so its size
+// settles after a few frames.
+//
+#define MIN_STREAM_BYTES (16384)
+
+typedef struct {
+    GLenum target;
+    char  *map;                                 // NULL if writing with glBufferSubData
+    size_t offset;
+} stream_t;
+
+static void begin_stream(vector_display_t *self, stream_t *stream, GLenum target, GLuint buffer, size_t *capacity, size_t size) {
+    stream->target = target;
+    stream->map    = NULL;
+    stream->offset = 0;
+    bind_buffer(self, target, buffer);
+    if (*capacity < size) {
+        size_t newcapacity = max(*capacity, MIN_STREAM_BYTES);
+        while (newcapacity < size) newcapacity *= 2;
+        glBufferData(target, newcapacity, NULL, GL_DYNAMIC_DRAW);
+        *capacity = newcapacity;
+    } else if (!self->map_buffers && size > 0) {
+        glBufferData(target, *capacity, NULL, GL_DYNAMIC_DRAW);
+    }
+#if HAVE_MAP_BUFFER_RANGE
+    if (self->map_buffers && size > 0) {
+        stream->map = (char*)glMapBufferRange(target, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    }
+#endif
+}
+
+static void write_stream(stream_t *stream, const void *data, size_t size) {
+    if (size == 0) return;
+    if (stream->map != NULL) {
+        memcpy(stream->map + stream->offset, data, size);
+    } else {
+        glBufferSubData(stream->target, stream->offset, size, data);
+    }
+    stream->offset += size;
+}
+
+static void end_stream(stream_t *stream) {
+#if HAVE_MAP_BUFFER_RANGE
+    if (stream->map != NULL) glUnmapBuffer(stream->target);
+#endif
+}
+
+//
+// A mesh's points and segments with their positions in the given number of
+// subdivisions, which is the mesh's own unless it was recorded for the
+// display before it was resized. Converted copies are scratch memory.
+//
+static const point_t *points_in(vector_display_t *self, const mesh_t *mesh, int subpixels) {
+    point_t *points;
+    int      i;
+    if (mesh->subpixels == subpixels || mesh->npoints == 0) return mesh->points;
+    points = (point_t*)scratch_alloc(self, sizeof(point_t) * mesh->npoints);
+    for (i = 0; i < mesh->npoints; i++) {
+        points[i]   = mesh->points[i];
+        points[i].x = clamp_position(rescale_position(mesh->points[i].x, mesh->subpixels, subpixels));
+        points[i].y = clamp_position(rescale_position(mesh->points[i].y, mesh->subpixels, subpixels));
+    }
+    return points;
+}
+
+static const segment_t *segments_in(vector_display_t *self, const mesh_t *mesh, int subpixels) {
+    segment_t *segments;
+    int        i, from = mesh->subpixels;
+    if (from == subpixels || mesh->nsegments == 0) return mesh->segments;
+    segments = (segment_t*)scratch_alloc(self, sizeof(segment_t) * mesh->nsegments);
+    for (i = 0; i < mesh->nsegments; i++) {
+        const segment_t *ss = &mesh->segments[i];
+        segment_t       *ds = &segments[i];
+        *ds    = *ss;
+        ds->xp = clamp_position(rescale_position(ss->xp, from, subpixels));
+        ds->yp = clamp_position(rescale_position(ss->yp, from, subpixels));
+        ds->x0 = clamp_position(rescale_position(ss->x0, from, subpixels));
+        ds->y0 = clamp_position(rescale_position(ss->y0, from, subpixels));
+        ds->x1 = clamp_position(rescale_position(ss->x1, from, subpixels));
+        ds->y1 = clamp_position(rescale_position(ss->y1, from, subpixels));
+        ds->xn = clamp_position(rescale_position(ss->xn, from, subpixels));
+        ds->yn = clamp_position(rescale_position(ss->yn, from, subpixels));
+        ds->thickness = (GLushort)min(rescale_position(ss->thickness, from, subpixels), 0xffff);
+    }
+    return segments;
+}
+
+//
+// Upload the frame's geometry: the display's own, then each recorder's in the
+// order the recorders were created. Indices are relative to their batch, so
+// the meshes are uploaded back to back as they are, and only the batches are
+// moved.
+//
+static void upload_frame(vector_display_t *self, history_t *current) {
+    const mesh_t     *own = &self->mesh;
+    vector_display_t *recorder;
+    stream_t          points, indices, segments;
+    int npoints = 0, nindices = 0, nbatches = 0, nsegments = own->nsegments;
+    int i;
+
+    if (draws_triangles(self, own)) {
+        npoints  = own->npoints;
+        nindices = own->nindices;
+        nbatches = own->nbatches;
+    }
+    for (recorder = self->recorders; recorder != NULL; recorder = recorder->next_recorder) {
+        const mesh_t *mesh = recorded_mesh(recorder);
+        if (draws_triangles(self, mesh)) {
+            npoints  += mesh->npoints;
+            nindices += mesh->nindices;
+            nbatches += mesh->nbatches;
+        }
+        nsegments += mesh->nsegments;
+    }
+
+    begin_stream(self, &points,  GL_ARRAY_BUFFER,         current->vertexbuffer, &current->vertexbytes, sizeof(point_t) * npoints);
+    begin_stream(self, &indices, GL_ELEMENT_ARRAY_BUFFER, current->indexbuffer,  &current->indexbytes,  sizeof(GLushort) * nindices);
+    current->subpixels = own->subpixels;
+    grow_array(self, (void**)&current->batches, &current->cbatches, nbatches, sizeof(batch_t));
+    current->nbatches = 0;
+    if (draws_triangles(self, own)) {
+        write_stream(&points,  own->points,  sizeof(point_t)  * own->npoints);
+        write_stream(&indices, own->indices, sizeof(GLushort) * own->nindices);
+        if (own->nbatches > 0)
+            memcpy(current->batches, own->batches, sizeof(batch_t) * own->nbatches);
+        current->nbatches = own->nbatches;
+    }
+
+    for (recorder = self->recorders; recorder != NULL; recorder = recorder->next_recorder) {
+        const mesh_t *mesh        = recorded_mesh(recorder);
+        int           first_point = (int)(points.offset / sizeof(point_t));
+        int           first_index = (int)(indices.offset / sizeof(GLushort));
+        if (!draws_triangles(self, mesh)) continue;
+        write_stream(&points,  points_in(self, mesh, current->subpixels), sizeof(point_t) * mesh->npoints);
+        write_stream(&indices, mesh->indices, sizeof(GLushort) * mesh->nindices);
+        for (i = 0; i < mesh->nbatches; i++) {
+            batch_t *batch = &current->batches[current->nbatches++];
+            *batch = mesh->batches[i];
+            batch->first_point += first_point;
+            batch->first_index += first_index;
+        }
+    }
+    end_stream(&points);
+    end_stream(&indices);
+
+    current->nsegments = 0;
+    if (self->gpu_lines) {
+        begin_stream(self, &segments, GL_ARRAY_BUFFER, current->segmentbuffer, &current->segmentbytes, sizeof(segment_t) * nsegments);
+        write_stream(&segments, own->segments, sizeof(segment_t) * own->nsegments);
+        for (recorder = self->recorders; recorder != NULL; recorder = recorder->next_recorder) {
+            const mesh_t *mesh = recorded_mesh(recorder);
+            write_stream(&segments, segments_in(self, mesh, current->subpixels), sizeof(segment_t) * mesh->nsegments);
+        }
+        end_stream(&segments);
+        current->nsegments = nsegments;
+    }
+    scratch_reset(self);
+}
+
+static void upload_list(vector_display_t *self, vector_display_list_t *list) {
+    if (list->vertexbuffer == 0) glGenBuffers(1, &list->vertexbuffer);
+    if (list->indexbuffer  == 0) glGenBuffers(1, &list->indexbuffer);
+    bind_buffer(self, GL_ARRAY_BUFFER, list->vertexbuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(point_t) * list->mesh.npoints, list->mesh.points, GL_STATIC_DRAW);
+    bind_buffer(self, GL_ELEMENT_ARRAY_BUFFER, list->indexbuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * list->mesh.nindices, list->mesh.indices, GL_STATIC_DRAW);
+    if (self->gpu_lines) {
+        if (list->segmentbuffer == 0) glGenBuffers(1, &list->segmentbuffer);
+        bind_buffer(self, GL_ARRAY_BUFFER, list->segmentbuffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(segment_t) * list->mesh.nsegments, list->mesh.segments, GL_STATIC_DRAW);
+    }
+    list->uploaded = 1;
+}
+
+//
+// Free unused display lists, and upload the lists any step of the history
+// replays that have been recorded since they were last uploaded. A list may
+// be recorded again while earlier steps still replay it, and every step draws
+// its batches as they are now, so they all need its buffers as they are now.
+// The list being recorded is still growing, so it is uploaded every time.
+// Lists that are only ever appended never need buffers.
+//
+static void update_lists(vector_display_t *self) {
+    int i, j;
+    collect_lists(self);
+    if (self->recording != NULL) self->recording->uploaded = 0;
+    for (i = 0; i < self->steps; i++) {
+        const history_t *history = &self->history[i];
+        for (j = 0; j < history->nlist_draws; j++) {
+            vector_display_list_t *list = history->list_draws[j].list;
+            if (!list->uploaded) upload_list(self, list);
+        }
+    }
+}
+
+// maps the unit quad to the whole of the viewport, whatever its size
+static const GLfloat unit_projmat[] = {
+    2.0f, 0, 0, 0,
+    0, -2.0f, 0, 0,
+    0, 0, -2.0f/70001.0f, 0,
+    -1.0f,1.0f,-1.0f,1.0f
+};
+
+static void bind_unit_quad(vector_display_t *self) {
+    bind_quad(self, self->shared->unit_vertexbuffer, self->shared->unit_vertexarray);
+}
 
-    const char *blit_fragment_shader_text =
-    "#ifdef GL_ES                               \n"
-    "    precision mediump float;               \n"
-    "#endif                                     \n"
-    "    uniform sampler2D tex1;                \n"
-    "    varying vec2 TexCoord;                 \n"
-    "    uniform float alpha;                   \n"
-    "    uniform float mult;                    \n"
-    "                                           \n"
-    "    void main() {                          \n"
-    "        gl_FragColor = texture2D(tex1, TexCoord.st) * vec4(mult, mult, mult, alpha*mult);\n"
-    "    }                                      \n";
+//
+// Fade the accumulated frames and add the frame just drawn to fb_scene, then
+// add the faded frames to the scene. With F the new frame and H the earlier
+// ones:
+//
+//      scene = F + initial_decay * H
+//      H     = F + decay * H
+//
+// so a frame drawn k frames ago is weighted by initial_decay * decay^(k-1),
+// as in the history ring, at the same cost however long frames persist.
+//
+static void accumulate_frames(vector_display_t *self, const GLfloat *mvmat) {
+    int read = self->accum_read, write = 1 - read;
+
+    bind_unit_quad(self);
+
+    // fade the earlier frames into the other buffer
+    bind_framebuffer(self, self->fb_accum[write]);
+    set_blend(self, GL_FALSE);
+    use_program(self, self->shared->decay_program);
+    set_uniform_matrix4(self, self->shared->decay_uniform_projection, unit_projmat);
+    set_uniform_matrix4(self, self->shared->decay_uniform_modelview, mvmat);
+    set_uniform1f(self, self->shared->decay_uniform_decay, self->decay);
+    set_uniform1f(self, self->shared->decay_uniform_fade, self->accum_fade);
+    bind_texture(self, self->fb_accum_texid[read]);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    set_blend(self, GL_TRUE);
+
+    // add this frame to them
+    set_blend_equation(self, GL_FUNC_ADD, GL_FUNC_ADD);
+    set_blend_func(self, GL_ONE, GL_ONE);
+    use_program(self, self->shared->screen_program);
+    set_uniform_matrix4(self, self->shared->screen_uniform_projection, unit_projmat);
+    set_uniform_matrix4(self, self->shared->screen_uniform_modelview, mvmat);
+    set_uniform1f(self, self->shared->screen_uniform_alpha, 1.0);
+    set_uniform1f(self, self->shared->screen_uniform_mult, 1.0);
+    bind_texture(self, self->fb_scene_texid);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
 
-    const char *fb_vertex_shader_text =
-    "    uniform mat4 inProjectionMatrix;       \n"
-    "    uniform mat4 inModelViewMatrix;        \n"
-    "                                           \n"
-    "    attribute vec2 inTexCoord;             \n"
-    "    attribute vec4 inPosition;             \n"
-    "    attribute vec4 inColor;                \n"
-    "                                           \n"
-    "    varying vec4 Color;                    \n"
-    "    varying vec2 TexCoord;                 \n"
-    "                                           \n"
-    "    void main() {                          \n"
-    "        gl_Position = inProjectionMatrix * inModelViewMatrix * inPosition;\n"
-    "        Color       = inColor;             \n"
-    "        TexCoord    = inTexCoord;          \n"
-    "    }\n";
+    // and the earlier frames, as they were, to the scene
+    bind_framebuffer(self, self->fb_scene);
+    set_uniform1f(self, self->shared->screen_uniform_mult, self->initial_decay);
+    bind_texture(self, self->fb_accum_texid[read]);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
 
-    const char *fb_fragment_shader_text =
-    "#ifdef GL_ES                               \n"
-    "    precision mediump float;               \n"
-    "#endif                                     \n"
-    "                                           \n"
-    "    uniform sampler2D tex1;                \n"
-    "    uniform float alpha;                   \n"
-    "                                           \n"
-    "    varying vec4 Color;                    \n"
-    "    varying vec2 TexCoord;                 \n"
-    "                                           \n"
-    "    void main() {                          \n"
-    "        vec4 texColor = texture2D(tex1, TexCoord.st);\n"
-    "        gl_FragColor = Color * texColor * vec4(1.0, 1.0, 1.0, alpha);\n"
-    "    }                                      \n";
+    self->accum_read = write;
+}
 
-    const char *blur_fragment_shader_text =
-    "#ifdef GL_ES                               \n"
-    "    precision mediump float;               \n"
-    "#endif                                     \n"
-    "    uniform sampler2D tex1;                \n"
-    "    uniform vec2      scale;               \n"
-    "    varying vec2      TexCoord;            \n"
-    "    uniform float     alpha;               \n"
-    "    uniform float     mult;                \n"
-    "                                           \n"
-    "    void main() {                          \n"
-    "       vec4 color = vec4(0,0,0,0);         \n"
-    "       color += texture2D(tex1, vec2(TexCoord.x-4.0*scale.x, TexCoord.y-4.0*scale.y))*0.05;\n"
-    "       color += texture2D(tex1, vec2(TexCoord.x-3.0*scale.x, TexCoord.y-3.0*scale.y))*0.09;\n"
-    "       color += texture2D(tex1, vec2(TexCoord.x-2.0*scale.x, TexCoord.y-2.0*scale.y))*0.12;\n"
-    "       color += texture2D(tex1, vec2(TexCoord.x-1.0*scale.x, TexCoord.y-1.0*scale.y))*0.15;\n"
-    "       color += texture2D(tex1, vec2(TexCoord.x+0.0*scale.x, TexCoord.y+0.0*scale.y))*0.16;\n"
-    "       color += texture2D(tex1, vec2(TexCoord.x+1.0*scale.x, TexCoord.y+1.0*scale.y))*0.15;\n"
-    "       color += texture2D(tex1, vec2(TexCoord.x+2.0*scale.x, TexCoord.y+2.0*scale.y))*0.12;\n"
-    "       color += texture2D(tex1, vec2(TexCoord.x+3.0*scale.x, TexCoord.y+3.0*scale.y))*0.09;\n"
-    "       color += texture2D(tex1, vec2(TexCoord.x+4.0*scale.x, TexCoord.y+4.0*scale.y))*0.05;\n"
-    "       gl_FragColor = color * vec4(mult,mult,mult,alpha*mult);\n"
-    "    }                                      \n";
+//
+// Blur the scene into fb_glow1 with brightness*4 rounds of horizontal and
+// vertical blur at glow size.
+//
+static void blur_glow(vector_display_t *self, const GLfloat *mvmat) {
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
-    int rc;
-    GLuint vertex_shader;
-    GLuint fragment_shader;
+    set_blend_equation(self, GL_FUNC_ADD, GL_FUNC_ADD);
+    set_blend_func(self, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    self->did_setup = 1;
+    blur_program_t *blur = &self->shared->blur_programs[self->blur];
+    use_program(self, blur->program);
+    set_uniform_matrix4(self, blur->uniform_projection, unit_projmat);
+    set_uniform_matrix4(self, blur->uniform_modelview, mvmat);
 
-    // Set up the program for the framebuffer
-    vertex_shader   = vector_display_load_shader(GL_VERTEX_SHADER,   fb_vertex_shader_text);
-    if (vertex_shader   == 0) return -1;
-    fragment_shader = vector_display_load_shader(GL_FRAGMENT_SHADER, fb_fragment_shader_text);
-    if (fragment_shader == 0) return -1;
-    self->fb_program = glCreateProgram();
-    if(self->fb_program == 0) return -1;
-    glAttachShader(self->fb_program, vertex_shader);
-    glAttachShader(self->fb_program, fragment_shader);
-    glBindAttribLocation(self->fb_program, VERTEX_COLOR_INDEX, "inColor");
-    glBindAttribLocation(self->fb_program, VERTEX_POS_INDEX,   "inPosition");
-    glBindAttribLocation(self->fb_program, VERTEX_TEXCOORD_INDEX, "inTexCoord");
-    glLinkProgram(self->fb_program);
-    rc = vector_display_check_program_link(self->fb_program);
-    if (rc < 0) return rc;
-    self->fb_uniform_modelview  = glGetUniformLocation(self->fb_program, "inModelViewMatrix");
-    self->fb_uniform_projection = glGetUniformLocation(self->fb_program, "inProjectionMatrix");
-    self->fb_uniform_alpha      = glGetUniformLocation(self->fb_program, "alpha");
-
-    // Set up the program for the screen
-    vertex_shader   = vector_display_load_shader(GL_VERTEX_SHADER,   nocolor_vertex_shader_text);
-    if (vertex_shader   == 0) return -1;
-    fragment_shader = vector_display_load_shader(GL_FRAGMENT_SHADER, blit_fragment_shader_text);
-    if (fragment_shader == 0) return -1;
-    self->screen_program = glCreateProgram();
-    if(self->screen_program == 0) return -1;
-    glAttachShader(self->screen_program, vertex_shader);
-    glAttachShader(self->screen_program, fragment_shader);
-    glBindAttribLocation(self->screen_program, VERTEX_POS_INDEX,   "inPosition");
-    glBindAttribLocation(self->screen_program, VERTEX_TEXCOORD_INDEX, "inTexCoord");
-    glLinkProgram(self->screen_program);
-    rc = vector_display_check_program_link(self->screen_program);
-    if (rc < 0) return rc;
-    self->screen_uniform_modelview  = glGetUniformLocation(self->screen_program, "inModelViewMatrix");
-    self->screen_uniform_projection = glGetUniformLocation(self->screen_program, "inProjectionMatrix");
-    self->screen_uniform_alpha      = glGetUniformLocation(self->screen_program, "alpha");
-    self->screen_uniform_mult       = glGetUniformLocation(self->screen_program, "mult");
+    bind_unit_quad(self);
 
-    // Set up the program for blur
-    vertex_shader   = vector_display_load_shader(GL_VERTEX_SHADER,   nocolor_vertex_shader_text);
-    if (vertex_shader   == 0) return -1;
-    fragment_shader = vector_display_load_shader(GL_FRAGMENT_SHADER, blur_fragment_shader_text);
-    if (fragment_shader == 0) return -1;
-    self->blur_program = glCreateProgram();
-    if(self->blur_program == 0) return -1;
-    glAttachShader(self->blur_program, vertex_shader);
-    glAttachShader(self->blur_program, fragment_shader);
-    glBindAttribLocation(self->blur_program, VERTEX_POS_INDEX,   "inPosition");
-    glBindAttribLocation(self->blur_program, VERTEX_TEXCOORD_INDEX, "inTexCoord");
-    glLinkProgram(self->blur_program);
-    rc = vector_display_check_program_link(self->blur_program);
-    if (rc < 0) return rc;
-    self->blur_uniform_modelview  = glGetUniformLocation(self->blur_program, "inModelViewMatrix");
-    self->blur_uniform_projection = glGetUniformLocation(self->blur_program, "inProjectionMatrix");
-    self->blur_uniform_scale      = glGetUniformLocation(self->blur_program, "scale");
-    self->blur_uniform_alpha      = glGetUniformLocation(self->blur_program, "alpha");
-    self->blur_uniform_mult       = glGetUniformLocation(self->blur_program, "mult");
+    double glow_iter_mult = 1.05 + ((self->brightness - 1.0) / 5.0);
 
-    // generate the line texture
-    gen_linetex(self);
+    set_uniform1f(self, blur->uniform_alpha, 1.0);
+    set_uniform1f(self, blur->uniform_mult, glow_iter_mult);
 
-    // generate vertex buffers for the blits
-    glGenBuffers(1, &self->glow2glow_vertexbuffer);
-    glGenBuffers(1, &self->screen2screen_vertexbuffer);
-    glGenBuffers(1, &self->screen2glow_vertexbuffer);
-    glGenBuffers(1, &self->glow2screen_vertexbuffer);
+    set_viewport(self, 0, 0, self->glow_width, self->glow_height);
 
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    bind_texture(self, self->fb_scene_texid);
 
-    // create vertex buffers for fade
-    glGenBuffers(self->steps, self->buffers);
+    int npasses = (int)(self->brightness*4);
+    int pass;
+    for (pass = 0; pass < npasses; pass++) {
+        // render the glow1 texture to the glow0 buffer with horizontal blur
+        bind_framebuffer(self, self->fb_glow0);
+        glClear(GL_COLOR_BUFFER_BIT);
+        set_uniform2f(self, blur->uniform_scale, 1.0/self->glow_width, 0.0);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        bind_texture(self, self->fb_glow0_texid);
 
-    rc = vector_display_setup_res_dependent(self);
-    if (rc < 0) return rc;
+        set_uniform1f(self, blur->uniform_alpha, 1.0);
+        set_uniform1f(self, blur->uniform_mult, glow_iter_mult);
 
-    return 0;
+        // render the glow0 texture to the glow1 buffer with vertical blur
+        bind_framebuffer(self, self->fb_glow1);
+        glClear(GL_COLOR_BUFFER_BIT);
+        set_uniform2f(self, blur->uniform_scale, 0, 1.0/self->glow_height);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        bind_texture(self, self->fb_glow1_texid);
+    }
 }
 
-int vector_display_update(vector_display_t *self) {
-    if (!self->did_setup) return -1;
+//
+// Glow through the bloom chain, with a dual filter: the scene is filtered down
+// through each halved level in turn, then each level is filtered up and added,
+// scaled by its weight, to the level above it. Each pass takes 5 or 8 reads at
+// a quarter of the pixels of the one before, so the glow widens with each
+// level for a small, nearly constant cost. Level 0 is left holding the glow.
+//
+static void bloom_glow(vector_display_t *self, const GLfloat *mvmat) {
+    int i;
 
-    GLfloat glow_projmat[] = {
-        2.0f/self->glow_width, 0, 0, 0,
-        0, -2.0f/self->glow_height, 0, 0,
-        0, 0, -2.0f/70001.0f, 0,
-        -1.0f,1.0f,-1.0f,1.0f
-    };
+    bind_unit_quad(self);
+
+    // filter down, replacing what the levels held
+    set_blend(self, GL_FALSE);
+    use_program(self, self->shared->bloom_down_program);
+    set_uniform_matrix4(self, self->shared->bloom_down_uniform_projection, unit_projmat);
+    set_uniform_matrix4(self, self->shared->bloom_down_uniform_modelview, mvmat);
+    bind_texture(self, self->fb_scene_texid);
+    for (i = 0; i < self->bloom_levels; i++) {
+        bind_framebuffer(self, self->fb_bloom[i]);
+        set_viewport(self, 0, 0, self->bloom_width[i], self->bloom_height[i]);
+        set_uniform2f(self, self->shared->bloom_down_uniform_halfpixel, 0.5 / self->bloom_width[i], 0.5 / self->bloom_height[i]);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        bind_texture(self, self->fb_bloom_texid[i]);
+    }
+    set_blend(self, GL_TRUE);
+
+    // filter up, adding to what the levels hold
+    set_blend_equation(self, GL_FUNC_ADD, GL_FUNC_ADD);
+    set_blend_func(self, GL_ONE, GL_ONE);
+    use_program(self, self->shared->bloom_up_program);
+    set_uniform_matrix4(self, self->shared->bloom_up_uniform_projection, unit_projmat);
+    set_uniform_matrix4(self, self->shared->bloom_up_uniform_modelview, mvmat);
+    for (i = self->bloom_levels - 1; i > 0; i--) {
+        bind_framebuffer(self, self->fb_bloom[i-1]);
+        set_viewport(self, 0, 0, self->bloom_width[i-1], self->bloom_height[i-1]);
+        set_uniform2f(self, self->shared->bloom_up_uniform_halfpixel, 0.5 / self->bloom_width[i], 0.5 / self->bloom_height[i]);
+        set_uniform1f(self, self->shared->bloom_up_uniform_mult, self->bloom_weights[i]);
+        bind_texture(self, self->fb_bloom_texid[i]);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+}
+
+//
+// Filtering keeps the total brightness of a level, so level 0 ends up with
+// each level's brightness times the product of its weight and those of the
+// levels between them and level 0.
+//
+static double bloom_gain(vector_display_t *self) {
+    double gain = 1.0, product = 1.0;
+    int i;
+    for (i = 1; i < self->bloom_levels; i++) {
+        product *= self->bloom_weights[i];
+        gain    += product;
+    }
+    return gain;
+}
+
+//
+// Filter the glow left by bloom_glow up to the bound framebuffer, with the
+// blending already set up.
+//
+static void draw_bloom(vector_display_t *self, const GLfloat *mvmat, double mult) {
+    bind_unit_quad(self);
+    use_program(self, self->shared->bloom_up_program);
+    set_uniform_matrix4(self, self->shared->bloom_up_uniform_projection, unit_projmat);
+    set_uniform_matrix4(self, self->shared->bloom_up_uniform_modelview, mvmat);
+    set_uniform2f(self, self->shared->bloom_up_uniform_halfpixel, 0.5 / self->bloom_width[0], 0.5 / self->bloom_height[0]);
+    set_uniform1f(self, self->shared->bloom_up_uniform_mult, mult);
+    bind_texture(self, self->fb_bloom_texid[0]);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
 
+//
+// Draw the scene into fb_scene and its glow into the glow framebuffers.
+//
+static void draw_scene(vector_display_t *self, const GLfloat *mvmat) {
     GLfloat projmat[] = {
         2.0f/self->width, 0, 0, 0,
         0, -2.0f/self->height, 0, 0,
@@ -885,48 +3607,75 @@ int vector_display_update(vector_display_t *self) {
         -1.0f,1.0f,-1.0f,1.0f
     };
 
-    GLfloat mvmat[] = {
+    // same as mvmat, but also converts fixed point line positions to pixels,
+    // with the subdivisions of each step
+    GLfloat fb_mvmat[] = {
         1.0f,0,0,0,
         0,1.0f,0,0,
         0,0,1.0f,0,
         0,0,-70000.0f,1.0f
     };
 
-    // save the framebuffer for the final draw
-    GLuint drawbuffer;
-    glGetIntegerv(GL_FRAMEBUFFER_BINDING, (GLint*)&drawbuffer);
+    // uploads bind index buffers, which belong to the bound vertex array
+    if (self->shared->vertex_arrays) bind_vertex_array(self, 0);
 
     // bind the framebuffer used for rendering the scene
-    glBindFramebuffer(GL_FRAMEBUFFER, self->fb_scene);
-    glViewport(0, 0, self->width, self->height);
+    bind_framebuffer(self, self->fb_scene);
+    set_viewport(self, 0, 0, self->width, self->height);
 
     // set up opengl options
     glEnable(GL_CULL_FACE);
     glDisable(GL_STENCIL_TEST);
-    glEnable(GL_BLEND);
-    glBlendEquationSeparate(GL_FUNC_ADD, GL_MAX_EXT);
-    glBlendFunc(GL_SRC_ALPHA, GL_DST_ALPHA);
+    set_blend(self, GL_TRUE);
+    set_blend_equation(self, GL_FUNC_ADD, GL_MAX_EXT);
+    set_blend_func(self, GL_SRC_ALPHA, GL_DST_ALPHA);
 
     // clear the framebuffer
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 
     // setup shaders
-    glUseProgram(self->fb_program);
-    glUniformMatrix4fv(self->fb_uniform_projection, 1, GL_FALSE, projmat);
-    glUniformMatrix4fv(self->fb_uniform_modelview, 1, GL_FALSE, mvmat);
-    glUniform1f(self->fb_uniform_alpha, 1.0f);
+    const beam_program_t *beam = beam_program(self, &self->shared->fb_beam);
+    if (beam != NULL) {
+        use_program(self, beam->program);
+        set_uniform_matrix4(self, beam->uniform_projection, projmat);
+        set_uniform1f(self, beam->uniform_falloff, self->beam_falloff);
+    } else {
+        use_program(self, self->shared->fb_program);
+        set_uniform_matrix4(self, self->shared->fb_uniform_projection, projmat);
+    }
+#if HAVE_GPU_LINES
+    if (self->gpu_lines) {
+        if ((beam = beam_program(self, &self->shared->segment_beam)) != NULL) {
+            use_program(self, beam->program);
+            set_uniform_matrix4(self, beam->uniform_projection, projmat);
+            set_uniform1f(self, beam->uniform_falloff, self->beam_falloff);
+        } else {
+            use_program(self, self->shared->segment_program);
+            set_uniform_matrix4(self, self->shared->segment_uniform_projection, projmat);
+        }
+    }
+#endif
 
-    // bind the line texture
-    glBindTexture(GL_TEXTURE_2D, self->linetexid);
+    // bind the line texture, which the beam programs don't read
+    bind_texture(self, self->shared->linetexid);
 
     // advance step
     self->step = (self->step + 1) % self->steps;
 
-    // populate vertex buffer for the current step from the vector data
-    glBindBuffer(GL_ARRAY_BUFFER, self->buffers[self->step]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(point_t) * self->npoints, self->points, GL_STATIC_DRAW);
-    self->buffernpoints[self->step] = (GLuint)self->npoints;
+    // populate vertex and index buffers for the current step from the vector data
+    history_t *current = &self->history[self->step];
+    take_frames(self);
+    upload_frame(self, current);
+
+    // the current step also replays this frame's display lists
+    release_list_draws(current->list_draws, current->nlist_draws);
+    grow_array(self, (void**)&current->list_draws, &current->clist_draws, self->nlist_draws, sizeof(list_draw_t));
+    if (self->nlist_draws > 0)
+        memcpy(current->list_draws, self->list_draws, sizeof(list_draw_t) * self->nlist_draws);
+    current->nlist_draws = self->nlist_draws;
+    retain_list_draws(current->list_draws, current->nlist_draws);
+    update_lists(self);
 
     // draw
     int loopvar;
@@ -936,7 +3685,8 @@ int vector_display_update(vector_display_t *self) {
         int i = (self->step + self->steps - stepi) % self->steps;
         //vector_display_debugf("render buffer %d/%d i = %d", stepi, self->steps, i);
 
-        if (self->buffernpoints[i] == 0) {
+        history_t *history = &self->history[i];
+        if (history->nbatches == 0 && history->nsegments == 0 && history->nlist_draws == 0) {
             //vector_display_debugf("skip buffer %d", stepi);
         } else {
             float alpha;
@@ -948,134 +3698,337 @@ int vector_display_update(vector_display_t *self) {
                 alpha = pow(self->decay, stepi-1) * self->initial_decay;
             }
 
-            glUniform1f(self->fb_uniform_alpha, alpha);
-            glBindBuffer(GL_ARRAY_BUFFER, self->buffers[i]);
-            glVertexAttribPointer(VERTEX_POS_INDEX,   3, GL_FLOAT, GL_TRUE,  sizeof(point_t), 0);
-            glVertexAttribPointer(VERTEX_COLOR_INDEX, 4, GL_FLOAT, GL_FALSE, sizeof(point_t), (void*)(3 * sizeof(float)));
-            glVertexAttribPointer(VERTEX_TEXCOORD_INDEX, 2, GL_FLOAT, GL_TRUE, sizeof(point_t), (void*)(7 * sizeof(float)));
-            glEnableVertexAttribArray(VERTEX_POS_INDEX);
-            glEnableVertexAttribArray(VERTEX_COLOR_INDEX);
-            glEnableVertexAttribArray(VERTEX_TEXCOORD_INDEX);
-            glDrawArrays(GL_TRIANGLES, 0, self->buffernpoints[i]);
+            fb_mvmat[0] = fb_mvmat[5] = 1.0f/history->subpixels;
+            draw_batches(self, history->vertexbuffer, history->indexbuffer, &history->arrays, history->batches, history->nbatches, fb_mvmat, alpha);
+#if HAVE_GPU_LINES
+            draw_segments(self, history->segmentbuffer, &history->arrays, history->nsegments, fb_mvmat, alpha);
+#endif
+            int j;
+            for (j = 0; j < history->nlist_draws; j++) {
+                draw_list(self, &history->list_draws[j], alpha);
+            }
         }
     }
 
+    if (self->accumulate) accumulate_frames(self, mvmat);
+
     //
-    // setup for glow post-processing
+    // glow post-processing
     //
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    if (self->bloom_levels > 0) {
+        if (self->brightness > 0) bloom_glow(self, mvmat);
+    } else {
+        blur_glow(self, mvmat);
+    }
+}
 
-    glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+//
+// Blend the glow into the bound framebuffer, with the blending already set up.
+//
+static void draw_glow(vector_display_t *self, const GLfloat *mvmat) {
+    double glow_fin_mult = 1.25 + ((self->brightness - 1.0) / 2.0);
 
-    glUseProgram(self->blur_program);
-    glUniformMatrix4fv(self->blur_uniform_projection, 1, GL_FALSE, glow_projmat);
-    glUniformMatrix4fv(self->blur_uniform_modelview, 1, GL_FALSE, mvmat);
+    if (self->brightness <= 0) return;
+    if (self->bloom_levels > 0) {
+        // upsampling it once more
+        draw_bloom(self, mvmat, glow_fin_mult * self->bloom_weights[0] / bloom_gain(self));
+    } else {
+        bind_unit_quad(self);
+        use_program(self, self->shared->screen_program);
+        set_uniform_matrix4(self, self->shared->screen_uniform_projection, unit_projmat);
+        set_uniform_matrix4(self, self->shared->screen_uniform_modelview, mvmat);
+        set_uniform1f(self, self->shared->screen_uniform_alpha, 1.0);
+        set_uniform1f(self, self->shared->screen_uniform_mult, glow_fin_mult);
+        bind_texture(self, self->fb_glow1_texid);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, self->screen2glow_vertexbuffer);
-    glVertexAttribPointer(VERTEX_POS_INDEX,   3, GL_FLOAT, GL_TRUE,  sizeof(nocolor_point_t), 0);
-    glVertexAttribPointer(VERTEX_TEXCOORD_INDEX, 2, GL_FLOAT, GL_TRUE, sizeof(nocolor_point_t), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(VERTEX_POS_INDEX);
-    glEnableVertexAttribArray(VERTEX_TEXCOORD_INDEX);
+//
+// Keep the frame's geometry in the current step of the history, laid out as
+// upload_frame lays it out in buffers.
+//
+static void append_mesh(vector_display_t *self, mesh_t *dst, const mesh_t *src) {
+    int i;
+    if (src->npoints > 0)
+        memcpy(dst->points + dst->npoints, points_in(self, src, dst->subpixels), sizeof(point_t) * src->npoints);
+    if (src->nindices > 0)
+        memcpy(dst->indices + dst->nindices, src->indices, sizeof(GLushort) * src->nindices);
+    for (i = 0; i < src->nbatches; i++) {
+        batch_t *batch = &dst->batches[dst->nbatches++];
+        *batch = src->batches[i];
+        batch->first_point += dst->npoints;
+        batch->first_index += dst->nindices;
+    }
+    dst->npoints  += src->npoints;
+    dst->nindices += src->nindices;
+}
 
-    double glow_iter_mult = 1.05 + ((self->brightness - 1.0) / 5.0);
-    double glow_fin_mult  = 1.25 + ((self->brightness - 1.0) / 2.0);
+static void copy_frame(vector_display_t *self, history_t *current) {
+    mesh_t           *mesh = &current->mesh;
+    vector_display_t *recorder;
+    int npoints = self->mesh.npoints, nindices = self->mesh.nindices, nbatches = self->mesh.nbatches;
+
+    for (recorder = self->recorders; recorder != NULL; recorder = recorder->next_recorder) {
+        npoints  += recorded_mesh(recorder)->npoints;
+        nindices += recorded_mesh(recorder)->nindices;
+        nbatches += recorded_mesh(recorder)->nbatches;
+    }
+    ensure_points(self, mesh, npoints);
+    ensure_indices(self, mesh, nindices);
+    ensure_batches(self, mesh, nbatches);
+    mesh->npoints = mesh->nindices = mesh->nbatches = 0;
+    mesh->subpixels = self->mesh.subpixels;
+
+    append_mesh(self, mesh, &self->mesh);
+    for (recorder = self->recorders; recorder != NULL; recorder = recorder->next_recorder) {
+        append_mesh(self, mesh, recorded_mesh(recorder));
+    }
+    scratch_reset(self);
+}
+
+//
+// Hand a mesh's triangles to the software renderer, with its fixed point
+// positions scaled and offset into pixels and its alpha faded.
+//
+static int add_soft_triangles(vector_display_t *self, const mesh_t *mesh, float scale, float offset_x, float offset_y, float alpha) {
+    int i, j, k;
+    for (i = 0; i < mesh->nbatches; i++) {
+        const batch_t  *batch   = &mesh->batches[i];
+        const point_t  *points  = mesh->points + batch->first_point;
+        const GLushort *indices = mesh->indices + batch->first_index;
+        int ntriangles = batch->nindices / 3;
+        vector_display_soft_triangle_t *t = vector_display_soft_add_triangles(self->soft, ntriangles);
+        if (t == NULL) return -1;
+        for (j = 0; j < ntriangles; j++, t++) {
+            for (k = 0; k < 3; k++) {
+                const point_t *p = &points[indices[3*j + k]];
+                t->x[k] = p->x * scale + offset_x;
+                t->y[k] = p->y * scale + offset_y;
+                t->r[k] = p->r / 255.0f;
+                t->g[k] = p->g / 255.0f;
+                t->b[k] = p->b / 255.0f;
+                t->a[k] = p->a / 255.0f * alpha;
+                t->u[k] = p->u / 65535.0f;
+                t->v[k] = p->v / 65535.0f;
+            }
+        }
+    }
+    return 0;
+}
 
-    glUniform1f(self->blur_uniform_alpha, 1.0);
-    glUniform1f(self->blur_uniform_mult, glow_iter_mult);
+//
+// Update a display set up with vector_display_setup_software: the history
+// is kept and faded as draw_scene keeps and fades it, and the rest is up to
+// the software renderer.
+//
+static int update_software(vector_display_t *self) {
+    vector_display_soft_frame_t frame;
+    double blur_weights[VECTOR_DISPLAY_MAX_BLUR_RADIUS + 1];
+    int rc = 0, loopvar, i, j;
 
-    glViewport(0, 0, self->glow_width, self->glow_height);
+    // advance step
+    self->step = (self->step + 1) % self->steps;
 
-    glBindTexture(GL_TEXTURE_2D, self->fb_scene_texid);
+    history_t *current = &self->history[self->step];
+    take_frames(self);
+    copy_frame(self, current);
 
-    int npasses = (int)(self->brightness*4);
-    int pass;
-    for (pass = 0; pass < npasses; pass++) {
-        // render the glow1 texture to the glow0 buffer with horizontal blur
-        glBindFramebuffer(GL_FRAMEBUFFER, self->fb_glow0);
-        glClear(GL_COLOR_BUFFER_BIT);
-        glUniform2f(self->blur_uniform_scale, 1.0/self->glow_width, 0.0);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindTexture(GL_TEXTURE_2D, self->fb_glow0_texid);
+    // the current step also replays this frame's display lists
+    release_list_draws(current->list_draws, current->nlist_draws);
+    grow_array(self, (void**)&current->list_draws, &current->clist_draws, self->nlist_draws, sizeof(list_draw_t));
+    if (self->nlist_draws > 0)
+        memcpy(current->list_draws, self->list_draws, sizeof(list_draw_t) * self->nlist_draws);
+    current->nlist_draws = self->nlist_draws;
+    retain_list_draws(current->list_draws, current->nlist_draws);
+    collect_lists(self);
 
-        glBindBuffer(GL_ARRAY_BUFFER, self->glow2glow_vertexbuffer);
-        glVertexAttribPointer(VERTEX_POS_INDEX,   3, GL_FLOAT, GL_TRUE,  sizeof(nocolor_point_t), 0);
-        glVertexAttribPointer(VERTEX_TEXCOORD_INDEX, 2, GL_FLOAT, GL_TRUE, sizeof(nocolor_point_t), (void*)(3 * sizeof(float)));
-        glEnableVertexAttribArray(VERTEX_POS_INDEX);
-        glEnableVertexAttribArray(VERTEX_TEXCOORD_INDEX);
-        glUniform1f(self->blur_uniform_alpha, 1.0);
-        glUniform1f(self->blur_uniform_mult, glow_iter_mult);
+    for (loopvar = 0; loopvar < self->steps && rc == 0; loopvar++) {
+        int stepi = self->steps - loopvar - 1;
+        history_t *history = &self->history[(self->step + self->steps - stepi) % self->steps];
+        float alpha;
+        if (stepi == 0) {
+            alpha = 1.0f;
+        } else if (stepi == 1) {
+            alpha = self->initial_decay;
+        } else {
+            alpha = pow(self->decay, stepi-1) * self->initial_decay;
+        }
 
-        // render the glow0 texture to the glow1 buffer with vertical blur
-        glBindFramebuffer(GL_FRAMEBUFFER, self->fb_glow1);
-        glClear(GL_COLOR_BUFFER_BIT);
-        glUniform2f(self->blur_uniform_scale, 0, 1.0/self->glow_height);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindTexture(GL_TEXTURE_2D, self->fb_glow1_texid);
+        rc = add_soft_triangles(self, &history->mesh, 1.0f/history->mesh.subpixels, 0.0f, 0.0f, alpha);
+        for (j = 0; j < history->nlist_draws && rc == 0; j++) {
+            const list_draw_t *draw = &history->list_draws[j];
+            rc = add_soft_triangles(self, &draw->list->mesh, draw->scale/draw->list->mesh.subpixels, draw->offset_x, draw->offset_y, alpha);
+        }
+    }
+
+    frame.width         = self->width;
+    frame.height        = self->height;
+    frame.glow_width    = self->glow_width;
+    frame.glow_height   = self->glow_height;
+    frame.beam_falloff  = self->beam_falloff;
+    frame.accumulate    = self->accumulate;
+    frame.decay         = self->decay;
+    frame.initial_decay = self->initial_decay;
+    frame.brightness    = self->brightness;
+    frame.blur_radius   = self->blur_radius;
+    frame.blur_weights  = blur_weights;
+    blur_kernel_weights(self->blur_sigma, self->blur_radius, blur_weights);
+    frame.bloom_levels  = self->bloom_levels;
+    size_bloom(self);
+    for (i = 0; i < self->bloom_levels; i++) {
+        frame.bloom_width[i]  = self->bloom_width[i];
+        frame.bloom_height[i] = self->bloom_height[i];
     }
+    frame.bloom_weights = self->bloom_weights;
+    frame.bloom_gain    = bloom_gain(self);
+
+    // rendered even if it lost triangles, which forgets the rest
+    if (vector_display_soft_render(self->soft, &frame) < 0) rc = -1;
+    return rc;
+}
+
+int vector_display_get_pixels(vector_display_t *self, const unsigned char **out_pixels, int *out_stride) {
+    if (self->soft == NULL) return -1;
+    *out_pixels = vector_display_soft_pixels(self->soft, out_stride);
+    return *out_pixels != NULL ? 0 : -1;
+}
+
+static const GLfloat update_mvmat[] = {
+    1.0f,0,0,0,
+    0,1.0f,0,0,
+    0,0,1.0f,0,
+    0,0,-70000.0f,1.0f
+};
+
+int vector_display_update(vector_display_t *self) {
+    if (self->soft != NULL) return update_software(self);
+
+    // draw to the bound framebuffer
+    GLuint drawbuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, (GLint*)&drawbuffer);
+    return vector_display_update_framebuffer(self, drawbuffer, 0, 0, self->width, self->height);
+}
+
+int vector_display_update_framebuffer(vector_display_t *self, unsigned int framebuffer,
+                                      int x, int y, int width, int height) {
+    int rc = vector_display_poll_setup(self);
+    if (rc != 0) return rc;
+
+    reset_gl_state(self, GL_STATE_UNKNOWN);
+    draw_scene(self, update_mvmat);
 
     //
-    // render scene + glow1 to the screen
+    // render scene + glow1 to the framebuffer
     //
-    glBindFramebuffer(GL_FRAMEBUFFER, drawbuffer);
-    glViewport(0, 0, self->width, self->height);
+    bind_framebuffer(self, framebuffer);
+    set_viewport(self, x, y, width, height);
+
+    // paint the scene, replacing what was there; its alpha is 1 everywhere
+    set_blend(self, GL_FALSE);
+    bind_unit_quad(self);
+    use_program(self, self->shared->screen_program);
+    set_uniform_matrix4(self, self->shared->screen_uniform_projection, unit_projmat);
+    set_uniform_matrix4(self, self->shared->screen_uniform_modelview, update_mvmat);
+    set_uniform1f(self, self->shared->screen_uniform_alpha, 1.0);
+    set_uniform1f(self, self->shared->screen_uniform_mult, 1.0);
+    bind_texture(self, self->fb_scene_texid);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
 
-    // clear the screen
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    // blend in the glow
+    set_blend(self, GL_TRUE);
+    set_blend_equation(self, GL_FUNC_ADD, GL_FUNC_ADD);
+    set_blend_func(self, GL_ONE, GL_ONE);
+    draw_glow(self, update_mvmat);
 
-    // setup shaders
-    glUseProgram(self->screen_program);
-    glUniformMatrix4fv(self->screen_uniform_projection, 1, GL_FALSE, projmat);
-    glUniformMatrix4fv(self->screen_uniform_modelview, 1, GL_FALSE, mvmat);
+    if (self->shared->vertex_arrays) bind_vertex_array(self, 0);
 
-    // set up blending for the final compositing
-    glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
-    glBlendFunc(GL_ONE, GL_ONE);
+    return 0;
+}
 
-    // set up the vertex buffer
-    glBindBuffer(GL_ARRAY_BUFFER, self->screen2screen_vertexbuffer);
-    glVertexAttribPointer(VERTEX_POS_INDEX,   3, GL_FLOAT, GL_TRUE,  sizeof(nocolor_point_t), 0);
-    glVertexAttribPointer(VERTEX_TEXCOORD_INDEX, 2, GL_FLOAT, GL_TRUE, sizeof(nocolor_point_t), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(VERTEX_POS_INDEX);
-    glEnableVertexAttribArray(VERTEX_TEXCOORD_INDEX);
+int vector_display_update_texture(vector_display_t *self, unsigned int *out_texture) {
+    int rc = vector_display_poll_setup(self);
+    if (rc != 0) return rc;
 
-    // paint the scene
-    glUniform1f(self->screen_uniform_alpha, 1.0);
-    glUniform1f(self->screen_uniform_mult, 1.0);
-    glBindTexture(GL_TEXTURE_2D, self->fb_scene_texid);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    reset_gl_state(self, GL_STATE_UNKNOWN);
+    draw_scene(self, update_mvmat);
 
-    // set up the vertex buffer
-    glBindBuffer(GL_ARRAY_BUFFER, self->glow2screen_vertexbuffer);
-    glVertexAttribPointer(VERTEX_POS_INDEX,   3, GL_FLOAT, GL_TRUE,  sizeof(nocolor_point_t), 0);
-    glVertexAttribPointer(VERTEX_TEXCOORD_INDEX, 2, GL_FLOAT, GL_TRUE, sizeof(nocolor_point_t), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(VERTEX_POS_INDEX);
-    glEnableVertexAttribArray(VERTEX_TEXCOORD_INDEX);
+    // the glow has been made from the scene, so it can go on top of it
+    bind_framebuffer(self, self->fb_scene);
+    set_viewport(self, 0, 0, self->width, self->height);
+    set_blend(self, GL_TRUE);
+    set_blend_equation(self, GL_FUNC_ADD, GL_FUNC_ADD);
+    set_blend_func(self, GL_ONE, GL_ONE);
+    draw_glow(self, update_mvmat);
 
-    if (self->brightness > 0) {
-        // blend in the glow
-        glUniform1f(self->screen_uniform_mult, glow_fin_mult);
-        glBindTexture(GL_TEXTURE_2D, self->fb_glow1_texid);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-    }
+    if (self->shared->vertex_arrays) bind_vertex_array(self, 0);
 
+    *out_texture = self->fb_scene_texid;
     return 0;
 }
 
+static void teardown_shared(vector_display_shared_t *shared) {
+    // programs still being built are finished, so that they can be deleted
+    finish_shared(shared);
+#if HAVE_GPU_LINES
+    finish_segment_program(shared);
+#endif
+    delete_beam_program(&shared->fb_beam);
+    delete_beam_program(&shared->segment_beam);
+    glDeleteBuffers(1, &shared->unit_vertexbuffer);
+#if HAVE_VERTEX_ARRAYS
+    if (shared->vertex_arrays) glDeleteVertexArrays(1, &shared->unit_vertexarray);
+#endif
+    glDeleteTextures(1, &shared->linetexid);
+    glDeleteProgram(shared->fb_program);
+    if (shared->segment_program) glDeleteProgram(shared->segment_program);
+    shared->segment_program       = 0;
+    shared->tried_segment_program = 0;
+    glDeleteProgram(shared->screen_program);
+    glDeleteProgram(shared->decay_program);
+    glDeleteProgram(shared->bloom_down_program);
+    glDeleteProgram(shared->bloom_up_program);
+    delete_blur_programs(shared);
+    forget_uniforms(shared, 0);
+}
+
 int vector_display_teardown(vector_display_t *self) {
+    if (self->soft != NULL) {
+        vector_display_soft_delete(self->soft);
+        self->soft = NULL;
+        return 0;
+    }
     if (!self->did_setup) return 0;
 
-    glDeleteBuffers(1, &self->glow2glow_vertexbuffer);
-    glDeleteBuffers(1, &self->screen2screen_vertexbuffer);
-    glDeleteBuffers(1, &self->screen2glow_vertexbuffer);
-    glDeleteBuffers(1, &self->glow2screen_vertexbuffer);
-    glDeleteTextures(1, &self->linetexid);
-    glDeleteBuffers(self->steps, self->buffers);
-    glDeleteProgram(self->fb_program);
-    glDeleteProgram(self->screen_program);
+    delete_history(self);
+    self->gpu_lines         = 0;
+    self->gpu_lines_pending = 0;
+    sync_recorders(self);
+
+    // lists are uploaded again after the next setup
+    collect_lists(self);
+    vector_display_list_t *list;
+    for (list = self->lists; list != NULL; list = list->next) {
+        delete_list_buffers(list);
+    }
+    for (list = self->free_lists; list != NULL; list = list->next) {
+        delete_list_buffers(list);
+    }
     glDeleteFramebuffers(1, &self->fb_scene);
+    teardown_accumulation(self);
+    teardown_bloom(self);
+    release_blur_program(self);
+
+    // the last display torn down deletes the shared resources
+    if (--self->shared->setups == 0) teardown_shared(self->shared);
+    self->did_setup = 0;
+    self->ready     = 0;
+
+    return 0;
+}
 
+int vector_display_set_gpu_lines(vector_display_t *self, int enable) {
+    self->use_gpu_lines = enable != 0;
     return 0;
 }
 
@@ -1084,8 +4037,87 @@ int vector_display_set_brightness(vector_display_t *self, double brightness) {
     return 0;
 }
 
+int vector_display_set_blur_kernel(vector_display_t *self, double sigma, int radius) {
+    if (sigma == 0.0) radius = 4;
+    if (sigma < 0.0 || radius < 1 || radius > VECTOR_DISPLAY_MAX_BLUR_RADIUS || self->owner != NULL) return -1;
+    if (self->did_setup) {
+        int blur = get_blur_program(self->shared, sigma, radius);
+        if (blur < 0) return -1;
+        if (finish_blur_program(self->shared, blur) < 0) {
+            self->shared->blur_programs[blur].refs--;
+            return -1;
+        }
+        release_blur_program(self);
+        self->blur = blur;
+    }
+    self->blur_sigma  = sigma;
+    self->blur_radius = radius;
+    return 0;
+}
+
+int vector_display_set_beam_falloff(vector_display_t *self, double falloff) {
+    if (falloff < 0.0 || self->owner != NULL) return -1;
+    self->beam_falloff = falloff;
+    if (self->did_setup && falloff > 0.0) {
+        setup_beam_programs(self);
+        finish_beam_programs(self);
+    }
+    return 0;
+}
+
+int vector_display_set_bloom_levels(vector_display_t *self, int nlevels) {
+    if (nlevels < 0 || nlevels > VECTOR_DISPLAY_MAX_BLOOM_LEVELS || self->owner != NULL) return -1;
+    if (nlevels == self->bloom_levels) return 0;
+    if (!self->did_setup) {
+        self->bloom_levels = nlevels;
+        return 0;
+    }
+    GLuint origdrawbuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, (GLint*)&origdrawbuffer);
+    teardown_bloom(self);
+    self->bloom_levels = nlevels;
+    int rc = setup_bloom(self);
+    glBindFramebuffer(GL_FRAMEBUFFER, origdrawbuffer);
+    return rc;
+}
+
+int vector_display_set_bloom_weights(vector_display_t *self, const double *weights, int nweights) {
+    int i;
+    if (nweights < 0 || nweights > VECTOR_DISPLAY_MAX_BLOOM_LEVELS) return -1;
+    for (i = 0; i < nweights; i++) {
+        if (weights[i] < 0.0) return -1;
+    }
+    for (i = 0; i < nweights; i++) {
+        self->bloom_weights[i] = weights[i];
+    }
+    return 0;
+}
+
 void vector_display_delete(vector_display_t *self) {
-    free(self);
+    vector_display_t **link;
+    if (self->owner != NULL) {
+        for (link = &self->owner->recorders; *link != self; link = &(*link)->next_recorder);
+        *link = self->next_recorder;
+    }
+    while (self->recorders != NULL) {
+        vector_display_delete(self->recorders);
+    }
+    if (self->frames != NULL) {
+        free_mesh(self, &self->frames[0]);
+        free_mesh(self, &self->frames[1]);
+        free_mesh(self, &self->frames[2]);
+        vector_display_free(self, self->frames, sizeof(mesh_t) * 3);
+    }
+    free_history(self);
+    free_lists(self, self->lists);
+    free_lists(self, self->free_lists);
+    vector_display_free(self, self->list_draws, sizeof(list_draw_t) * self->clist_draws);
+    free_mesh(self, &self->mesh);
+    vector_display_free(self, self->pending_points, sizeof(pending_point_t) * self->pending_cpoints);
+    scratch_free_blocks(self);
+    vector_display_soft_delete(self->soft);
+    if (self->shared != NULL) vector_display_shared_release(self->shared);
+    self->cb_alloc(self->alloc_ud, self, sizeof(vector_display_t), 0);
 }
 
 void vector_display_get_size(vector_display_t *self, double *out_width, double *out_height) {
@@ -1093,6 +4125,22 @@ void vector_display_get_size(vector_display_t *self, double *out_width, double *
     *out_height = self->height;
 }
 
+void vector_display_get_transform(vector_display_t *self, double *out_offset_x, double *out_offset_y, double *out_scale) {
+    *out_offset_x = self->offset_x;
+    *out_offset_y = self->offset_y;
+    *out_scale    = self->scale;
+}
+
+void vector_display_get_thickness(vector_display_t *self, double *out_thickness) {
+    *out_thickness = effective_thickness(self) * 2 / self->scale;
+}
+
+void vector_display_get_color(vector_display_t *self, double *out_r, double *out_g, double *out_b) {
+    *out_r = self->r;
+    *out_g = self->g;
+    *out_b = self->b;
+}
+
 extern vector_display_log_cb_t vector_display_log_cb;
 void vector_display_set_log_cb(vector_display_log_cb_t cb_log) {
     vector_display_log_cb = cb_log;
@@ -9,6 +9,8 @@
 #ifndef Vector_vector_display_h
 #define Vector_vector_display_h
 
+#include <stddef.h>
+
 #define VECTOR_DISPLAY_MAX_DECAY_STEPS          (60)
 #define VECTOR_DISPLAY_DEFAULT_DECAY_STEPS      (5)
 #define VECTOR_DISPLAY_DEFAULT_DECAY            (0.8)
@@ -17,6 +19,15 @@
 #define VECTOR_DISPLAY_DEFAULT_OFFSET_Y         (0.0)
 #define VECTOR_DISPLAY_DEFAULT_SCALE            (1.0)
 #define VECTOR_DISPLAY_DEFAULT_BRIGHTNESS       (1.0)  
+#define VECTOR_DISPLAY_MAX_BLOOM_LEVELS         (8)
+#define VECTOR_DISPLAY_DEFAULT_BLOOM_WEIGHT     (1.0)
+#define VECTOR_DISPLAY_MAX_BLUR_RADIUS          (16)
+#define VECTOR_DISPLAY_DEFAULT_BLUR_SIGMA       (0.0)
+#define VECTOR_DISPLAY_DEFAULT_BLUR_RADIUS      (4)
+#define VECTOR_DISPLAY_LINE_TEXTURE_FALLOFF     (8.0)
+
+// returned by updates while the display's setup is still being finished
+#define VECTOR_DISPLAY_NOT_READY                (1)
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,19 +43,115 @@ typedef struct vector_display vector_display_t;
 //
 int vector_display_new(vector_display_t **out_self, double width, double height);
 
+//
+// Memory allocation function for a vector display.
+//
+// Works like realloc: ptr is NULL for a new block, and nsize is 0 when the
+// block should be freed (return NULL in that case). osize is the current
+// size of the block, or 0 when ptr is NULL. Returned memory must be aligned
+// as for malloc. Return NULL if an allocation fails.
+//
+typedef void *(*vector_display_alloc_cb_t)(void *ud, void *ptr, size_t osize, size_t nsize);
+
+//
+// Create a new vector display object that gets all of its memory, including
+// the display object itself, from cb_alloc. ud is passed through to cb_alloc.
+//
+// Memory is only allocated when the display grows; once a scene has been drawn
+// once, drawing it again allocates nothing.
+//
+int vector_display_new_with_alloc(vector_display_t **out_self, double width, double height,
+                                  vector_display_alloc_cb_t cb_alloc, void *ud);
+
+//
+// Allocate and free memory through a display's allocation function, for
+// modules that keep memory on behalf of a display, such as the font caches.
+// vector_display_alloc returns NULL if the allocation fails. Blocks are freed
+// with the size they were allocated with.
+//
+void *vector_display_alloc(vector_display_t *self, size_t size);
+void  vector_display_free(vector_display_t *self, void *ptr, size_t size);
+
 //
 // Delete a vector display object.
 //
 void vector_display_delete(vector_display_t *self);
 
+//
+// Create a recorder for a vector display.
+//
+// A recorder is a vector display that can only be drawn to. It has its own
+// color, transform, thickness and tessellated lines, so that several threads
+// can each build part of a frame in their own recorder without locking.
+// vector_display_update draws the display's own lines first, then those of
+// each recorder in the order the recorders were created. Like a display, a
+// recorder keeps what was drawn into it until it is cleared.
+//
+// A recorder starts with the display's current color, transform and
+// thickness. It can't be set up, updated or resized, and display lists can't
+// be recorded or drawn with it, though they can be appended to it.
+//
+// Drawing into recorders must be finished before vector_display_update is
+// called, and not resumed until it returns. Create and delete recorders, and
+// set up, tear down or resize their display, only while none are drawing.
+// Recorders only draw concurrently if the display's memory allocation
+// function is thread safe, as the default one is.
+//
+// Delete a recorder with vector_display_delete. Deleting a display also
+// deletes its recorders.
+//
+int vector_display_new_recorder(vector_display_t *self, vector_display_t **out_recorder);
+
+//
+// Create a recorder that hands its drawing to the display a frame at a time.
+//
+// A frame recorder is drawn like any other recorder, but vector_display_update
+// never reads what is being drawn into it, so it can be drawn into at any
+// time. vector_display_publish hands the finished frame over and starts a new,
+// empty one. Each update draws the newest published frame, and keeps drawing
+// it until another one is published; frames published in between are dropped.
+// Neither publishing nor updating waits for the other, so a simulation thread
+// can build frames while the OpenGL thread presents them.
+//
+// vector_display_publish fails for displays and other recorders, and between
+// vector_display_begin_draw and vector_display_end_draw.
+//
+int vector_display_new_frame_recorder(vector_display_t *self, vector_display_t **out_recorder);
+int vector_display_publish(vector_display_t *recorder);
+
 //
 // Tear down OpenGL state associated with the vector display.
 //
 // Assumes that the OpenGl context is already set and the screen's
 // FBO is bound.
 //
+// Returns VECTOR_DISPLAY_NOT_READY, and draws nothing, while the programs
+// started by vector_display_setup_async are still being built.
+//
 int vector_display_update(vector_display_t *self);
 
+//
+// Update the display, drawing it into the given framebuffer object, scaled
+// to the viewport at x, y of width by height pixels. Unlike
+// vector_display_update, this makes no queries of OpenGL state, which can
+// stall the pipeline on some drivers. Pixels outside the viewport are left
+// alone, and framebuffer is left bound.
+//
+int vector_display_update_framebuffer(vector_display_t *self, unsigned int framebuffer,
+                                      int x, int y, int width, int height);
+
+//
+// Update the display, leaving the composited scene and glow in a texture of
+// the display's size instead of drawing it anywhere, and return the texture's
+// name in out_texture. Its alpha is 1. This takes no more passes than
+// vector_display_update, and makes no queries of OpenGL state.
+//
+// The texture belongs to the display. It holds the frame until the next
+// update, and is replaced when the display is resized, set up or torn down.
+// The display's own framebuffer is left bound.
+//
+int vector_display_update_texture(vector_display_t *self, unsigned int *out_texture);
+
 //
 // Setup OpenGL state associated with the vector display.
 //
@@ -52,10 +159,49 @@ int vector_display_update(vector_display_t *self);
 //
 int vector_display_setup(vector_display_t *self);
 
+//
+// Set up the display without waiting for its programs to be built.
+//
+// All of the compiles and links are started at once, so that drivers with
+// KHR_parallel_shader_compile build them on their own threads while the
+// application carries on. vector_display_poll_setup returns 0 once the
+// display is ready, VECTOR_DISPLAY_NOT_READY until then, or -1 if setup
+// failed. Updates poll the same way, returning VECTOR_DISPLAY_NOT_READY
+// until the display is ready. Without the extension there is no telling when
+// the driver is done, so the first poll waits for it.
+//
+// Everything but updating can be done while the display isn't ready. The
+// OpenGL context must be set for polling, as for setup. Until then, lines are
+// kept both as triangles and for the GPU to expand, so display lists, font
+// caches and recorders drawn before it is ready still draw if the GPU line
+// program fails and the display falls back to tessellating lines itself.
+//
+int vector_display_setup_async(vector_display_t *self);
+int vector_display_poll_setup(vector_display_t *self);
+
+//
+// Render on the CPU instead of through OpenGL, with nthreads threads counting
+// the caller's, or one per processor if nthreads is 0. This takes the place of
+// vector_display_setup, and nothing done with the display afterwards needs an
+// OpenGL context. It draws the way the OpenGL path does, except that lines
+// are always tessellated here and each pass keeps floats instead of 8 bits,
+// so the pixels can differ slightly.
+//
+// vector_display_update renders a frame, and vector_display_get_pixels gives
+// it back: RGBA with an alpha of 255, rows from the top, out_stride bytes
+// apart. The pixels belong to the display and hold the frame until the next
+// update or teardown. vector_display_update_framebuffer and
+// vector_display_update_texture fail, and vector_display_teardown stops the
+// threads.
+//
+int vector_display_setup_software(vector_display_t *self, int nthreads);
+int vector_display_get_pixels(vector_display_t *self, const unsigned char **out_pixels, int *out_stride);
+
 //
 // Resize a vector display. 
 //
-// This function clears the display.
+// This function clears the display. Line positions are kept in 1/8 pixel up to
+// 4095 pixels, and more coarsely beyond, so that the whole display fits.
 //
 int vector_display_resize(vector_display_t *self, double width, double height);
 
@@ -67,6 +213,41 @@ int vector_display_resize(vector_display_t *self, double width, double height);
 //
 int vector_display_teardown(vector_display_t *self);
 
+//
+// The type of shared resources for vector displays.
+//
+// Displays in the same OpenGL context (or contexts sharing objects) can share
+// their programs, line texture and static geometry, so that each display
+// after the first only costs its own framebuffers and history buffers. The
+// resources are created when the first display using them is set up, and
+// deleted when the last one is torn down.
+//
+// A display that isn't given shared resources makes its own when it is set up.
+//
+typedef struct vector_display_shared vector_display_shared_t;
+
+//
+// Create shared resources. Nothing is created in OpenGL until a display using
+// them is set up.
+//
+int vector_display_shared_new(vector_display_shared_t **out_shared);
+int vector_display_shared_new_with_alloc(vector_display_shared_t **out_shared,
+                                         vector_display_alloc_cb_t cb_alloc, void *ud);
+
+//
+// Give up the reference returned by vector_display_shared_new. The shared
+// resources are freed once no display holds them either.
+//
+void vector_display_shared_release(vector_display_shared_t *shared);
+
+//
+// Have a display use shared resources. The display holds a reference to them
+// until it is deleted.
+//
+// Fails once the display is set up, and for recorders.
+//
+int vector_display_set_shared(vector_display_t *self, vector_display_shared_t *shared);
+
 //
 // Clear the display.
 //
@@ -79,6 +260,96 @@ int vector_display_begin_draw(vector_display_t *self, double x, double y);
 int vector_display_draw_to(vector_display_t *self, double x, double y);
 int vector_display_end_draw(vector_display_t *self);
 
+//
+// Draw many series of connected line segments in one call.
+//
+// xy holds x,y pairs for all of the points, one series after another, and
+// counts[i] is the number of points in series i. Each series is drawn as if
+// by vector_display_begin_draw, vector_display_draw_to for the rest of its
+// points, and vector_display_end_draw.
+//
+// Fails if called between vector_display_begin_draw and vector_display_end_draw.
+//
+int vector_display_draw_polylines(vector_display_t *self, const double *xy, const int *counts, int npolylines);
+int vector_display_draw_polylinesf(vector_display_t *self, const float *xy, const int *counts, int npolylines);
+
+//
+// Draw independent line segments in one call.
+//
+// xy holds x0,y0,x1,y1 for each segment. Each segment is drawn as if it were
+// a series of one line.
+//
+// Fails if called between vector_display_begin_draw and vector_display_end_draw.
+//
+int vector_display_draw_segments(vector_display_t *self, const double *xy, int nsegments);
+int vector_display_draw_segmentsf(vector_display_t *self, const float *xy, int nsegments);
+
+//
+// The type of display lists.
+//
+// A display list records the tessellated output of a sequence of draw calls,
+// color changes included, so that it can be drawn again every frame without
+// tessellating it again.
+//
+typedef struct vector_display_list vector_display_list_t;
+
+//
+// Create a new, empty display list for a vector display.
+//
+int vector_display_list_new(vector_display_t *self, vector_display_list_t **out_list);
+
+//
+// Delete a display list.
+//
+// Frames that already drew the list keep it until they have faded out.
+// Deleting a display also deletes all of its lists.
+//
+void vector_display_list_delete(vector_display_list_t *list);
+
+//
+// Record draw calls into a display list.
+//
+// Between vector_display_begin_list and vector_display_end_list, drawing goes
+// into the list instead of the display. Recording replaces whatever the list
+// held before, including in earlier frames that are still fading out. Lists
+// are recorded with the current thickness, color and transform.
+//
+// Fails if a list is already being recorded, or if called between
+// vector_display_begin_draw and vector_display_end_draw.
+//
+int vector_display_begin_list(vector_display_t *self, vector_display_list_t *list);
+int vector_display_end_list(vector_display_t *self);
+
+//
+// Draw a display list into the current frame.
+//
+// The list's recorded framebuffer coordinates are moved as follows:
+//
+//      framebuffer_x = recorded_x * scale + offset_x
+//      framebuffer_y = recorded_y * scale + offset_y
+//
+// Line thickness is scaled along with the lines.
+//
+// Fails while a list is being recorded.
+//
+int vector_display_draw_list(vector_display_t *self, vector_display_list_t *list,
+                             double offset_x, double offset_y, double scale);
+
+//
+// Copy a display list into the current frame, or into the list being recorded.
+//
+// The list's recorded framebuffer coordinates are moved by offset_x, offset_y,
+// rounded to the display's position grid (see vector_display_resize). Unlike
+// vector_display_draw_list, the copy becomes part of the frame's own
+// geometry. This costs a copy of the list's vertices, but no extra draw
+// calls, so it suits many small lists such as glyphs.
+//
+// Fails if called between vector_display_begin_draw and vector_display_end_draw,
+// or if list is the list being recorded.
+//
+int vector_display_append_list(vector_display_t *self, vector_display_list_t *list,
+                               double offset_x, double offset_y);
+
 //
 // Set the current drawing color
 //
@@ -87,8 +358,30 @@ int vector_display_set_color(vector_display_t *self, double r, double g, double
 //
 // Set the number of frames of decay/fade to apply to the scene.
 //
+// Each update draws the lines of all of these frames again. The setting is
+// kept, but not used, while frames are accumulated.
+//
 int vector_display_set_decay_steps(vector_display_t *self, int steps);
 
+//
+// Choose how earlier frames fade.
+//
+// When enabled, faded frames are kept in a texture that is multiplied by the
+// decay every update, and only the current frame's lines are drawn into it.
+// Frames then fade until they can no longer be seen, and an update costs the
+// same however long they persist. The texture holds half floats where the
+// context can render to them (OpenGL 3.0, OpenGL ES 3.2, or
+// EXT_color_buffer_half_float), which fade close to the exact result of the
+// default decay steps. Otherwise it holds 8 bits per color channel, and half
+// a step is taken off every update so the fade always reaches black: frames
+// then persist at most about 255 updates, and the faint tail of the fade falls
+// off linearly and ends early rather than decaying away.
+//
+// Enabling or disabling accumulation clears the fade. Once the display is set
+// up, the OpenGL context must be set. Fails for recorders.
+//
+int vector_display_set_accumulate(vector_display_t *self, int enable);
+
 //
 // Set the brightness multipler applied on each decay frame after the first.
 //
@@ -139,11 +432,95 @@ int vector_display_set_default_thickness(vector_display_t *self);
 //
 int vector_display_set_brightness(vector_display_t *self, double brightness);
 
+//
+// Set the kernel of the blur passes that make the glow.
+//
+// Each pass blurs with a gaussian of the given sigma, in glow pixels, cut off
+// radius pixels each side of the center. Pairs of neighboring taps are read
+// together, so a kernel of radius 4 takes 5 texture reads and one of radius 8
+// takes 9. A sigma of 0 (the default) selects the original 9-tap kernel, and
+// the radius is ignored.
+//
+// Compiled kernels are kept, so switching between a few of them is cheap.
+// Once the display is set up, the OpenGL context must be set. Fails for
+// recorders.
+//
+int vector_display_set_blur_kernel(vector_display_t *self, double sigma, int radius);
+
+//
+// Choose how a line's brightness falls off from its center.
+//
+// By default the beam's profile is read from a texture, which works on any
+// hardware. With a falloff above 0, it is worked out in the fragment shader
+// instead, as 2^(-falloff * d) where d goes from 0 at the center of the line to
+// 1 at its edge. That saves a texture read for every pixel of every line. A
+// falloff of VECTOR_DISPLAY_LINE_TEXTURE_FALLOFF matches the texture; higher
+// ones give a sharper beam, like a fast P31 phosphor, and lower ones a softer
+// one. 0 goes back to the texture.
+//
+// Once the display is set up, the OpenGL context must be set. Fails for
+// recorders.
+//
+int vector_display_set_beam_falloff(vector_display_t *self, double falloff);
+
+//
+// Choose how the glow is made.
+//
+// With 0 levels (the default), the scene is blurred at a third of its size,
+// in a number of passes that grows with the brightness. Otherwise the glow is
+// made by filtering the scene down through this many levels, each half the
+// size of the one before, then back up. Each level widens the glow, and the
+// passes cost about the same as one full-size pass however many levels there
+// are. Brightness then only scales the glow.
+//
+// Once the display is set up, the OpenGL context must be set. Fails for
+// recorders.
+//
+int vector_display_set_bloom_levels(vector_display_t *self, int nlevels);
+
+//
+// Set how much each bloom level adds to the glow.
+//
+// weights[i] scales level i as it is added to the level above it. The glow is
+// then scaled so that its overall brightness only depends on weights[0] and
+// the display's brightness, so the other weights shape the glow: higher ones
+// give more of the wide glow of the smaller levels. Weights after nweights are
+// left as they are.
+//
+int vector_display_set_bloom_weights(vector_display_t *self, const double *weights, int nweights);
+
+//
+// Choose where lines are turned into triangles.
+//
+// When enabled (the default) and the context supports OpenGL 3.3 or OpenGL ES 3.0,
+// each line segment is uploaded once and expanded to triangles in the vertex shader.
+// Otherwise lines are tessellated on the CPU, which works with OpenGL ES 2.0.
+//
+// Takes effect at the next vector_display_setup. Display lists recorded with
+// a different setting must be recorded again.
+//
+int vector_display_set_gpu_lines(vector_display_t *self, int enable);
+
 //
 // Get the size from a vector display.
 //
 void vector_display_get_size(vector_display_t *self, double *out_width, double *out_height);
 
+//
+// Get the 2d transformation set by vector_display_set_transform.
+//
+void vector_display_get_transform(vector_display_t *self, double *out_offset_x, double *out_offset_y, double *out_scale);
+
+//
+// Get the line thickness in scene coordinates, including the default guess.
+//
+void vector_display_get_thickness(vector_display_t *self, double *out_thickness);
+
+//
+// Get the current drawing color.
+//
+void vector_display_get_color(vector_display_t *self, double *out_r, double *out_g, double *out_b);
+
 //
 // Install a custom logging function for the vector display library.
 //
@@ -155,6 +532,21 @@ void vector_display_get_size(vector_display_t *self, double *out_width, double *
 typedef void (*vector_display_log_cb_t)(const char *msg);
 void vector_display_set_log_cb(vector_display_log_cb_t cb_log);
 
+//
+// Keep compiled programs in a directory, to skip compiling them again.
+//
+// Once linked, each program's binary is saved to a file in dir, named for a
+// hash of its sources and the OpenGL vendor, renderer and version. Later
+// setups load the binary instead of compiling the sources, and compile them
+// as usual if the driver rejects it. The directory must exist. Contexts that
+// can't return program binaries (OpenGL ES 3.0, OpenGL 4.1 or
+// OES_get_program_binary) compile as usual.
+//
+// Set it to null (the default) to always compile. Set it before setting up
+// displays; it is shared by all of them. Fails if dir is too long.
+//
+int vector_display_set_program_cache(const char *dir);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,94 @@
+//
+//  vector_display_simd.h
+//  Vector
+//
+//  Minimal float vector abstraction for the structure-of-arrays tessellator
+//  and the software renderer.
+//
+//  VF_WIDTH is the number of lanes: 8 with AVX, 4 with SSE2 or AArch64 NEON,
+//  and 1 (plain floats) everywhere else. Masks are vf_t values produced by
+//  the comparisons and consumed only by vf_select and vf_and.
+//
+
+#ifndef Vector_vector_display_simd_h
+#define Vector_vector_display_simd_h
+
+#if defined(__AVX__)
+#    include <immintrin.h>
+#    define VF_WIDTH 8
+     typedef __m256 vf_t;
+#    define vf_set1(a)          _mm256_set1_ps(a)
+#    define vf_load(p)          _mm256_loadu_ps(p)
+#    define vf_store(p, a)      _mm256_storeu_ps(p, a)
+#    define vf_add(a, b)        _mm256_add_ps(a, b)
+#    define vf_sub(a, b)        _mm256_sub_ps(a, b)
+#    define vf_mul(a, b)        _mm256_mul_ps(a, b)
+#    define vf_div(a, b)        _mm256_div_ps(a, b)
+#    define vf_sqrt(a)          _mm256_sqrt_ps(a)
+#    define vf_min(a, b)        _mm256_min_ps(a, b)
+#    define vf_max(a, b)        _mm256_max_ps(a, b)
+#    define vf_abs(a)           _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a)
+#    define vf_gt(a, b)         _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+#    define vf_ge(a, b)         _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+#    define vf_and(m, n)        _mm256_and_ps(m, n)
+#    define vf_select(m, a, b)  _mm256_blendv_ps(b, a, m)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define VF_WIDTH 4
+     typedef __m128 vf_t;
+#    define vf_set1(a)          _mm_set1_ps(a)
+#    define vf_load(p)          _mm_loadu_ps(p)
+#    define vf_store(p, a)      _mm_storeu_ps(p, a)
+#    define vf_add(a, b)        _mm_add_ps(a, b)
+#    define vf_sub(a, b)        _mm_sub_ps(a, b)
+#    define vf_mul(a, b)        _mm_mul_ps(a, b)
+#    define vf_div(a, b)        _mm_div_ps(a, b)
+#    define vf_sqrt(a)          _mm_sqrt_ps(a)
+#    define vf_min(a, b)        _mm_min_ps(a, b)
+#    define vf_max(a, b)        _mm_max_ps(a, b)
+#    define vf_abs(a)           _mm_andnot_ps(_mm_set1_ps(-0.0f), a)
+#    define vf_gt(a, b)         _mm_cmpgt_ps(a, b)
+#    define vf_ge(a, b)         _mm_cmpge_ps(a, b)
+#    define vf_and(m, n)        _mm_and_ps(m, n)
+#    define vf_select(m, a, b)  _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#    include <arm_neon.h>
+#    define VF_WIDTH 4
+     typedef float32x4_t vf_t;
+#    define vf_set1(a)          vdupq_n_f32(a)
+#    define vf_load(p)          vld1q_f32(p)
+#    define vf_store(p, a)      vst1q_f32(p, a)
+#    define vf_add(a, b)        vaddq_f32(a, b)
+#    define vf_sub(a, b)        vsubq_f32(a, b)
+#    define vf_mul(a, b)        vmulq_f32(a, b)
+#    define vf_div(a, b)        vdivq_f32(a, b)
+#    define vf_sqrt(a)          vsqrtq_f32(a)
+#    define vf_min(a, b)        vminq_f32(a, b)
+#    define vf_max(a, b)        vmaxq_f32(a, b)
+#    define vf_abs(a)           vabsq_f32(a)
+#    define vf_gt(a, b)         vreinterpretq_f32_u32(vcgtq_f32(a, b))
+#    define vf_ge(a, b)         vreinterpretq_f32_u32(vcgeq_f32(a, b))
+#    define vf_and(m, n)        vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(m), vreinterpretq_u32_f32(n)))
+#    define vf_select(m, a, b)  vbslq_f32(vreinterpretq_u32_f32(m), a, b)
+#else
+#    include <math.h>
+#    define VF_WIDTH 1
+     typedef float vf_t;
+#    define vf_set1(a)          ((float)(a))
+#    define vf_load(p)          (*(p))
+#    define vf_store(p, a)      (*(p) = (a))
+#    define vf_add(a, b)        ((a) + (b))
+#    define vf_sub(a, b)        ((a) - (b))
+#    define vf_mul(a, b)        ((a) * (b))
+#    define vf_div(a, b)        ((a) / (b))
+#    define vf_sqrt(a)          sqrtf(a)
+#    define vf_min(a, b)        ((a) < (b) ? (a) : (b))
+#    define vf_max(a, b)        ((a) > (b) ? (a) : (b))
+#    define vf_abs(a)           fabsf(a)
+#    define vf_gt(a, b)         ((a) >  (b) ? 1.0f : 0.0f)
+#    define vf_ge(a, b)         ((a) >= (b) ? 1.0f : 0.0f)
+#    define vf_and(m, n)        ((m) * (n))
+#    define vf_select(m, a, b)  ((m) != 0.0f ? (a) : (b))
+#endif
+
+#endif
@@ -0,0 +1,1023 @@
+//
+//  vector_display_soft.c
+//  Vector
+//
+
+#include "vector_display_soft.h"
+#include "vector_display_simd.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+#if defined(_WIN32)
+#    include <windows.h>
+     typedef HANDLE             soft_thread_t;
+     typedef SRWLOCK            soft_lock_t;
+     typedef CONDITION_VARIABLE soft_cond_t;
+#    define lock_init(l)        InitializeSRWLock(l)
+#    define lock_destroy(l)     ((void)(l))
+#    define lock(l)             AcquireSRWLockExclusive(l)
+#    define unlock(l)           ReleaseSRWLockExclusive(l)
+#    define cond_init(c)        InitializeConditionVariable(c)
+#    define cond_destroy(c)     ((void)(c))
+#    define cond_wait(c, l)     SleepConditionVariableSRW((c), (l), INFINITE, 0)
+#    define cond_signal(c)      WakeConditionVariable(c)
+#    define cond_broadcast(c)   WakeAllConditionVariable(c)
+#else
+#    include <pthread.h>
+#    include <unistd.h>
+     typedef pthread_t          soft_thread_t;
+     typedef pthread_mutex_t    soft_lock_t;
+     typedef pthread_cond_t     soft_cond_t;
+#    define lock_init(l)        pthread_mutex_init((l), NULL)
+#    define lock_destroy(l)     pthread_mutex_destroy(l)
+#    define lock(l)             pthread_mutex_lock(l)
+#    define unlock(l)           pthread_mutex_unlock(l)
+#    define cond_init(c)        pthread_cond_init((c), NULL)
+#    define cond_destroy(c)     pthread_cond_destroy(c)
+#    define cond_wait(c, l)     pthread_cond_wait((c), (l))
+#    define cond_signal(c)      pthread_cond_signal(c)
+#    define cond_broadcast(c)   pthread_cond_broadcast(c)
+#endif
+
+// atomic add to an int, returning what it held before
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#    define atomic_add(p, v)    _InterlockedExchangeAdd((volatile long*)(p), (v))
+#else
+#    define atomic_add(p, v)    __atomic_fetch_add((p), (v), __ATOMIC_ACQ_REL)
+#endif
+
+#define min(x,y) ((x) < (y) ? (x) : (y))
+#define max(x,y) ((x) > (y) ? (x) : (y))
+
+#define MAX_THREADS        (64)
+
+// rows rendered by one job, and triangles set up by one job
+#define BAND_ROWS          (16)
+#define PREPARE_TRIANGLES  (1024)
+
+// image rows are padded to a multiple of this many floats, so that passes
+// over whole rows go a vector at a time with no scalar tail
+#define ROW_ALIGN          (8)
+
+//
+// An image of 4 floats per pixel, RGBA. The pixels past the width that pad
+// out a row hold whatever the passes leave there, and are never read as
+// part of the image.
+//
+typedef struct {
+    float *data;
+    int width, height;
+    int stride;                                // floats per row
+} image_t;
+
+//
+// A triangle set up for rasterizing. Its attributes are planes over the
+// display: r, g, b, a, u, v at (x, y) are c + dx * x + dy * y.
+//
+#define NATTRIBS (6)
+
+typedef struct {
+    float x[3], y[3];
+    int first_row, end_row;                    // rows with pixel centers inside, none if culled
+    float c[NATTRIBS], dx[NATTRIBS], dy[NATTRIBS];
+} prepared_t;
+
+typedef struct {
+    vector_display_soft_t *soft;
+    int index;                                 // 0 is the caller's
+    soft_thread_t thread;
+} worker_t;
+
+typedef void (*job_t)(vector_display_soft_t *soft, int job, int thread);
+
+// what the jobs of a pass between two images work from
+typedef struct {
+    const image_t *src;
+    image_t *dst;
+    float mult;
+    float halfpixel_x, halfpixel_y;
+} pass_t;
+
+struct vector_display_soft {
+    vector_display_alloc_cb_t cb_alloc;
+    void *alloc_ud;
+
+    int nthreads;                              // the caller's and the workers
+    worker_t *workers;                         // nthreads - 1 of them started
+    int cworkers;
+    soft_lock_t lock;
+    soft_cond_t start;                         // a run has started, or quit has been set
+    soft_cond_t done;                          // the last worker has finished the run
+    unsigned generation;                       // runs started
+    int busy;                                  // workers still in the run
+    int quit;
+    job_t job;
+    int njobs;
+    int next_job;                              // atomic
+
+    float *linetex;                            // alpha of the line texture, its edges repeated around it
+    int linetex_size;
+
+    int ctriangles;
+    int ntriangles;
+    vector_display_soft_triangle_t *triangles;
+    int cprepared;
+    prepared_t *prepared;
+    int cbinned;
+    int *binned;                               // prepared triangles by band, in order within each band
+    int cbands;
+    int *band_first;                           // where each band's triangles start in binned, and where they end
+    int *band_fill;
+
+    const vector_display_soft_frame_t *frame;  // being rendered
+    pass_t pass;
+    float blur_weights[VECTOR_DISPLAY_MAX_BLUR_RADIUS + 1];
+
+    image_t scene;
+    image_t accum;
+    int accumulating;                          // accum holds the frames before this one
+    image_t glow[2];
+    image_t bloom[VECTOR_DISPLAY_MAX_BLOOM_LEVELS];
+
+    float *scratch;                            // rows for each thread
+    size_t scratch_floats;                     // for each thread
+
+    unsigned char *pixels;
+    int width, height;                         // of pixels
+};
+
+static void *soft_realloc(vector_display_soft_t *soft, void *ptr, size_t osize, size_t nsize) {
+    return soft->cb_alloc(soft->alloc_ud, ptr, osize, nsize);
+}
+
+static void soft_free(vector_display_soft_t *soft, void *ptr, size_t size) {
+    if (ptr != NULL) soft->cb_alloc(soft->alloc_ud, ptr, size, 0);
+}
+
+//
+// Thread pool. A run hands out njobs jobs to whichever thread asks next, the
+// caller's included, and returns once they are all done; each run is a
+// barrier between the passes of a frame.
+//
+static void do_jobs(vector_display_soft_t *soft, int thread) {
+    int job;
+    while ((job = atomic_add(&soft->next_job, 1)) < soft->njobs) {
+        soft->job(soft, job, thread);
+    }
+}
+
+static void worker_loop(worker_t *worker) {
+    vector_display_soft_t *soft = worker->soft;
+    unsigned seen = 0;
+
+    lock(&soft->lock);
+    for (;;) {
+        while (!soft->quit && soft->generation == seen) cond_wait(&soft->start, &soft->lock);
+        if (soft->quit) break;
+        seen = soft->generation;
+        unlock(&soft->lock);
+
+        do_jobs(soft, worker->index);
+
+        lock(&soft->lock);
+        if (--soft->busy == 0) cond_signal(&soft->done);
+    }
+    unlock(&soft->lock);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI worker_main(LPVOID arg) {
+    worker_loop((worker_t*)arg);
+    return 0;
+}
+
+static int start_worker(worker_t *worker) {
+    worker->thread = CreateThread(NULL, 0, worker_main, worker, 0, NULL);
+    return worker->thread != NULL ? 0 : -1;
+}
+
+static void join_worker(worker_t *worker) {
+    WaitForSingleObject(worker->thread, INFINITE);
+    CloseHandle(worker->thread);
+}
+
+static int processor_count(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+#else
+static void *worker_main(void *arg) {
+    worker_loop((worker_t*)arg);
+    return NULL;
+}
+
+static int start_worker(worker_t *worker) {
+    return pthread_create(&worker->thread, NULL, worker_main, worker) == 0 ? 0 : -1;
+}
+
+static void join_worker(worker_t *worker) {
+    pthread_join(worker->thread, NULL);
+}
+
+static int processor_count(void) {
+#if defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#else
+    return 1;
+#endif
+}
+#endif
+
+static void run(vector_display_soft_t *soft, job_t job, int njobs) {
+    int i;
+    if (njobs <= 0) return;
+    if (soft->nthreads == 1 || njobs == 1) {
+        for (i = 0; i < njobs; i++) job(soft, i, 0);
+        return;
+    }
+
+    lock(&soft->lock);
+    soft->job      = job;
+    soft->njobs    = njobs;
+    soft->next_job = 0;
+    soft->busy     = soft->nthreads - 1;
+    soft->generation++;
+    cond_broadcast(&soft->start);
+    unlock(&soft->lock);
+
+    do_jobs(soft, 0);
+
+    lock(&soft->lock);
+    while (soft->busy > 0) cond_wait(&soft->done, &soft->lock);
+    unlock(&soft->lock);
+}
+
+static int nbands(int height) {
+    return (height + BAND_ROWS - 1) / BAND_ROWS;
+}
+
+static float *scratch_rows(vector_display_soft_t *soft, int thread) {
+    return soft->scratch + soft->scratch_floats * thread;
+}
+
+static float *image_row(const image_t *image, int y) {
+    return image->data + (size_t)image->stride * y;
+}
+
+//
+// Size an image, keeping its pixels if the size hasn't changed. Returns 1 if
+// it has, 0 if not, and -1 if it can't be had.
+//
+static int size_image(vector_display_soft_t *soft, image_t *image, int width, int height) {
+    int stride;
+    width  = max(width, 1);
+    height = max(height, 1);
+    if (image->data != NULL && image->width == width && image->height == height) return 0;
+
+    stride = (4 * width + ROW_ALIGN - 1) & ~(ROW_ALIGN - 1);
+    soft_free(soft, image->data, sizeof(float) * image->stride * image->height);
+    image->data = (float*)soft_realloc(soft, NULL, 0, sizeof(float) * stride * height);
+    if (image->data == NULL) {
+        memset(image, 0, sizeof(*image));
+        return -1;
+    }
+    image->width  = width;
+    image->height = height;
+    image->stride = stride;
+    return 1;
+}
+
+static void free_image(vector_display_soft_t *soft, image_t *image) {
+    soft_free(soft, image->data, sizeof(float) * image->stride * image->height);
+    memset(image, 0, sizeof(*image));
+}
+
+static void clear_image(image_t *image, float alpha) {
+    size_t i, n = (size_t)image->stride * image->height;
+    for (i = 0; i < n; i += 4) {
+        image->data[i + 0] = image->data[i + 1] = image->data[i + 2] = 0.0f;
+        image->data[i + 3] = alpha;
+    }
+}
+
+//
+// Rounding and clamping without floorf and ceilf, which are calls unless the
+// compiler can count on SSE4.1. Once t is clamped to be positive, casts do.
+//
+static int ceil_clamped(float t, int lo, int hi) {
+    int i;
+    if (!(t > lo)) return lo;
+    if (t >= hi) return hi;
+    i = (int)t;
+    return i + (i < t);
+}
+
+// the texel at or before texel coordinate t, clamped to the edge, and how far t is past it
+static int texel_clamped(float t, int n, float *out_f) {
+    int i;
+    t = min(max(t, 0.0f), (float)(n - 1));
+    i = (int)t;
+    *out_f = t - i;
+    return i;
+}
+
+//
+// Sampling as done by linear filtering with clamping to the edge, at (u, v)
+// from 0 to 1 across the image.
+//
+static void sample(const image_t *image, float u, float v, float weight, float *out) {
+    float fx, fy;
+    int x0 = texel_clamped(u * image->width - 0.5f, image->width, &fx), x1 = min(x0 + 1, image->width - 1);
+    int y0 = texel_clamped(v * image->height - 0.5f, image->height, &fy), y1 = min(y0 + 1, image->height - 1);
+    int c;
+
+    const float *r0 = image_row(image, y0), *r1 = image_row(image, y1);
+    for (c = 0; c < 4; c++) {
+        float top    = r0[4*x0 + c] + (r0[4*x1 + c] - r0[4*x0 + c]) * fx;
+        float bottom = r1[4*x0 + c] + (r1[4*x1 + c] - r1[4*x0 + c]) * fx;
+        out[c] += (top + (bottom - top) * fy) * weight;
+    }
+}
+
+//
+// Sample a row of width pixels across the image, at v, into out. The two
+// rows it falls between are blended a vector at a time into tmp first.
+//
+static void sample_row(const image_t *image, float v, int width, float *tmp, float *out) {
+    float f, step = (float)image->width / width;
+    int y0 = texel_clamped(v * image->height - 0.5f, image->height, &f), y1 = min(y0 + 1, image->height - 1);
+    int x, c, i;
+
+    const float *r0 = image_row(image, y0), *r1 = image_row(image, y1);
+    vf_t fy = vf_set1(f);
+    for (i = 0; i < image->stride; i += VF_WIDTH) {
+        vf_t top = vf_load(r0 + i);
+        vf_store(tmp + i, vf_add(top, vf_mul(vf_sub(vf_load(r1 + i), top), fy)));
+    }
+
+    for (x = 0; x < width; x++) {
+        int x0 = texel_clamped((x + 0.5f) * step - 0.5f, image->width, &f), x1 = min(x0 + 1, image->width - 1);
+        for (c = 0; c < 4; c++) {
+            out[4*x + c] = tmp[4*x0 + c] + (tmp[4*x1 + c] - tmp[4*x0 + c]) * f;
+        }
+    }
+}
+
+//
+// Work out a triangle's attribute planes. Triangles facing away are culled,
+// as with glCullFace(GL_BACK): with y pointing down, the front faces of the
+// tessellation have negative area.
+//
+static void prepare_triangle(const vector_display_soft_triangle_t *t, prepared_t *p, int height) {
+    const float *attribs[NATTRIBS] = { t->r, t->g, t->b, t->a, t->u, t->v };
+    float x1 = t->x[1] - t->x[0], y1 = t->y[1] - t->y[0];
+    float x2 = t->x[2] - t->x[0], y2 = t->y[2] - t->y[0];
+    float area = x1 * y2 - x2 * y1;
+    float ymin = min(min(t->y[0], t->y[1]), t->y[2]);
+    float ymax = max(max(t->y[0], t->y[1]), t->y[2]);
+    int k;
+
+    // rows y with ymin <= y + 0.5 < ymax
+    p->first_row = ceil_clamped(ymin - 0.5f, 0, height);
+    p->end_row   = ceil_clamped(ymax - 0.5f, 0, height);
+    if (!(area < 0.0f) || p->first_row >= p->end_row) {
+        p->first_row = p->end_row = 0;
+        return;
+    }
+
+    for (k = 0; k < 3; k++) {
+        p->x[k] = t->x[k];
+        p->y[k] = t->y[k];
+    }
+    for (k = 0; k < NATTRIBS; k++) {
+        float f1 = attribs[k][1] - attribs[k][0], f2 = attribs[k][2] - attribs[k][0];
+        p->dx[k] = (f1 * y2 - f2 * y1) / area;
+        p->dy[k] = (f2 * x1 - f1 * x2) / area;
+        p->c[k]  = attribs[k][0] - p->dx[k] * t->x[0] - p->dy[k] * t->y[0];
+    }
+}
+
+static void prepare_job(vector_display_soft_t *soft, int job, int thread) {
+    int i, first = job * PREPARE_TRIANGLES, last = min(first + PREPARE_TRIANGLES, soft->ntriangles);
+    (void)thread;
+    for (i = first; i < last; i++) {
+        prepare_triangle(&soft->triangles[i], &soft->prepared[i], soft->frame->height);
+    }
+}
+
+//
+// Sort the triangles into the bands of rows they cover, keeping their order,
+// so that each band only looks at its own.
+//
+static int bin_triangles(vector_display_soft_t *soft) {
+    int nb = nbands(soft->scene.height), total = 0, b, i;
+
+    if (soft->cbands < nb + 1) {
+        soft_free(soft, soft->band_first, sizeof(int) * soft->cbands);
+        soft_free(soft, soft->band_fill, sizeof(int) * soft->cbands);
+        soft->cbands = 0;
+        soft->band_first = (int*)soft_realloc(soft, NULL, 0, sizeof(int) * (nb + 1));
+        soft->band_fill  = (int*)soft_realloc(soft, NULL, 0, sizeof(int) * (nb + 1));
+        if (soft->band_first == NULL || soft->band_fill == NULL) return -1;
+        soft->cbands = nb + 1;
+    }
+
+    memset(soft->band_fill, 0, sizeof(int) * nb);
+    for (i = 0; i < soft->ntriangles; i++) {
+        const prepared_t *p = &soft->prepared[i];
+        if (p->first_row == p->end_row) continue;
+        for (b = p->first_row / BAND_ROWS; b <= (p->end_row - 1) / BAND_ROWS; b++) soft->band_fill[b]++;
+    }
+    for (b = 0; b < nb; b++) {
+        soft->band_first[b] = total;
+        total += soft->band_fill[b];
+        soft->band_fill[b] = soft->band_first[b];
+    }
+    soft->band_first[nb] = total;
+
+    if (soft->cbinned < total) {
+        int capacity = max(total, soft->cbinned * 2);
+        soft_free(soft, soft->binned, sizeof(int) * soft->cbinned);
+        soft->cbinned = 0;
+        soft->binned = (int*)soft_realloc(soft, NULL, 0, sizeof(int) * capacity);
+        if (soft->binned == NULL) return -1;
+        soft->cbinned = capacity;
+    }
+    for (i = 0; i < soft->ntriangles; i++) {
+        const prepared_t *p = &soft->prepared[i];
+        if (p->first_row == p->end_row) continue;
+        for (b = p->first_row / BAND_ROWS; b <= (p->end_row - 1) / BAND_ROWS; b++) soft->binned[soft->band_fill[b]++] = i;
+    }
+    return 0;
+}
+
+//
+// The line texture's alpha at (u, v), linearly filtered. The texture is kept
+// with its edge texels repeated around it, so once u and v are clamped, the
+// four texels read are always there.
+//
+static float line_alpha(const float *linetex, int n, float u, float v) {
+    float tx = min(max(u, 0.0f), 1.0f) * n + 0.5f, ty = min(max(v, 0.0f), 1.0f) * n + 0.5f;
+    int x0 = (int)tx, y0 = (int)ty;
+    float fx = tx - x0, fy = ty - y0;
+
+    const float *r0 = linetex + (n + 2) * y0 + x0, *r1 = r0 + n + 2;
+    float top    = r0[0] + (r0[1] - r0[0]) * fx;
+    float bottom = r1[0] + (r1[1] - r1[0]) * fx;
+    return top + (bottom - top) * fy;
+}
+
+//
+// Add a triangle's pixels on row y, those whose centers are inside it, as the
+// OpenGL path blends them: the color scaled by its alpha and the beam profile.
+//
+static void raster_row(const vector_display_soft_t *soft, const prepared_t *p, int y, float *row) {
+    float yc = y + 0.5f, xl = FLT_MAX, xr = -FLT_MAX;
+    float falloff = (float)soft->frame->beam_falloff;
+    int e, x0, x1;
+
+    // edges are followed from their top, so that the triangles either side of
+    // an edge agree on where it is, and pixels on it are drawn exactly once
+    for (e = 0; e < 3; e++) {
+        int a = e, b = e == 2 ? 0 : e + 1;
+        if (p->y[b] < p->y[a]) {
+            a = b;
+            b = e;
+        }
+        if (p->y[a] <= yc && yc < p->y[b]) {
+            float xs = p->x[a] + (yc - p->y[a]) * (p->x[b] - p->x[a]) / (p->y[b] - p->y[a]);
+            xl = min(xl, xs);
+            xr = max(xr, xs);
+        }
+    }
+    x0 = ceil_clamped(xl - 0.5f, 0, soft->frame->width);
+    x1 = ceil_clamped(xr - 0.5f, 0, soft->frame->width);
+    if (x0 >= x1) return;
+
+    // the attributes at the first pixel's center, and their steps, in locals
+    // that the stores to the row can't alias
+    float xc = x0 + 0.5f;
+    float r = p->c[0] + p->dx[0] * xc + p->dy[0] * yc, dr = p->dx[0];
+    float g = p->c[1] + p->dx[1] * xc + p->dy[1] * yc, dg = p->dx[1];
+    float b = p->c[2] + p->dx[2] * xc + p->dy[2] * yc, db = p->dx[2];
+    float a = p->c[3] + p->dx[3] * xc + p->dy[3] * yc, da = p->dx[3];
+    float u = p->c[4] + p->dx[4] * xc + p->dy[4] * yc, du = p->dx[4];
+    float v = p->c[5] + p->dx[5] * xc + p->dy[5] * yc, dv = p->dx[5];
+    float *px = row + 4 * x0, *end = row + 4 * x1;
+
+    if (falloff > 0.0f) {
+        for (; px < end; px += 4) {
+            float cu = u - 0.5f, cv = v - 0.5f;
+            float w = a * exp2f(-falloff * min(sqrtf(cu * cu + cv * cv) * 2.0f, 1.0f));
+            px[0] += r * w;
+            px[1] += g * w;
+            px[2] += b * w;
+            r += dr; g += dg; b += db; a += da; u += du; v += dv;
+        }
+    } else {
+        const float *linetex = soft->linetex;
+        int n = soft->linetex_size;
+        for (; px < end; px += 4) {
+            float w = a * line_alpha(linetex, n, u, v);
+            px[0] += r * w;
+            px[1] += g * w;
+            px[2] += b * w;
+            r += dr; g += dg; b += db; a += da; u += du; v += dv;
+        }
+    }
+}
+
+//
+// Fade the accumulated frames and add the new one to them, then add them, as
+// they were, to the scene, as accumulate_frames does on the GPU when it
+// accumulates in half floats.
+//
+static void accumulate_row(const vector_display_soft_t *soft, float *scene, float *accum) {
+    const vector_display_soft_frame_t *frame = soft->frame;
+    vf_t decay   = vf_set1((float)frame->decay);
+    vf_t initial = vf_set1((float)frame->initial_decay);
+    vf_t fade    = vf_set1(1.0f / 65536.0f);
+    vf_t zero    = vf_set1(0.0f), one = vf_set1(1.0f);
+    int i;
+    for (i = 0; i < soft->scene.stride; i += VF_WIDTH) {
+        vf_t f = vf_load(scene + i), h = vf_load(accum + i);
+        vf_store(accum + i, vf_add(vf_min(vf_max(vf_sub(vf_mul(h, decay), fade), zero), one), f));
+        vf_store(scene + i, vf_min(vf_add(f, vf_mul(h, initial)), one));
+    }
+}
+
+static void raster_job(vector_display_soft_t *soft, int band, int thread) {
+    const image_t *scene = &soft->scene;
+    int y0 = band * BAND_ROWS, y1 = min(y0 + BAND_ROWS, scene->height);
+    int i, y;
+    vf_t one = vf_set1(1.0f);
+    (void)thread;
+
+    for (y = y0; y < y1; y++) {
+        float *row = image_row(scene, y);
+        for (i = 0; i < scene->stride; i += 4) {
+            row[i + 0] = row[i + 1] = row[i + 2] = 0.0f;
+            row[i + 3] = 1.0f;
+        }
+    }
+
+    for (i = soft->band_first[band]; i < soft->band_first[band + 1]; i++) {
+        const prepared_t *p = &soft->prepared[soft->binned[i]];
+        int first = max(y0, p->first_row), end = min(y1, p->end_row);
+        for (y = first; y < end; y++) {
+            raster_row(soft, p, y, image_row(scene, y));
+        }
+    }
+
+    for (y = y0; y < y1; y++) {
+        float *row = image_row(scene, y);
+        for (i = 0; i < scene->stride; i += VF_WIDTH) {
+            vf_store(row + i, vf_min(vf_load(row + i), one));
+        }
+        if (soft->frame->accumulate) accumulate_row(soft, row, image_row(&soft->accum, y));
+    }
+}
+
+//
+// Glow through blur passes. Each pass is a horizontal and a vertical pass of
+// the kernel, with every tap read; each leaves the color and alpha scaled by
+// mult and the color then scaled by the alpha, as the blur program's output
+// is blended on the GPU.
+//
+static void blur_output_row(float *row, int width, float mult) {
+    int x;
+    for (x = 0; x < width; x++, row += 4) {
+        float a = min(row[3] * mult, 1.0f);
+        row[0] = min(row[0] * mult, 1.0f) * a;
+        row[1] = min(row[1] * mult, 1.0f) * a;
+        row[2] = min(row[2] * mult, 1.0f) * a;
+        row[3] = a * a;
+    }
+}
+
+static void downsample_job(vector_display_soft_t *soft, int band, int thread) {
+    const pass_t *pass = &soft->pass;
+    float *tmp = scratch_rows(soft, thread);
+    int y, y1 = min((band + 1) * BAND_ROWS, pass->dst->height);
+    for (y = band * BAND_ROWS; y < y1; y++) {
+        sample_row(pass->src, (y + 0.5f) / pass->dst->height, pass->dst->width, tmp, image_row(pass->dst, y));
+    }
+}
+
+static void blur_h_job(vector_display_soft_t *soft, int band, int thread) {
+    const pass_t *pass = &soft->pass;
+    const image_t *src = pass->src;
+    int radius = soft->frame->blur_radius;
+    float *padded = scratch_rows(soft, thread);
+    int x, i, k, y, y1 = min((band + 1) * BAND_ROWS, src->height);
+    vf_t weights[VECTOR_DISPLAY_MAX_BLUR_RADIUS + 1];
+
+    for (k = 0; k <= radius; k++) weights[k] = vf_set1(soft->blur_weights[k]);
+
+    for (y = band * BAND_ROWS; y < y1; y++) {
+        const float *row = image_row(src, y);
+        float *out = image_row(pass->dst, y);
+
+        // the row with its edge pixels repeated radius pixels out on both sides
+        for (x = -radius; x < src->stride / 4 + radius; x++) {
+            memcpy(padded + 4 * (x + radius), row + 4 * min(max(x, 0), src->width - 1), sizeof(float) * 4);
+        }
+
+        const float *center = padded + 4 * radius;
+        for (i = 0; i < src->stride; i += VF_WIDTH) {
+            vf_t sum = vf_mul(vf_load(center + i), weights[0]);
+            for (k = 1; k <= radius; k++) {
+                sum = vf_add(sum, vf_mul(vf_add(vf_load(center + i - 4*k), vf_load(center + i + 4*k)), weights[k]));
+            }
+            vf_store(out + i, sum);
+        }
+        blur_output_row(out, src->width, pass->mult);
+    }
+}
+
+static void blur_v_job(vector_display_soft_t *soft, int band, int thread) {
+    const pass_t *pass = &soft->pass;
+    const image_t *src = pass->src;
+    int radius = soft->frame->blur_radius;
+    int i, k, y, y1 = min((band + 1) * BAND_ROWS, src->height);
+    vf_t weights[VECTOR_DISPLAY_MAX_BLUR_RADIUS + 1];
+    const float *above[VECTOR_DISPLAY_MAX_BLUR_RADIUS + 1], *below[VECTOR_DISPLAY_MAX_BLUR_RADIUS + 1];
+    (void)thread;
+
+    for (k = 0; k <= radius; k++) weights[k] = vf_set1(soft->blur_weights[k]);
+
+    for (y = band * BAND_ROWS; y < y1; y++) {
+        float *out = image_row(pass->dst, y);
+        for (k = 0; k <= radius; k++) {
+            above[k] = image_row(src, max(y - k, 0));
+            below[k] = image_row(src, min(y + k, src->height - 1));
+        }
+        for (i = 0; i < src->stride; i += VF_WIDTH) {
+            vf_t sum = vf_mul(vf_load(above[0] + i), weights[0]);
+            for (k = 1; k <= radius; k++) {
+                sum = vf_add(sum, vf_mul(vf_add(vf_load(above[k] + i), vf_load(below[k] + i)), weights[k]));
+            }
+            vf_store(out + i, sum);
+        }
+        blur_output_row(out, src->width, pass->mult);
+    }
+}
+
+static void blur_glow(vector_display_soft_t *soft) {
+    const vector_display_soft_frame_t *frame = soft->frame;
+    int npasses = (int)(frame->brightness * 4), pass, k;
+
+    if (npasses <= 0) return;
+    for (k = 0; k <= frame->blur_radius; k++) soft->blur_weights[k] = (float)frame->blur_weights[k];
+
+    // the first horizontal pass reads the scene at glow size
+    soft->pass.src = &soft->scene;
+    soft->pass.dst = &soft->glow[1];
+    run(soft, downsample_job, nbands(soft->glow[1].height));
+
+    soft->pass.mult = (float)(1.05 + ((frame->brightness - 1.0) / 5.0));
+    for (pass = 0; pass < npasses; pass++) {
+        soft->pass.src = &soft->glow[1];
+        soft->pass.dst = &soft->glow[0];
+        run(soft, blur_h_job, nbands(soft->glow[0].height));
+        soft->pass.src = &soft->glow[0];
+        soft->pass.dst = &soft->glow[1];
+        run(soft, blur_v_job, nbands(soft->glow[1].height));
+    }
+}
+
+//
+// Glow through the bloom chain, with the same dual filter as the bloom
+// programs, sampling each level with linear filtering.
+//
+static void bloom_down_pixel(const image_t *src, float u, float v, float hx, float hy, float *out) {
+    out[0] = out[1] = out[2] = out[3] = 0.0f;
+    sample(src, u, v, 4.0f / 8.0f, out);
+    sample(src, u - hx, v - hy, 1.0f / 8.0f, out);
+    sample(src, u + hx, v + hy, 1.0f / 8.0f, out);
+    sample(src, u + hx, v - hy, 1.0f / 8.0f, out);
+    sample(src, u - hx, v + hy, 1.0f / 8.0f, out);
+}
+
+// the up filter's color, clamped as it would be written out
+static void bloom_up_pixel(const image_t *src, float u, float v, float hx, float hy, float mult, float *out) {
+    float w1 = mult / 12.0f, w2 = 2.0f * w1;
+    int c;
+    out[0] = out[1] = out[2] = out[3] = 0.0f;
+    sample(src, u - hx * 2.0f, v, w1, out);
+    sample(src, u - hx, v + hy, w2, out);
+    sample(src, u, v + hy * 2.0f, w1, out);
+    sample(src, u + hx, v + hy, w2, out);
+    sample(src, u + hx * 2.0f, v, w1, out);
+    sample(src, u + hx, v - hy, w2, out);
+    sample(src, u, v - hy * 2.0f, w1, out);
+    sample(src, u - hx, v - hy, w2, out);
+    for (c = 0; c < 4; c++) out[c] = min(out[c], 1.0f);
+}
+
+static void bloom_down_job(vector_display_soft_t *soft, int band, int thread) {
+    const pass_t *pass = &soft->pass;
+    image_t *dst = pass->dst;
+    int x, y, y1 = min((band + 1) * BAND_ROWS, dst->height);
+    (void)thread;
+    for (y = band * BAND_ROWS; y < y1; y++) {
+        float *out = image_row(dst, y), v = (y + 0.5f) / dst->height;
+        for (x = 0; x < dst->width; x++) {
+            bloom_down_pixel(pass->src, (x + 0.5f) / dst->width, v, pass->halfpixel_x, pass->halfpixel_y, out + 4*x);
+        }
+    }
+}
+
+static void bloom_up_job(vector_display_soft_t *soft, int band, int thread) {
+    const pass_t *pass = &soft->pass;
+    image_t *dst = pass->dst;
+    int x, c, y, y1 = min((band + 1) * BAND_ROWS, dst->height);
+    float up[4];
+    (void)thread;
+    for (y = band * BAND_ROWS; y < y1; y++) {
+        float *out = image_row(dst, y), v = (y + 0.5f) / dst->height;
+        for (x = 0; x < dst->width; x++, out += 4) {
+            bloom_up_pixel(pass->src, (x + 0.5f) / dst->width, v, pass->halfpixel_x, pass->halfpixel_y, pass->mult, up);
+            for (c = 0; c < 4; c++) out[c] = min(out[c] + up[c], 1.0f);
+        }
+    }
+}
+
+static void bloom_glow(vector_display_soft_t *soft) {
+    const vector_display_soft_frame_t *frame = soft->frame;
+    int i;
+
+    // filter down, replacing what the levels held
+    for (i = 0; i < frame->bloom_levels; i++) {
+        soft->pass.src = i == 0 ? &soft->scene : &soft->bloom[i-1];
+        soft->pass.dst = &soft->bloom[i];
+        soft->pass.halfpixel_x = 0.5f / soft->bloom[i].width;
+        soft->pass.halfpixel_y = 0.5f / soft->bloom[i].height;
+        run(soft, bloom_down_job, nbands(soft->bloom[i].height));
+    }
+
+    // filter up, adding to what the levels hold
+    for (i = frame->bloom_levels - 1; i > 0; i--) {
+        soft->pass.src = &soft->bloom[i];
+        soft->pass.dst = &soft->bloom[i-1];
+        soft->pass.halfpixel_x = 0.5f / soft->bloom[i].width;
+        soft->pass.halfpixel_y = 0.5f / soft->bloom[i].height;
+        soft->pass.mult = (float)frame->bloom_weights[i];
+        run(soft, bloom_up_job, nbands(soft->bloom[i-1].height));
+    }
+}
+
+//
+// Add the glow, upsampled and scaled by pass.mult, to the scene, and write
+// out the 8-bit pixels. pass.src is the glow, NULL if there is none.
+//
+static void composite_job(vector_display_soft_t *soft, int band, int thread) {
+    const vector_display_soft_frame_t *frame = soft->frame;
+    const pass_t *pass = &soft->pass;
+    const image_t *scene = &soft->scene;
+    float *tmp  = scratch_rows(soft, thread);
+    float *glow = tmp + scene->stride;
+    int x, i, y, y1 = min((band + 1) * BAND_ROWS, scene->height);
+    vf_t mult = vf_set1(pass->mult), one = vf_set1(1.0f), scale = vf_set1(255.0f), half = vf_set1(0.5f);
+
+    for (y = band * BAND_ROWS; y < y1; y++) {
+        const float *row = image_row(scene, y);
+        float v = (y + 0.5f) / scene->height;
+
+        if (pass->src == NULL) {
+            memset(glow, 0, sizeof(float) * scene->stride);
+        } else if (frame->bloom_levels > 0) {
+            for (x = 0; x < scene->width; x++) {
+                bloom_up_pixel(pass->src, (x + 0.5f) / scene->width, v, pass->halfpixel_x, pass->halfpixel_y, pass->mult, glow + 4*x);
+            }
+        } else {
+            sample_row(pass->src, v, scene->width, tmp, glow);
+            for (i = 0; i < scene->stride; i += VF_WIDTH) {
+                vf_store(glow + i, vf_min(vf_mul(vf_load(glow + i), mult), one));
+            }
+        }
+
+        for (i = 0; i < scene->stride; i += VF_WIDTH) {
+            vf_t color = vf_min(vf_add(vf_load(row + i), vf_load(glow + i)), one);
+            vf_store(glow + i, vf_add(vf_mul(color, scale), half));
+        }
+
+        unsigned char *out = soft->pixels + (size_t)4 * scene->width * y;
+        for (x = 0; x < scene->width; x++) {
+            out[4*x + 0] = (unsigned char)glow[4*x + 0];
+            out[4*x + 1] = (unsigned char)glow[4*x + 1];
+            out[4*x + 2] = (unsigned char)glow[4*x + 2];
+            out[4*x + 3] = 0xff;
+        }
+    }
+}
+
+static void composite(vector_display_soft_t *soft) {
+    const vector_display_soft_frame_t *frame = soft->frame;
+    double fin_mult = 1.25 + ((frame->brightness - 1.0) / 2.0);
+
+    soft->pass.src = NULL;
+    if (frame->brightness > 0) {
+        if (frame->bloom_levels > 0) {
+            double gain = frame->bloom_gain > 0.0 ? frame->bloom_gain : 1.0;
+            soft->pass.src  = &soft->bloom[0];
+            soft->pass.dst  = NULL;
+            soft->pass.mult = (float)(fin_mult * frame->bloom_weights[0] / gain);
+            soft->pass.halfpixel_x = 0.5f / soft->bloom[0].width;
+            soft->pass.halfpixel_y = 0.5f / soft->bloom[0].height;
+        } else if ((int)(frame->brightness * 4) > 0) {
+            soft->pass.src  = &soft->glow[1];
+            soft->pass.dst  = NULL;
+            soft->pass.mult = (float)fin_mult;
+        }
+    }
+    run(soft, composite_job, nbands(soft->scene.height));
+}
+
+//
+// Size the buffers for the frame. Those it doesn't use are kept for when it
+// goes back to them.
+//
+static int size_buffers(vector_display_soft_t *soft, const vector_display_soft_frame_t *frame) {
+    size_t floats;
+    int i, rc;
+
+    if (size_image(soft, &soft->scene, frame->width, frame->height) < 0) return -1;
+    if (frame->accumulate) {
+        if ((rc = size_image(soft, &soft->accum, frame->width, frame->height)) < 0) return -1;
+        if (rc > 0) soft->accumulating = 0;
+    }
+    if (frame->bloom_levels > 0) {
+        for (i = 0; i < frame->bloom_levels; i++) {
+            if (size_image(soft, &soft->bloom[i], frame->bloom_width[i], frame->bloom_height[i]) < 0) return -1;
+        }
+    } else {
+        if (size_image(soft, &soft->glow[0], frame->glow_width, frame->glow_height) < 0) return -1;
+        if (size_image(soft, &soft->glow[1], frame->glow_width, frame->glow_height) < 0) return -1;
+    }
+
+    if (soft->pixels == NULL || soft->width != soft->scene.width || soft->height != soft->scene.height) {
+        soft_free(soft, soft->pixels, (size_t)4 * soft->width * soft->height);
+        soft->width  = soft->height = 0;
+        soft->pixels = (unsigned char*)soft_realloc(soft, NULL, 0, (size_t)4 * soft->scene.width * soft->scene.height);
+        if (soft->pixels == NULL) return -1;
+        soft->width  = soft->scene.width;
+        soft->height = soft->scene.height;
+    }
+
+    // two rows of the scene's width, or a glow row padded out by the blur
+    floats = max((size_t)2 * soft->scene.stride, (size_t)soft->scene.stride + 8 * VECTOR_DISPLAY_MAX_BLUR_RADIUS);
+    if (soft->scratch_floats < floats) {
+        soft_free(soft, soft->scratch, sizeof(float) * soft->scratch_floats * soft->nthreads);
+        soft->scratch_floats = 0;
+        soft->scratch = (float*)soft_realloc(soft, NULL, 0, sizeof(float) * floats * soft->nthreads);
+        if (soft->scratch == NULL) return -1;
+        soft->scratch_floats = floats;
+    }
+
+    if (soft->cprepared < soft->ntriangles) {
+        soft_free(soft, soft->prepared, sizeof(prepared_t) * soft->cprepared);
+        soft->cprepared = 0;
+        soft->prepared = (prepared_t*)soft_realloc(soft, NULL, 0, sizeof(prepared_t) * soft->ctriangles);
+        if (soft->prepared == NULL) return -1;
+        soft->cprepared = soft->ctriangles;
+    }
+    return 0;
+}
+
+int vector_display_soft_render(vector_display_soft_t *soft, const vector_display_soft_frame_t *frame) {
+    int rc = size_buffers(soft, frame);
+    soft->frame = frame;
+    if (rc == 0) {
+        run(soft, prepare_job, (soft->ntriangles + PREPARE_TRIANGLES - 1) / PREPARE_TRIANGLES);
+        rc = bin_triangles(soft);
+    }
+    if (rc == 0) {
+        if (frame->accumulate && !soft->accumulating) clear_image(&soft->accum, 1.0f);
+        soft->accumulating = frame->accumulate;
+        run(soft, raster_job, nbands(soft->scene.height));
+
+        if (frame->bloom_levels > 0) {
+            if (frame->brightness > 0) bloom_glow(soft);
+        } else {
+            blur_glow(soft);
+        }
+        composite(soft);
+    }
+    soft->frame      = NULL;
+    soft->ntriangles = 0;
+    return rc;
+}
+
+vector_display_soft_triangle_t *vector_display_soft_add_triangles(vector_display_soft_t *soft, int n) {
+    if (soft->ntriangles + n > soft->ctriangles) {
+        int capacity = max(soft->ctriangles, 1024);
+        while (capacity < soft->ntriangles + n) capacity *= 2;
+        vector_display_soft_triangle_t *triangles = (vector_display_soft_triangle_t*)soft_realloc(soft, soft->triangles,
+            sizeof(vector_display_soft_triangle_t) * soft->ctriangles, sizeof(vector_display_soft_triangle_t) * capacity);
+        if (triangles == NULL) return NULL;
+        soft->triangles  = triangles;
+        soft->ctriangles = capacity;
+    }
+    soft->ntriangles += n;
+    return soft->triangles + soft->ntriangles - n;
+}
+
+const unsigned char *vector_display_soft_pixels(vector_display_soft_t *soft, int *out_stride) {
+    *out_stride = 4 * soft->width;
+    return soft->pixels;
+}
+
+int vector_display_soft_new(vector_display_soft_t **out_soft, int nthreads,
+                            const unsigned char *linetex, int linetex_size,
+                            vector_display_alloc_cb_t cb_alloc, void *ud) {
+    vector_display_soft_t *soft;
+    int i, x, y;
+
+    *out_soft = NULL;
+    if (nthreads < 0) return -1;
+    if (nthreads == 0) nthreads = processor_count();
+    nthreads = min(max(nthreads, 1), MAX_THREADS);
+
+    soft = (vector_display_soft_t*)cb_alloc(ud, NULL, 0, sizeof(vector_display_soft_t));
+    if (soft == NULL) return -1;
+    memset(soft, 0, sizeof(*soft));
+    soft->cb_alloc = cb_alloc;
+    soft->alloc_ud = ud;
+    soft->nthreads = 1;
+    lock_init(&soft->lock);
+    cond_init(&soft->start);
+    cond_init(&soft->done);
+
+    soft->linetex = (float*)soft_realloc(soft, NULL, 0, sizeof(float) * (linetex_size + 2) * (linetex_size + 2));
+    if (soft->linetex == NULL) {
+        vector_display_soft_delete(soft);
+        return -1;
+    }
+    soft->linetex_size = linetex_size;
+    for (y = -1; y <= linetex_size; y++) {
+        for (x = -1; x <= linetex_size; x++) {
+            int texel = min(max(x, 0), linetex_size - 1) + min(max(y, 0), linetex_size - 1) * linetex_size;
+            soft->linetex[(x + 1) + (y + 1) * (linetex_size + 2)] = linetex[4*texel + 3] / 255.0f;
+        }
+    }
+
+    // with fewer workers than asked for, the ones that started do the work
+    if (nthreads > 1) {
+        soft->workers = (worker_t*)soft_realloc(soft, NULL, 0, sizeof(worker_t) * (nthreads - 1));
+        if (soft->workers == NULL) {
+            vector_display_soft_delete(soft);
+            return -1;
+        }
+        soft->cworkers = nthreads - 1;
+        for (i = 0; i < nthreads - 1; i++) {
+            soft->workers[i].soft  = soft;
+            soft->workers[i].index = i + 1;
+            if (start_worker(&soft->workers[i]) < 0) break;
+            soft->nthreads++;
+        }
+    }
+
+    *out_soft = soft;
+    return 0;
+}
+
+void vector_display_soft_delete(vector_display_soft_t *soft) {
+    int i;
+    if (soft == NULL) return;
+
+    lock(&soft->lock);
+    soft->quit = 1;
+    cond_broadcast(&soft->start);
+    unlock(&soft->lock);
+    for (i = 0; i < soft->nthreads - 1; i++) {
+        join_worker(&soft->workers[i]);
+    }
+    cond_destroy(&soft->done);
+    cond_destroy(&soft->start);
+    lock_destroy(&soft->lock);
+
+    free_image(soft, &soft->scene);
+    free_image(soft, &soft->accum);
+    free_image(soft, &soft->glow[0]);
+    free_image(soft, &soft->glow[1]);
+    for (i = 0; i < VECTOR_DISPLAY_MAX_BLOOM_LEVELS; i++) {
+        free_image(soft, &soft->bloom[i]);
+    }
+    soft_free(soft, soft->workers, sizeof(worker_t) * soft->cworkers);
+    soft_free(soft, soft->linetex, sizeof(float) * (soft->linetex_size + 2) * (soft->linetex_size + 2));
+    soft_free(soft, soft->triangles, sizeof(vector_display_soft_triangle_t) * soft->ctriangles);
+    soft_free(soft, soft->prepared, sizeof(prepared_t) * soft->cprepared);
+    soft_free(soft, soft->binned, sizeof(int) * soft->cbinned);
+    soft_free(soft, soft->band_first, sizeof(int) * soft->cbands);
+    soft_free(soft, soft->band_fill, sizeof(int) * soft->cbands);
+    soft_free(soft, soft->scratch, sizeof(float) * soft->scratch_floats * soft->nthreads);
+    soft_free(soft, soft->pixels, (size_t)4 * soft->width * soft->height);
+    soft->cb_alloc(soft->alloc_ud, soft, sizeof(vector_display_soft_t), 0);
+}
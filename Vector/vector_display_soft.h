@@ -0,0 +1,79 @@
+//
+//  vector_display_soft.h
+//  Vector
+//
+//  Renders the display's tessellated beams on the CPU, for displays set up
+//  with vector_display_setup_software. Nothing here touches OpenGL.
+//
+//  Each update hands over the frame's triangles, already faded by their age
+//  in the decay history. They are added into a float scene, which is then
+//  faded into the accumulated frames, glowed and composited the same way the
+//  OpenGL path does it, into 8-bit RGBA pixels. Rows are split into bands
+//  shared out over a pool of threads, and the passes over whole rows use the
+//  vf_t vectors of vector_display_simd.h.
+//
+
+#ifndef Vector_vector_display_soft_h
+#define Vector_vector_display_soft_h
+
+#include "vector_display.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct vector_display_soft vector_display_soft_t;
+
+// a triangle of a beam, in pixels from the top left of the display
+typedef struct {
+    float x[3], y[3];
+    float r[3], g[3], b[3], a[3];              // color, a scaled by the fade of the frame
+    float u[3], v[3];                          // line texture coordinates
+} vector_display_soft_triangle_t;
+
+// how to make a frame from the triangles
+typedef struct {
+    int width, height;
+    int glow_width, glow_height;
+
+    double beam_falloff;                       // beam profile worked out as in the beam programs, if > 0
+
+    int accumulate;                            // fade earlier frames into an accumulation buffer
+    double decay;
+    double initial_decay;
+
+    double brightness;
+    int blur_radius;                           // blur kernel taps 0 to radius, symmetric around tap 0
+    const double *blur_weights;
+
+    int bloom_levels;                          // glow through the bloom chain instead, if > 0
+    int bloom_width[VECTOR_DISPLAY_MAX_BLOOM_LEVELS];
+    int bloom_height[VECTOR_DISPLAY_MAX_BLOOM_LEVELS];
+    const double *bloom_weights;
+    double bloom_gain;
+} vector_display_soft_frame_t;
+
+//
+// nthreads is the number of threads rendering, including the caller's; 0
+// picks one per processor. linetex is the RGBA line texture, linetex_size
+// texels square. Memory comes from cb_alloc.
+//
+int vector_display_soft_new(vector_display_soft_t **out_soft, int nthreads,
+                            const unsigned char *linetex, int linetex_size,
+                            vector_display_alloc_cb_t cb_alloc, void *ud);
+void vector_display_soft_delete(vector_display_soft_t *soft);
+
+// room for n more triangles of the frame, or NULL if it can't be had
+vector_display_soft_triangle_t *vector_display_soft_add_triangles(vector_display_soft_t *soft, int n);
+
+// render the triangles added since the last frame, and forget them
+int vector_display_soft_render(vector_display_soft_t *soft, const vector_display_soft_frame_t *frame);
+
+// the last frame rendered, RGBA with rows from the top, stride bytes apart
+const unsigned char *vector_display_soft_pixels(vector_display_soft_t *soft, int *out_stride);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
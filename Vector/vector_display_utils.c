@@ -34,17 +34,35 @@ void vector_display_debugf(const char *fmt, ...) {
 
 // NOTE: returns 0 on failure
 GLuint vector_display_load_shader(GLenum type, const char *shaderSrc) {
+    return vector_display_load_shader_version(type, NULL, shaderSrc);
+}
+
+//
+// Start compiling a shader, without waiting to see whether it compiled.
+//
+static GLuint submit_shader(GLenum type, const char *version, const char *shaderSrc) {
     GLuint shader;
-    GLint compiled;
+    const char *sources[] = { version, shaderSrc };
     
     shader = glCreateShader(type);
     if(shader == 0)
         return 0;
 
-    glShaderSource(shader, 1, &shaderSrc, NULL);
+    if (version != NULL) {
+        glShaderSource(shader, 2, sources, NULL);
+    } else {
+        glShaderSource(shader, 1, &shaderSrc, NULL);
+    }
     glCompileShader(shader);
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    return shader;
+}
 
+//
+// Log why a shader didn't compile. Returns -1 if it didn't.
+//
+static int check_shader_compile(GLuint shader) {
+    GLint compiled;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
     if(!compiled) {
         GLint infoLen = 0;
         glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLen);
@@ -54,6 +72,19 @@ GLuint vector_display_load_shader(GLenum type, const char *shaderSrc) {
             vector_display_debugf("Error compiling shader:\n%s\n", infoLog);
             free(infoLog);
         }
+        return -1;
+    }
+    return 0;
+}
+
+GLuint vector_display_load_shader_version(GLenum type, const char *version, const char *shaderSrc) {
+    GLuint shader;
+
+    shader = submit_shader(type, version, shaderSrc);
+    if(shader == 0)
+        return 0;
+
+    if(check_shader_compile(shader) < 0) {
         glDeleteShader(shader);
         return 0;
     }
@@ -85,6 +116,306 @@ int vector_display_check_program_link(GLuint program) {
     return 0;
 }
 
+//
+// The version of the current context. Returns 0 if it can't be read.
+//
+int vector_display_gl_version(int *out_major, int *out_minor, int *out_es) {
+    const char *version = (const char*)glGetString(GL_VERSION);
+    *out_major = *out_minor = *out_es = 0;
+    if (version == NULL) return 0;
+    if (sscanf(version, "OpenGL ES %d.%d", out_major, out_minor) == 2) {
+        *out_es = 1;
+        return 1;
+    }
+    return sscanf(version, "%d.%d", out_major, out_minor) == 2;
+}
+
+//
+// Whether the context has an extension. OpenGL 3.0 and later list them one at
+// a time, since core profiles don't return the extension string.
+//
+int vector_display_has_extension(const char *name) {
+    int major, minor, es;
+    size_t len = strlen(name);
+    const char *extensions, *found;
+    if (!vector_display_gl_version(&major, &minor, &es)) return 0;
+#if defined(GL_ES_VERSION_3_0) || defined(GL_VERSION_3_0)
+    if (major >= 3) {
+        GLint i, n = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &n);
+        for (i = 0; i < n; i++) {
+            const char *extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+            if (extension != NULL && strcmp(extension, name) == 0) return 1;
+        }
+        return 0;
+    }
+#endif
+    extensions = (const char*)glGetString(GL_EXTENSIONS);
+    if (extensions == NULL) return 0;
+    for (found = extensions; (found = strstr(found, name)) != NULL; found += len) {
+        // a whole name in the space separated list, not part of a longer one
+        if ((found == extensions || found[-1] == ' ') && (found[len] == ' ' || found[len] == '\0')) return 1;
+    }
+    return 0;
+}
+
+// program binaries come with OpenGL 4.1 and OpenGL ES 3.0, or OES_get_program_binary on ES 2.0
+#if defined(GL_ES_VERSION_3_0) || defined(GL_VERSION_4_1)
+#    define HAVE_PROGRAM_BINARY 1
+#elif defined(GL_OES_get_program_binary)
+#    define HAVE_PROGRAM_BINARY 1
+#    define glGetProgramBinary            glGetProgramBinaryOES
+#    define glProgramBinary               glProgramBinaryOES
+#    define GL_PROGRAM_BINARY_LENGTH      GL_PROGRAM_BINARY_LENGTH_OES
+#    define GL_NUM_PROGRAM_BINARY_FORMATS GL_NUM_PROGRAM_BINARY_FORMATS_OES
+#endif
+
+static char program_cache_dir[1024];
+
+int vector_display_set_program_cache(const char *dir) {
+    if (dir == NULL) {
+        program_cache_dir[0] = '\0';
+        return 0;
+    }
+    if (strlen(dir) >= sizeof(program_cache_dir)) return -1;
+    strcpy(program_cache_dir, dir);
+    return 0;
+}
+
+#if HAVE_PROGRAM_BINARY
+#define PROGRAM_CACHE_MAGIC   (0x42504456)     // "VDPB"
+#define PROGRAM_CACHE_VERSION (1)
+
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int format;
+    unsigned int length;
+} program_cache_header_t;
+
+static unsigned long long hash_string(unsigned long long hash, const char *s) {
+    // FNV-1a, including the terminating 0 so that strings can't run together
+    if (s == NULL) s = "";
+    do {
+        hash ^= (unsigned char)*s;
+        hash *= 0x100000001b3ULL;
+    } while (*s++ != '\0');
+    return hash;
+}
+
+//
+// Whether the context can hand out program binaries. Returns 0 if it can't.
+//
+static int program_binary_supported(void) {
+    int major, minor, es;
+    GLint nformats = 0;
+    if (!vector_display_gl_version(&major, &minor, &es)) return 0;
+    if (!(es ? major >= 3 : major > 4 || (major == 4 && minor >= 1)) &&
+        !vector_display_has_extension("GL_OES_get_program_binary") && !vector_display_has_extension("GL_ARB_get_program_binary")) return 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nformats);
+    return nformats > 0;
+}
+
+//
+// The key of a program in the cache: its sources and attributes, and the
+// driver that compiled it, hashed.
+//
+static unsigned long long program_cache_key(const char *version, const char *vertexSrc, const char *fragmentSrc,
+                                            const vector_display_attrib_t *attribs, int nattribs) {
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+    char index[16];
+    int i;
+    hash = hash_string(hash, (const char*)glGetString(GL_VENDOR));
+    hash = hash_string(hash, (const char*)glGetString(GL_RENDERER));
+    hash = hash_string(hash, (const char*)glGetString(GL_VERSION));
+    hash = hash_string(hash, (const char*)glGetString(GL_SHADING_LANGUAGE_VERSION));
+    hash = hash_string(hash, version);
+    hash = hash_string(hash, vertexSrc);
+    hash = hash_string(hash, fragmentSrc);
+    for (i = 0; i < nattribs; i++) {
+        snprintf(index, sizeof(index), "%u", (unsigned)attribs[i].index);
+        hash = hash_string(hash, index);
+        hash = hash_string(hash, attribs[i].name);
+    }
+    return hash;
+}
+
+static void program_cache_path(char *path, size_t size, unsigned long long key) {
+    snprintf(path, size, "%s/vector_display_%016llx.bin", program_cache_dir, key);
+}
+
+//
+// Load a program from the cache. Returns 0 if it isn't there, or if the
+// driver rejects it.
+//
+static GLuint load_program_binary(unsigned long long key) {
+    program_cache_header_t header;
+    GLuint program = 0;
+    GLint linked = 0;
+    char path[1100];
+    void *binary;
+    FILE *f;
+    program_cache_path(path, sizeof(path), key);
+    f = fopen(path, "rb");
+    if (f == NULL) return 0;
+    if (fread(&header, sizeof(header), 1, f) == 1 &&
+        header.magic == PROGRAM_CACHE_MAGIC && header.version == PROGRAM_CACHE_VERSION && header.length > 0 &&
+        (binary = malloc(header.length)) != NULL) {
+        if (fread(binary, header.length, 1, f) == 1 && (program = glCreateProgram()) != 0) {
+            glProgramBinary(program, header.format, binary, header.length);
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (!linked) {
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+        free(binary);
+    }
+    fclose(f);
+    return program;
+}
+
+//
+// Save a linked program to the cache. It is written under another name and
+// renamed, so that a partly written file is never loaded.
+//
+static void save_program_binary(unsigned long long key, GLuint program) {
+    program_cache_header_t header;
+    GLint length = 0;
+    GLenum format;
+    char path[1100], tmppath[1100];
+    void *binary;
+    FILE *f;
+    program_cache_path(path, sizeof(path), key);
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0 || (binary = malloc(length)) == NULL) return;
+    glGetProgramBinary(program, length, &length, &format, binary);
+    header.magic   = PROGRAM_CACHE_MAGIC;
+    header.version = PROGRAM_CACHE_VERSION;
+    header.format  = format;
+    header.length  = length;
+    snprintf(tmppath, sizeof(tmppath), "%.1090s.tmp", path);
+    if (length > 0 && (f = fopen(tmppath, "wb")) != NULL) {
+        int ok = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(binary, length, 1, f) == 1;
+        ok = fclose(f) == 0 && ok;
+        if (ok && rename(tmppath, path) != 0) {
+            // some platforms won't rename over a file
+            remove(path);
+            ok = rename(tmppath, path) == 0;
+        }
+        if (!ok) {
+            remove(tmppath);
+            vector_display_debugf("couldn't write program cache file %s", path);
+        }
+    }
+    free(binary);
+}
+#endif
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+//
+// Start building a program from a vertex and a fragment shader, with attribs
+// bound to their indices. version is the "#version ..." line of both, or
+// NULL. Nothing waits for the driver to compile or link, so with
+// KHR_parallel_shader_compile the work is done on the driver's threads.
+// With a program cache, programs are loaded from it when they can be.
+//
+int vector_display_begin_program(vector_display_program_t *build, const char *version, const char *vertexSrc,
+                                 const char *fragmentSrc, const vector_display_attrib_t *attribs, int nattribs) {
+    int i;
+    memset(build, 0, sizeof(*build));
+#if HAVE_PROGRAM_BINARY
+    build->cache = program_cache_dir[0] != '\0' && program_binary_supported();
+    if (build->cache) {
+        build->cache_key = program_cache_key(version, vertexSrc, fragmentSrc, attribs, nattribs);
+        build->program   = load_program_binary(build->cache_key);
+        if (build->program != 0) {
+            build->cache = 0;
+            return 0;
+        }
+    }
+#endif
+    build->parallel = vector_display_has_extension("GL_KHR_parallel_shader_compile") || vector_display_has_extension("GL_ARB_parallel_shader_compile");
+
+    build->vertex_shader   = submit_shader(GL_VERTEX_SHADER,   version, vertexSrc);
+    build->fragment_shader = submit_shader(GL_FRAGMENT_SHADER, version, fragmentSrc);
+    build->program         = glCreateProgram();
+    if (build->vertex_shader == 0 || build->fragment_shader == 0 || build->program == 0) {
+        if (build->vertex_shader)   glDeleteShader(build->vertex_shader);
+        if (build->fragment_shader) glDeleteShader(build->fragment_shader);
+        if (build->program)         glDeleteProgram(build->program);
+        memset(build, 0, sizeof(*build));
+        return -1;
+    }
+    glAttachShader(build->program, build->vertex_shader);
+    glAttachShader(build->program, build->fragment_shader);
+    for (i = 0; i < nattribs; i++) {
+        glBindAttribLocation(build->program, attribs[i].index, attribs[i].name);
+    }
+#if HAVE_PROGRAM_BINARY && defined(GL_PROGRAM_BINARY_RETRIEVABLE_HINT)
+    if (build->cache) glProgramParameteri(build->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+    glLinkProgram(build->program);
+    return 0;
+}
+
+//
+// Whether vector_display_end_program can be called without waiting for the
+// driver. Without KHR_parallel_shader_compile there is no telling, so this is
+// always true.
+//
+int vector_display_program_ready(const vector_display_program_t *build) {
+    GLint done = GL_TRUE;
+    if (build->vertex_shader != 0 && build->parallel) {
+        glGetProgramiv(build->program, GL_COMPLETION_STATUS_KHR, &done);
+    }
+    return done != GL_FALSE;
+}
+
+//
+// Finish building a program, waiting for it to link, and save it to the
+// program cache.
+//
+// NOTE: returns 0 on failure
+GLuint vector_display_end_program(vector_display_program_t *build) {
+    GLuint program = build->program;
+    GLint linked;
+    if (build->vertex_shader != 0) {
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            // report why the shaders didn't compile, if they didn't, before why the program didn't link
+            check_shader_compile(build->vertex_shader);
+            check_shader_compile(build->fragment_shader);
+            vector_display_check_program_link(program);
+            glDeleteProgram(program);
+            program = 0;
+        }
+        // the shaders go with the program
+        glDeleteShader(build->vertex_shader);
+        glDeleteShader(build->fragment_shader);
+    }
+#if HAVE_PROGRAM_BINARY
+    if (build->cache && program != 0) save_program_binary(build->cache_key, program);
+#endif
+    memset(build, 0, sizeof(*build));
+    return program;
+}
+
+//
+// Build a program in one go. With a program cache, programs are saved to it
+// when they are compiled.
+//
+// NOTE: returns 0 on failure
+GLuint vector_display_load_program(const char *version, const char *vertexSrc, const char *fragmentSrc,
+                                   const vector_display_attrib_t *attribs, int nattribs) {
+    vector_display_program_t build;
+    if (vector_display_begin_program(&build, version, vertexSrc, fragmentSrc, attribs, nattribs) < 0) return 0;
+    return vector_display_end_program(&build);
+}
+
 // -15 stored using a single precision bias of 127
 const unsigned int  HALF_FLOAT_MIN_BIASED_EXP_AS_SINGLE_FP_EXP = 0x38000000;
 // max exponent value in single precision that will be converted
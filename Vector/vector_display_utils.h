@@ -16,8 +16,37 @@ extern "C" {
 #endif
 
 GLuint vector_display_load_shader(GLenum type, const char *shaderSrc);
+GLuint vector_display_load_shader_version(GLenum type, const char *version, const char *shaderSrc);   // version: "#version ..." line, or NULL
 void vector_display_check_error(const char *desc);
 int vector_display_check_program_link(GLuint program);
+int vector_display_gl_version(int *out_major, int *out_minor, int *out_es);   // returns 0 if it can't be read
+int vector_display_has_extension(const char *name);                           // whether the current context has an extension
+
+// an attribute bound to an index before linking
+typedef struct {
+    GLuint index;
+    const char *name;
+} vector_display_attrib_t;
+
+// a program being compiled and linked
+typedef struct {
+    GLuint program;
+    GLuint vertex_shader;                   // 0 once the program is loaded from the program cache
+    GLuint fragment_shader;
+    int parallel;                           // completion can be polled, with KHR_parallel_shader_compile
+    int cache;                              // save to the program cache once linked, under cache_key
+    unsigned long long cache_key;
+} vector_display_program_t;
+
+// compile and link a program, or load it from the program cache; returns 0 on failure
+GLuint vector_display_load_program(const char *version, const char *vertexSrc, const char *fragmentSrc,
+                                   const vector_display_attrib_t *attribs, int nattribs);
+
+// the same in steps: begin never waits for the driver, and end only waits if the program isn't ready
+int vector_display_begin_program(vector_display_program_t *build, const char *version, const char *vertexSrc,
+                                 const char *fragmentSrc, const vector_display_attrib_t *attribs, int nattribs);
+int vector_display_program_ready(const vector_display_program_t *build);
+GLuint vector_display_end_program(vector_display_program_t *build);     // returns 0 on failure
 
 void vector_display_debugf(const char *fmt, ...);
 
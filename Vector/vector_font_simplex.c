@@ -1,615 +1,1320 @@
+#include <stdlib.h>
+#include <string.h>
+
 #include "vector_font_simplex.h"
 #include "vector_display.h"
 
-static int simplex[95][112] = {
-    0,16, /* Ascii 32 */
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,10, /* Ascii 33 */
-    5,21, 5, 7,-1,-1, 5, 2, 4, 1, 5, 0, 6, 1, 5, 2,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    5,16, /* Ascii 34 */
-    4,21, 4,14,-1,-1,12,21,12,14,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   11,21, /* Ascii 35 */
-   11,25, 4,-7,-1,-1,17,25,10,-7,-1,-1, 4,12,18,12,-1,-1, 3, 6,17, 6,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   26,20, /* Ascii 36 */
-    8,25, 8,-4,-1,-1,12,25,12,-4,-1,-1,17,18,15,20,12,21, 8,21, 5,20, 3,
-   18, 3,16, 4,14, 5,13, 7,12,13,10,15, 9,16, 8,17, 6,17, 3,15, 1,12, 0,
-    8, 0, 5, 1, 3, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   31,24, /* Ascii 37 */
-   21,21, 3, 0,-1,-1, 8,21,10,19,10,17, 9,15, 7,14, 5,14, 3,16, 3,18, 4,
-   20, 6,21, 8,21,10,20,13,19,16,19,19,20,21,21,-1,-1,17, 7,15, 6,14, 4,
-   14, 2,16, 0,18, 0,20, 1,21, 3,21, 5,19, 7,17, 7,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   34,26, /* Ascii 38 */
-   23,12,23,13,22,14,21,14,20,13,19,11,17, 6,15, 3,13, 1,11, 0, 7, 0, 5,
-    1, 4, 2, 3, 4, 3, 6, 4, 8, 5, 9,12,13,13,14,14,16,14,18,13,20,11,21,
-    9,20, 8,18, 8,16, 9,13,11,10,16, 3,18, 1,20, 0,22, 0,23, 1,23, 2,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    7,10, /* Ascii 39 */
-    5,19, 4,20, 5,21, 6,20, 6,18, 5,16, 4,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   10,14, /* Ascii 40 */
-   11,25, 9,23, 7,20, 5,16, 4,11, 4, 7, 5, 2, 7,-2, 9,-5,11,-7,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   10,14, /* Ascii 41 */
-    3,25, 5,23, 7,20, 9,16,10,11,10, 7, 9, 2, 7,-2, 5,-5, 3,-7,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,16, /* Ascii 42 */
-    8,21, 8, 9,-1,-1, 3,18,13,12,-1,-1,13,18, 3,12,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    5,26, /* Ascii 43 */
-   13,18,13, 0,-1,-1, 4, 9,22, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,10, /* Ascii 44 */
-    6, 1, 5, 0, 4, 1, 5, 2, 6, 1, 6,-1, 5,-3, 4,-4,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    2,26, /* Ascii 45 */
-    4, 9,22, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    5,10, /* Ascii 46 */
-    5, 2, 4, 1, 5, 0, 6, 1, 5, 2,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    2,22, /* Ascii 47 */
-   20,25, 2,-7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   17,20, /* Ascii 48 */
-    9,21, 6,20, 4,17, 3,12, 3, 9, 4, 4, 6, 1, 9, 0,11, 0,14, 1,16, 4,17,
-    9,17,12,16,17,14,20,11,21, 9,21,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    4,20, /* Ascii 49 */
-    6,17, 8,18,11,21,11, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   14,20, /* Ascii 50 */
-    4,16, 4,17, 5,19, 6,20, 8,21,12,21,14,20,15,19,16,17,16,15,15,13,13,
-   10, 3, 0,17, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   15,20, /* Ascii 51 */
-    5,21,16,21,10,13,13,13,15,12,16,11,17, 8,17, 6,16, 3,14, 1,11, 0, 8,
-    0, 5, 1, 4, 2, 3, 4,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    6,20, /* Ascii 52 */
-   13,21, 3, 7,18, 7,-1,-1,13,21,13, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   17,20, /* Ascii 53 */
-   15,21, 5,21, 4,12, 5,13, 8,14,11,14,14,13,16,11,17, 8,17, 6,16, 3,14,
-    1,11, 0, 8, 0, 5, 1, 4, 2, 3, 4,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   23,20, /* Ascii 54 */
-   16,18,15,20,12,21,10,21, 7,20, 5,17, 4,12, 4, 7, 5, 3, 7, 1,10, 0,11,
-    0,14, 1,16, 3,17, 6,17, 7,16,10,14,12,11,13,10,13, 7,12, 5,10, 4, 7,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    5,20, /* Ascii 55 */
-   17,21, 7, 0,-1,-1, 3,21,17,21,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   29,20, /* Ascii 56 */
-    8,21, 5,20, 4,18, 4,16, 5,14, 7,13,11,12,14,11,16, 9,17, 7,17, 4,16,
-    2,15, 1,12, 0, 8, 0, 5, 1, 4, 2, 3, 4, 3, 7, 4, 9, 6,11, 9,12,13,13,
-   15,14,16,16,16,18,15,20,12,21, 8,21,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   23,20, /* Ascii 57 */
-   16,14,15,11,13, 9,10, 8, 9, 8, 6, 9, 4,11, 3,14, 3,15, 4,18, 6,20, 9,
-   21,10,21,13,20,15,18,16,14,16, 9,15, 4,13, 1,10, 0, 8, 0, 5, 1, 4, 3,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   11,10, /* Ascii 58 */
-    5,14, 4,13, 5,12, 6,13, 5,14,-1,-1, 5, 2, 4, 1, 5, 0, 6, 1, 5, 2,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   14,10, /* Ascii 59 */
-    5,14, 4,13, 5,12, 6,13, 5,14,-1,-1, 6, 1, 5, 0, 4, 1, 5, 2, 6, 1, 6,
-   -1, 5,-3, 4,-4,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    3,24, /* Ascii 60 */
-   20,18, 4, 9,20, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    5,26, /* Ascii 61 */
-    4,12,22,12,-1,-1, 4, 6,22, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    3,24, /* Ascii 62 */
-    4,18,20, 9, 4, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   20,18, /* Ascii 63 */
-    3,16, 3,17, 4,19, 5,20, 7,21,11,21,13,20,14,19,15,17,15,15,14,13,13,
-   12, 9,10, 9, 7,-1,-1, 9, 2, 8, 1, 9, 0,10, 1, 9, 2,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   55,27, /* Ascii 64 */
-   18,13,17,15,15,16,12,16,10,15, 9,14, 8,11, 8, 8, 9, 6,11, 5,14, 5,16,
-    6,17, 8,-1,-1,12,16,10,14, 9,11, 9, 8,10, 6,11, 5,-1,-1,18,16,17, 8,
-   17, 6,19, 5,21, 5,23, 7,24,10,24,12,23,15,22,17,20,19,18,20,15,21,12,
-   21, 9,20, 7,19, 5,17, 4,15, 3,12, 3, 9, 4, 6, 5, 4, 7, 2, 9, 1,12, 0,
-   15, 0,18, 1,20, 2,21, 3,-1,-1,19,16,18, 8,18, 6,19, 5,
-    8,18, /* Ascii 65 */
-    9,21, 1, 0,-1,-1, 9,21,17, 0,-1,-1, 4, 7,14, 7,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   23,21, /* Ascii 66 */
-    4,21, 4, 0,-1,-1, 4,21,13,21,16,20,17,19,18,17,18,15,17,13,16,12,13,
-   11,-1,-1, 4,11,13,11,16,10,17, 9,18, 7,18, 4,17, 2,16, 1,13, 0, 4, 0,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   18,21, /* Ascii 67 */
-   18,16,17,18,15,20,13,21, 9,21, 7,20, 5,18, 4,16, 3,13, 3, 8, 4, 5, 5,
-    3, 7, 1, 9, 0,13, 0,15, 1,17, 3,18, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   15,21, /* Ascii 68 */
-    4,21, 4, 0,-1,-1, 4,21,11,21,14,20,16,18,17,16,18,13,18, 8,17, 5,16,
-    3,14, 1,11, 0, 4, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   11,19, /* Ascii 69 */
-    4,21, 4, 0,-1,-1, 4,21,17,21,-1,-1, 4,11,12,11,-1,-1, 4, 0,17, 0,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,18, /* Ascii 70 */
-    4,21, 4, 0,-1,-1, 4,21,17,21,-1,-1, 4,11,12,11,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   22,21, /* Ascii 71 */
-   18,16,17,18,15,20,13,21, 9,21, 7,20, 5,18, 4,16, 3,13, 3, 8, 4, 5, 5,
-    3, 7, 1, 9, 0,13, 0,15, 1,17, 3,18, 5,18, 8,-1,-1,13, 8,18, 8,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,22, /* Ascii 72 */
-    4,21, 4, 0,-1,-1,18,21,18, 0,-1,-1, 4,11,18,11,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    2, 8, /* Ascii 73 */
-    4,21, 4, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   10,16, /* Ascii 74 */
-   12,21,12, 5,11, 2,10, 1, 8, 0, 6, 0, 4, 1, 3, 2, 2, 5, 2, 7,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,21, /* Ascii 75 */
-    4,21, 4, 0,-1,-1,18,21, 4, 7,-1,-1, 9,12,18, 0,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    5,17, /* Ascii 76 */
-    4,21, 4, 0,-1,-1, 4, 0,16, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   11,24, /* Ascii 77 */
-    4,21, 4, 0,-1,-1, 4,21,12, 0,-1,-1,20,21,12, 0,-1,-1,20,21,20, 0,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,22, /* Ascii 78 */
-    4,21, 4, 0,-1,-1, 4,21,18, 0,-1,-1,18,21,18, 0,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   21,22, /* Ascii 79 */
-    9,21, 7,20, 5,18, 4,16, 3,13, 3, 8, 4, 5, 5, 3, 7, 1, 9, 0,13, 0,15,
-    1,17, 3,18, 5,19, 8,19,13,18,16,17,18,15,20,13,21, 9,21,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   13,21, /* Ascii 80 */
-    4,21, 4, 0,-1,-1, 4,21,13,21,16,20,17,19,18,17,18,14,17,12,16,11,13,
-   10, 4,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   24,22, /* Ascii 81 */
-    9,21, 7,20, 5,18, 4,16, 3,13, 3, 8, 4, 5, 5, 3, 7, 1, 9, 0,13, 0,15,
-    1,17, 3,18, 5,19, 8,19,13,18,16,17,18,15,20,13,21, 9,21,-1,-1,12, 4,
-   18,-2,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   16,21, /* Ascii 82 */
-    4,21, 4, 0,-1,-1, 4,21,13,21,16,20,17,19,18,17,18,15,17,13,16,12,13,
-   11, 4,11,-1,-1,11,11,18, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   20,20, /* Ascii 83 */
-   17,18,15,20,12,21, 8,21, 5,20, 3,18, 3,16, 4,14, 5,13, 7,12,13,10,15,
-    9,16, 8,17, 6,17, 3,15, 1,12, 0, 8, 0, 5, 1, 3, 3,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    5,16, /* Ascii 84 */
-    8,21, 8, 0,-1,-1, 1,21,15,21,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   10,22, /* Ascii 85 */
-    4,21, 4, 6, 5, 3, 7, 1,10, 0,12, 0,15, 1,17, 3,18, 6,18,21,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    5,18, /* Ascii 86 */
-    1,21, 9, 0,-1,-1,17,21, 9, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   11,24, /* Ascii 87 */
-    2,21, 7, 0,-1,-1,12,21, 7, 0,-1,-1,12,21,17, 0,-1,-1,22,21,17, 0,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    5,20, /* Ascii 88 */
-    3,21,17, 0,-1,-1,17,21, 3, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    6,18, /* Ascii 89 */
-    1,21, 9,11, 9, 0,-1,-1,17,21, 9,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,20, /* Ascii 90 */
-   17,21, 3, 0,-1,-1, 3,21,17,21,-1,-1, 3, 0,17, 0,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   11,14, /* Ascii 91 */
-    4,25, 4,-7,-1,-1, 5,25, 5,-7,-1,-1, 4,25,11,25,-1,-1, 4,-7,11,-7,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    2,14, /* Ascii 92 */
-    0,21,14,-3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   11,14, /* Ascii 93 */
-    9,25, 9,-7,-1,-1,10,25,10,-7,-1,-1, 3,25,10,25,-1,-1, 3,-7,10,-7,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   10,16, /* Ascii 94 */
-    6,15, 8,18,10,15,-1,-1, 3,12, 8,17,13,12,-1,-1, 8,17, 8, 0,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    2,16, /* Ascii 95 */
-    0,-2,16,-2,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    7,10, /* Ascii 96 */
-    6,21, 5,20, 4,18, 4,16, 5,15, 6,16, 5,17,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   17,19, /* Ascii 97 */
-   15,14,15, 0,-1,-1,15,11,13,13,11,14, 8,14, 6,13, 4,11, 3, 8, 3, 6, 4,
-    3, 6, 1, 8, 0,11, 0,13, 1,15, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   17,19, /* Ascii 98 */
-    4,21, 4, 0,-1,-1, 4,11, 6,13, 8,14,11,14,13,13,15,11,16, 8,16, 6,15,
-    3,13, 1,11, 0, 8, 0, 6, 1, 4, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   14,18, /* Ascii 99 */
-   15,11,13,13,11,14, 8,14, 6,13, 4,11, 3, 8, 3, 6, 4, 3, 6, 1, 8, 0,11,
-    0,13, 1,15, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   17,19, /* Ascii 100 */
-   15,21,15, 0,-1,-1,15,11,13,13,11,14, 8,14, 6,13, 4,11, 3, 8, 3, 6, 4,
-    3, 6, 1, 8, 0,11, 0,13, 1,15, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   17,18, /* Ascii 101 */
-    3, 8,15, 8,15,10,14,12,13,13,11,14, 8,14, 6,13, 4,11, 3, 8, 3, 6, 4,
-    3, 6, 1, 8, 0,11, 0,13, 1,15, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,12, /* Ascii 102 */
-   10,21, 8,21, 6,20, 5,17, 5, 0,-1,-1, 2,14, 9,14,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   22,19, /* Ascii 103 */
-   15,14,15,-2,14,-5,13,-6,11,-7, 8,-7, 6,-6,-1,-1,15,11,13,13,11,14, 8,
-   14, 6,13, 4,11, 3, 8, 3, 6, 4, 3, 6, 1, 8, 0,11, 0,13, 1,15, 3,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   10,19, /* Ascii 104 */
-    4,21, 4, 0,-1,-1, 4,10, 7,13, 9,14,12,14,14,13,15,10,15, 0,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8, 8, /* Ascii 105 */
-    3,21, 4,20, 5,21, 4,22, 3,21,-1,-1, 4,14, 4, 0,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   11,10, /* Ascii 106 */
-    5,21, 6,20, 7,21, 6,22, 5,21,-1,-1, 6,14, 6,-3, 5,-6, 3,-7, 1,-7,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,17, /* Ascii 107 */
-    4,21, 4, 0,-1,-1,14,14, 4, 4,-1,-1, 8, 8,15, 0,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    2, 8, /* Ascii 108 */
-    4,21, 4, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   18,30, /* Ascii 109 */
-    4,14, 4, 0,-1,-1, 4,10, 7,13, 9,14,12,14,14,13,15,10,15, 0,-1,-1,15,
-   10,18,13,20,14,23,14,25,13,26,10,26, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   10,19, /* Ascii 110 */
-    4,14, 4, 0,-1,-1, 4,10, 7,13, 9,14,12,14,14,13,15,10,15, 0,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   17,19, /* Ascii 111 */
-    8,14, 6,13, 4,11, 3, 8, 3, 6, 4, 3, 6, 1, 8, 0,11, 0,13, 1,15, 3,16,
-    6,16, 8,15,11,13,13,11,14, 8,14,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   17,19, /* Ascii 112 */
-    4,14, 4,-7,-1,-1, 4,11, 6,13, 8,14,11,14,13,13,15,11,16, 8,16, 6,15,
-    3,13, 1,11, 0, 8, 0, 6, 1, 4, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   17,19, /* Ascii 113 */
-   15,14,15,-7,-1,-1,15,11,13,13,11,14, 8,14, 6,13, 4,11, 3, 8, 3, 6, 4,
-    3, 6, 1, 8, 0,11, 0,13, 1,15, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,13, /* Ascii 114 */
-    4,14, 4, 0,-1,-1, 4, 8, 5,11, 7,13, 9,14,12,14,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   17,17, /* Ascii 115 */
-   14,11,13,13,10,14, 7,14, 4,13, 3,11, 4, 9, 6, 8,11, 7,13, 6,14, 4,14,
-    3,13, 1,10, 0, 7, 0, 4, 1, 3, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,12, /* Ascii 116 */
-    5,21, 5, 4, 6, 1, 8, 0,10, 0,-1,-1, 2,14, 9,14,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   10,19, /* Ascii 117 */
-    4,14, 4, 4, 5, 1, 7, 0,10, 0,12, 1,15, 4,-1,-1,15,14,15, 0,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    5,16, /* Ascii 118 */
-    2,14, 8, 0,-1,-1,14,14, 8, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   11,22, /* Ascii 119 */
-    3,14, 7, 0,-1,-1,11,14, 7, 0,-1,-1,11,14,15, 0,-1,-1,19,14,15, 0,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    5,17, /* Ascii 120 */
-    3,14,14, 0,-1,-1,14,14, 3, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    9,16, /* Ascii 121 */
-    2,14, 8, 0,-1,-1,14,14, 8, 0, 6,-4, 4,-6, 2,-7, 1,-7,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    8,17, /* Ascii 122 */
-   14,14, 3, 0,-1,-1, 3,14,14,14,-1,-1, 3, 0,14, 0,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   39,14, /* Ascii 123 */
-    9,25, 7,24, 6,23, 5,21, 5,19, 6,17, 7,16, 8,14, 8,12, 6,10,-1,-1, 7,
-   24, 6,22, 6,20, 7,18, 8,17, 9,15, 9,13, 8,11, 4, 9, 8, 7, 9, 5, 9, 3,
-    8, 1, 7, 0, 6,-2, 6,-4, 7,-6,-1,-1, 6, 8, 8, 6, 8, 4, 7, 2, 6, 1, 5,
-   -1, 5,-3, 6,-5, 7,-6, 9,-7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    2, 8, /* Ascii 124 */
-    4,25, 4,-7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   39,14, /* Ascii 125 */
-    5,25, 7,24, 8,23, 9,21, 9,19, 8,17, 7,16, 6,14, 6,12, 8,10,-1,-1, 7,
-   24, 8,22, 8,20, 7,18, 6,17, 5,15, 5,13, 6,11,10, 9, 6, 7, 5, 5, 5, 3,
-    6, 1, 7, 0, 8,-2, 8,-4, 7,-6,-1,-1, 8, 8, 6, 6, 6, 4, 7, 2, 8, 1, 9,
-   -1, 9,-3, 8,-5, 7,-6, 5,-7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   23,24, /* Ascii 126 */
-    3, 6, 3, 8, 4,11, 6,12, 8,12,10,11,14, 8,16, 7,18, 7,20, 8,21,10,-1,
-   -1, 3, 8, 4,10, 6,11, 8,11,10,10,14, 7,16, 6,18, 6,20, 7,21,10,21,12,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+//
+// The simplex font, packed.
+//
+// Each glyph is a run of strokes, and each stroke a run of points in
+// simplex_points. Stroke s covers points simplex_strokes[s] up to
+// simplex_strokes[s + 1], so the strokes of a glyph, and the points of its
+// strokes, are contiguous. Glyph boxes are left, bottom, right, top, with y
+// pointing up from the baseline.
+//
+typedef struct {
+    unsigned short first_stroke;
+    unsigned char  nstrokes;
+    signed char    spacing;
+    signed char    box[4];
+} simplex_glyph_t;
+
+#define SIMPLEX_MAX_POINTS  (52)            // in any one glyph
+#define SIMPLEX_MAX_STROKES (4)
+#define SIMPLEX_ASCENT      (25)            // highest point of any glyph
+#define SIMPLEX_DESCENT     (7)             // lowest point of any glyph, below the baseline
+#define SIMPLEX_LINE_HEIGHT (SIMPLEX_ASCENT + SIMPLEX_DESCENT)
+
+static const simplex_glyph_t simplex_glyphs[95] = {
+    {   0,  0, 16, {   0,   0,   0,   0 } }, /* Ascii 32 */
+    {   0,  2, 10, {   4,   0,   6,  21 } }, /* Ascii 33 */
+    {   2,  2, 16, {   4,  14,  12,  21 } }, /* Ascii 34 */
+    {   4,  4, 21, {   3,  -7,  18,  25 } }, /* Ascii 35 */
+    {   8,  3, 20, {   3,  -4,  17,  25 } }, /* Ascii 36 */
+    {  11,  3, 24, {   3,   0,  21,  21 } }, /* Ascii 37 */
+    {  14,  1, 26, {   3,   0,  23,  21 } }, /* Ascii 38 */
+    {  15,  1, 10, {   4,  15,   6,  21 } }, /* Ascii 39 */
+    {  16,  1, 14, {   4,  -7,  11,  25 } }, /* Ascii 40 */
+    {  17,  1, 14, {   3,  -7,  10,  25 } }, /* Ascii 41 */
+    {  18,  3, 16, {   3,   9,  13,  21 } }, /* Ascii 42 */
+    {  21,  2, 26, {   4,   0,  22,  18 } }, /* Ascii 43 */
+    {  23,  1, 10, {   4,  -4,   6,   2 } }, /* Ascii 44 */
+    {  24,  1, 26, {   4,   9,  22,   9 } }, /* Ascii 45 */
+    {  25,  1, 10, {   4,   0,   6,   2 } }, /* Ascii 46 */
+    {  26,  1, 22, {   2,  -7,  20,  25 } }, /* Ascii 47 */
+    {  27,  1, 20, {   3,   0,  17,  21 } }, /* Ascii 48 */
+    {  28,  1, 20, {   6,   0,  11,  21 } }, /* Ascii 49 */
+    {  29,  1, 20, {   3,   0,  17,  21 } }, /* Ascii 50 */
+    {  30,  1, 20, {   3,   0,  17,  21 } }, /* Ascii 51 */
+    {  31,  2, 20, {   3,   0,  18,  21 } }, /* Ascii 52 */
+    {  33,  1, 20, {   3,   0,  17,  21 } }, /* Ascii 53 */
+    {  34,  1, 20, {   4,   0,  17,  21 } }, /* Ascii 54 */
+    {  35,  2, 20, {   3,   0,  17,  21 } }, /* Ascii 55 */
+    {  37,  1, 20, {   3,   0,  17,  21 } }, /* Ascii 56 */
+    {  38,  1, 20, {   3,   0,  16,  21 } }, /* Ascii 57 */
+    {  39,  2, 10, {   4,   0,   6,  14 } }, /* Ascii 58 */
+    {  41,  2, 10, {   4,  -4,   6,  14 } }, /* Ascii 59 */
+    {  43,  1, 24, {   4,   0,  20,  18 } }, /* Ascii 60 */
+    {  44,  2, 26, {   4,   6,  22,  12 } }, /* Ascii 61 */
+    {  46,  1, 24, {   4,   0,  20,  18 } }, /* Ascii 62 */
+    {  47,  2, 18, {   3,   0,  15,  21 } }, /* Ascii 63 */
+    {  49,  4, 27, {   3,   0,  24,  21 } }, /* Ascii 64 */
+    {  53,  3, 18, {   1,   0,  17,  21 } }, /* Ascii 65 */
+    {  56,  3, 21, {   4,   0,  18,  21 } }, /* Ascii 66 */
+    {  59,  1, 21, {   3,   0,  18,  21 } }, /* Ascii 67 */
+    {  60,  2, 21, {   4,   0,  18,  21 } }, /* Ascii 68 */
+    {  62,  4, 19, {   4,   0,  17,  21 } }, /* Ascii 69 */
+    {  66,  3, 18, {   4,   0,  17,  21 } }, /* Ascii 70 */
+    {  69,  2, 21, {   3,   0,  18,  21 } }, /* Ascii 71 */
+    {  71,  3, 22, {   4,   0,  18,  21 } }, /* Ascii 72 */
+    {  74,  1,  8, {   4,   0,   4,  21 } }, /* Ascii 73 */
+    {  75,  1, 16, {   2,   0,  12,  21 } }, /* Ascii 74 */
+    {  76,  3, 21, {   4,   0,  18,  21 } }, /* Ascii 75 */
+    {  79,  2, 17, {   4,   0,  16,  21 } }, /* Ascii 76 */
+    {  81,  4, 24, {   4,   0,  20,  21 } }, /* Ascii 77 */
+    {  85,  3, 22, {   4,   0,  18,  21 } }, /* Ascii 78 */
+    {  88,  1, 22, {   3,   0,  19,  21 } }, /* Ascii 79 */
+    {  89,  2, 21, {   4,   0,  18,  21 } }, /* Ascii 80 */
+    {  91,  2, 22, {   3,  -2,  19,  21 } }, /* Ascii 81 */
+    {  93,  3, 21, {   4,   0,  18,  21 } }, /* Ascii 82 */
+    {  96,  1, 20, {   3,   0,  17,  21 } }, /* Ascii 83 */
+    {  97,  2, 16, {   1,   0,  15,  21 } }, /* Ascii 84 */
+    {  99,  1, 22, {   4,   0,  18,  21 } }, /* Ascii 85 */
+    { 100,  2, 18, {   1,   0,  17,  21 } }, /* Ascii 86 */
+    { 102,  4, 24, {   2,   0,  22,  21 } }, /* Ascii 87 */
+    { 106,  2, 20, {   3,   0,  17,  21 } }, /* Ascii 88 */
+    { 108,  2, 18, {   1,   0,  17,  21 } }, /* Ascii 89 */
+    { 110,  3, 20, {   3,   0,  17,  21 } }, /* Ascii 90 */
+    { 113,  4, 14, {   4,  -7,  11,  25 } }, /* Ascii 91 */
+    { 117,  1, 14, {   0,  -3,  14,  21 } }, /* Ascii 92 */
+    { 118,  4, 14, {   3,  -7,  10,  25 } }, /* Ascii 93 */
+    { 122,  3, 16, {   3,   0,  13,  18 } }, /* Ascii 94 */
+    { 125,  1, 16, {   0,  -2,  16,  -2 } }, /* Ascii 95 */
+    { 126,  1, 10, {   4,  15,   6,  21 } }, /* Ascii 96 */
+    { 127,  2, 19, {   3,   0,  15,  14 } }, /* Ascii 97 */
+    { 129,  2, 19, {   4,   0,  16,  21 } }, /* Ascii 98 */
+    { 131,  1, 18, {   3,   0,  15,  14 } }, /* Ascii 99 */
+    { 132,  2, 19, {   3,   0,  15,  21 } }, /* Ascii 100 */
+    { 134,  1, 18, {   3,   0,  15,  14 } }, /* Ascii 101 */
+    { 135,  2, 12, {   2,   0,  10,  21 } }, /* Ascii 102 */
+    { 137,  2, 19, {   3,  -7,  15,  14 } }, /* Ascii 103 */
+    { 139,  2, 19, {   4,   0,  15,  21 } }, /* Ascii 104 */
+    { 141,  2,  8, {   3,   0,   5,  22 } }, /* Ascii 105 */
+    { 143,  2, 10, {   1,  -7,   7,  22 } }, /* Ascii 106 */
+    { 145,  3, 17, {   4,   0,  15,  21 } }, /* Ascii 107 */
+    { 148,  1,  8, {   4,   0,   4,  21 } }, /* Ascii 108 */
+    { 149,  3, 30, {   4,   0,  26,  14 } }, /* Ascii 109 */
+    { 152,  2, 19, {   4,   0,  15,  14 } }, /* Ascii 110 */
+    { 154,  1, 19, {   3,   0,  16,  14 } }, /* Ascii 111 */
+    { 155,  2, 19, {   4,  -7,  16,  14 } }, /* Ascii 112 */
+    { 157,  2, 19, {   3,  -7,  15,  14 } }, /* Ascii 113 */
+    { 159,  2, 13, {   4,   0,  12,  14 } }, /* Ascii 114 */
+    { 161,  1, 17, {   3,   0,  14,  14 } }, /* Ascii 115 */
+    { 162,  2, 12, {   2,   0,  10,  21 } }, /* Ascii 116 */
+    { 164,  2, 19, {   4,   0,  15,  14 } }, /* Ascii 117 */
+    { 166,  2, 16, {   2,   0,  14,  14 } }, /* Ascii 118 */
+    { 168,  4, 22, {   3,   0,  19,  14 } }, /* Ascii 119 */
+    { 172,  2, 17, {   3,   0,  14,  14 } }, /* Ascii 120 */
+    { 174,  2, 16, {   1,  -7,  14,  14 } }, /* Ascii 121 */
+    { 176,  3, 17, {   3,   0,  14,  14 } }, /* Ascii 122 */
+    { 179,  3, 14, {   4,  -7,   9,  25 } }, /* Ascii 123 */
+    { 182,  1,  8, {   4,  -7,   4,  25 } }, /* Ascii 124 */
+    { 183,  3, 14, {   5,  -7,  10,  25 } }, /* Ascii 125 */
+    { 186,  2, 24, {   3,   6,  21,  12 } }, /* Ascii 126 */
+};
+
+static const unsigned short simplex_strokes[189] = {
+       0,   2, /* Ascii 33 */
+       7,   9, /* Ascii 34 */
+      11,  13,  15,  17, /* Ascii 35 */
+      19,  21,  23, /* Ascii 36 */
+      43,  45,  61, /* Ascii 37 */
+      72, /* Ascii 38 */
+     106, /* Ascii 39 */
+     113, /* Ascii 40 */
+     123, /* Ascii 41 */
+     133, 135, 137, /* Ascii 42 */
+     139, 141, /* Ascii 43 */
+     143, /* Ascii 44 */
+     151, /* Ascii 45 */
+     153, /* Ascii 46 */
+     158, /* Ascii 47 */
+     160, /* Ascii 48 */
+     177, /* Ascii 49 */
+     181, /* Ascii 50 */
+     195, /* Ascii 51 */
+     210, 213, /* Ascii 52 */
+     215, /* Ascii 53 */
+     232, /* Ascii 54 */
+     255, 257, /* Ascii 55 */
+     259, /* Ascii 56 */
+     288, /* Ascii 57 */
+     311, 316, /* Ascii 58 */
+     321, 326, /* Ascii 59 */
+     334, /* Ascii 60 */
+     337, 339, /* Ascii 61 */
+     341, /* Ascii 62 */
+     344, 358, /* Ascii 63 */
+     363, 376, 382, 411, /* Ascii 64 */
+     415, 417, 419, /* Ascii 65 */
+     421, 423, 432, /* Ascii 66 */
+     442, /* Ascii 67 */
+     460, 462, /* Ascii 68 */
+     474, 476, 478, 480, /* Ascii 69 */
+     482, 484, 486, /* Ascii 70 */
+     488, 507, /* Ascii 71 */
+     509, 511, 513, /* Ascii 72 */
+     515, /* Ascii 73 */
+     517, /* Ascii 74 */
+     527, 529, 531, /* Ascii 75 */
+     533, 535, /* Ascii 76 */
+     537, 539, 541, 543, /* Ascii 77 */
+     545, 547, 549, /* Ascii 78 */
+     551, /* Ascii 79 */
+     572, 574, /* Ascii 80 */
+     584, 605, /* Ascii 81 */
+     607, 609, 619, /* Ascii 82 */
+     621, /* Ascii 83 */
+     641, 643, /* Ascii 84 */
+     645, /* Ascii 85 */
+     655, 657, /* Ascii 86 */
+     659, 661, 663, 665, /* Ascii 87 */
+     667, 669, /* Ascii 88 */
+     671, 674, /* Ascii 89 */
+     676, 678, 680, /* Ascii 90 */
+     682, 684, 686, 688, /* Ascii 91 */
+     690, /* Ascii 92 */
+     692, 694, 696, 698, /* Ascii 93 */
+     700, 703, 706, /* Ascii 94 */
+     708, /* Ascii 95 */
+     710, /* Ascii 96 */
+     717, 719, /* Ascii 97 */
+     733, 735, /* Ascii 98 */
+     749, /* Ascii 99 */
+     763, 765, /* Ascii 100 */
+     779, /* Ascii 101 */
+     796, 801, /* Ascii 102 */
+     803, 810, /* Ascii 103 */
+     824, 826, /* Ascii 104 */
+     833, 838, /* Ascii 105 */
+     840, 845, /* Ascii 106 */
+     850, 852, 854, /* Ascii 107 */
+     856, /* Ascii 108 */
+     858, 860, 867, /* Ascii 109 */
+     874, 876, /* Ascii 110 */
+     883, /* Ascii 111 */
+     900, 902, /* Ascii 112 */
+     916, 918, /* Ascii 113 */
+     932, 934, /* Ascii 114 */
+     939, /* Ascii 115 */
+     956, 961, /* Ascii 116 */
+     963, 970, /* Ascii 117 */
+     972, 974, /* Ascii 118 */
+     976, 978, 980, 982, /* Ascii 119 */
+     984, 986, /* Ascii 120 */
+     988, 990, /* Ascii 121 */
+     996, 998,1000, /* Ascii 122 */
+    1002,1012,1029, /* Ascii 123 */
+    1039, /* Ascii 124 */
+    1041,1051,1068, /* Ascii 125 */
+    1078,1089, /* Ascii 126 */
+    1100,
+};
+
+static const signed char simplex_points[1100][2] = {
+    /* Ascii 33 */
+    {  5, 21}, {  5,  7}, {  5,  2}, {  4,  1}, {  5,  0}, {  6,  1}, {  5,  2},
+    /* Ascii 34 */
+    {  4, 21}, {  4, 14}, { 12, 21}, { 12, 14},
+    /* Ascii 35 */
+    { 11, 25}, {  4, -7}, { 17, 25}, { 10, -7}, {  4, 12}, { 18, 12}, {  3,  6}, { 17,  6},
+    /* Ascii 36 */
+    {  8, 25}, {  8, -4}, { 12, 25}, { 12, -4}, { 17, 18}, { 15, 20}, { 12, 21}, {  8, 21},
+    {  5, 20}, {  3, 18}, {  3, 16}, {  4, 14}, {  5, 13}, {  7, 12}, { 13, 10}, { 15,  9},
+    { 16,  8}, { 17,  6}, { 17,  3}, { 15,  1}, { 12,  0}, {  8,  0}, {  5,  1}, {  3,  3},
+    /* Ascii 37 */
+    { 21, 21}, {  3,  0}, {  8, 21}, { 10, 19}, { 10, 17}, {  9, 15}, {  7, 14}, {  5, 14},
+    {  3, 16}, {  3, 18}, {  4, 20}, {  6, 21}, {  8, 21}, { 10, 20}, { 13, 19}, { 16, 19},
+    { 19, 20}, { 21, 21}, { 17,  7}, { 15,  6}, { 14,  4}, { 14,  2}, { 16,  0}, { 18,  0},
+    { 20,  1}, { 21,  3}, { 21,  5}, { 19,  7}, { 17,  7},
+    /* Ascii 38 */
+    { 23, 12}, { 23, 13}, { 22, 14}, { 21, 14}, { 20, 13}, { 19, 11}, { 17,  6}, { 15,  3},
+    { 13,  1}, { 11,  0}, {  7,  0}, {  5,  1}, {  4,  2}, {  3,  4}, {  3,  6}, {  4,  8},
+    {  5,  9}, { 12, 13}, { 13, 14}, { 14, 16}, { 14, 18}, { 13, 20}, { 11, 21}, {  9, 20},
+    {  8, 18}, {  8, 16}, {  9, 13}, { 11, 10}, { 16,  3}, { 18,  1}, { 20,  0}, { 22,  0},
+    { 23,  1}, { 23,  2},
+    /* Ascii 39 */
+    {  5, 19}, {  4, 20}, {  5, 21}, {  6, 20}, {  6, 18}, {  5, 16}, {  4, 15},
+    /* Ascii 40 */
+    { 11, 25}, {  9, 23}, {  7, 20}, {  5, 16}, {  4, 11}, {  4,  7}, {  5,  2}, {  7, -2},
+    {  9, -5}, { 11, -7},
+    /* Ascii 41 */
+    {  3, 25}, {  5, 23}, {  7, 20}, {  9, 16}, { 10, 11}, { 10,  7}, {  9,  2}, {  7, -2},
+    {  5, -5}, {  3, -7},
+    /* Ascii 42 */
+    {  8, 21}, {  8,  9}, {  3, 18}, { 13, 12}, { 13, 18}, {  3, 12},
+    /* Ascii 43 */
+    { 13, 18}, { 13,  0}, {  4,  9}, { 22,  9},
+    /* Ascii 44 */
+    {  6,  1}, {  5,  0}, {  4,  1}, {  5,  2}, {  6,  1}, {  6, -1}, {  5, -3}, {  4, -4},
+    /* Ascii 45 */
+    {  4,  9}, { 22,  9},
+    /* Ascii 46 */
+    {  5,  2}, {  4,  1}, {  5,  0}, {  6,  1}, {  5,  2},
+    /* Ascii 47 */
+    { 20, 25}, {  2, -7},
+    /* Ascii 48 */
+    {  9, 21}, {  6, 20}, {  4, 17}, {  3, 12}, {  3,  9}, {  4,  4}, {  6,  1}, {  9,  0},
+    { 11,  0}, { 14,  1}, { 16,  4}, { 17,  9}, { 17, 12}, { 16, 17}, { 14, 20}, { 11, 21},
+    {  9, 21},
+    /* Ascii 49 */
+    {  6, 17}, {  8, 18}, { 11, 21}, { 11,  0},
+    /* Ascii 50 */
+    {  4, 16}, {  4, 17}, {  5, 19}, {  6, 20}, {  8, 21}, { 12, 21}, { 14, 20}, { 15, 19},
+    { 16, 17}, { 16, 15}, { 15, 13}, { 13, 10}, {  3,  0}, { 17,  0},
+    /* Ascii 51 */
+    {  5, 21}, { 16, 21}, { 10, 13}, { 13, 13}, { 15, 12}, { 16, 11}, { 17,  8}, { 17,  6},
+    { 16,  3}, { 14,  1}, { 11,  0}, {  8,  0}, {  5,  1}, {  4,  2}, {  3,  4},
+    /* Ascii 52 */
+    { 13, 21}, {  3,  7}, { 18,  7}, { 13, 21}, { 13,  0},
+    /* Ascii 53 */
+    { 15, 21}, {  5, 21}, {  4, 12}, {  5, 13}, {  8, 14}, { 11, 14}, { 14, 13}, { 16, 11},
+    { 17,  8}, { 17,  6}, { 16,  3}, { 14,  1}, { 11,  0}, {  8,  0}, {  5,  1}, {  4,  2},
+    {  3,  4},
+    /* Ascii 54 */
+    { 16, 18}, { 15, 20}, { 12, 21}, { 10, 21}, {  7, 20}, {  5, 17}, {  4, 12}, {  4,  7},
+    {  5,  3}, {  7,  1}, { 10,  0}, { 11,  0}, { 14,  1}, { 16,  3}, { 17,  6}, { 17,  7},
+    { 16, 10}, { 14, 12}, { 11, 13}, { 10, 13}, {  7, 12}, {  5, 10}, {  4,  7},
+    /* Ascii 55 */
+    { 17, 21}, {  7,  0}, {  3, 21}, { 17, 21},
+    /* Ascii 56 */
+    {  8, 21}, {  5, 20}, {  4, 18}, {  4, 16}, {  5, 14}, {  7, 13}, { 11, 12}, { 14, 11},
+    { 16,  9}, { 17,  7}, { 17,  4}, { 16,  2}, { 15,  1}, { 12,  0}, {  8,  0}, {  5,  1},
+    {  4,  2}, {  3,  4}, {  3,  7}, {  4,  9}, {  6, 11}, {  9, 12}, { 13, 13}, { 15, 14},
+    { 16, 16}, { 16, 18}, { 15, 20}, { 12, 21}, {  8, 21},
+    /* Ascii 57 */
+    { 16, 14}, { 15, 11}, { 13,  9}, { 10,  8}, {  9,  8}, {  6,  9}, {  4, 11}, {  3, 14},
+    {  3, 15}, {  4, 18}, {  6, 20}, {  9, 21}, { 10, 21}, { 13, 20}, { 15, 18}, { 16, 14},
+    { 16,  9}, { 15,  4}, { 13,  1}, { 10,  0}, {  8,  0}, {  5,  1}, {  4,  3},
+    /* Ascii 58 */
+    {  5, 14}, {  4, 13}, {  5, 12}, {  6, 13}, {  5, 14}, {  5,  2}, {  4,  1}, {  5,  0},
+    {  6,  1}, {  5,  2},
+    /* Ascii 59 */
+    {  5, 14}, {  4, 13}, {  5, 12}, {  6, 13}, {  5, 14}, {  6,  1}, {  5,  0}, {  4,  1},
+    {  5,  2}, {  6,  1}, {  6, -1}, {  5, -3}, {  4, -4},
+    /* Ascii 60 */
+    { 20, 18}, {  4,  9}, { 20,  0},
+    /* Ascii 61 */
+    {  4, 12}, { 22, 12}, {  4,  6}, { 22,  6},
+    /* Ascii 62 */
+    {  4, 18}, { 20,  9}, {  4,  0},
+    /* Ascii 63 */
+    {  3, 16}, {  3, 17}, {  4, 19}, {  5, 20}, {  7, 21}, { 11, 21}, { 13, 20}, { 14, 19},
+    { 15, 17}, { 15, 15}, { 14, 13}, { 13, 12}, {  9, 10}, {  9,  7}, {  9,  2}, {  8,  1},
+    {  9,  0}, { 10,  1}, {  9,  2},
+    /* Ascii 64 */
+    { 18, 13}, { 17, 15}, { 15, 16}, { 12, 16}, { 10, 15}, {  9, 14}, {  8, 11}, {  8,  8},
+    {  9,  6}, { 11,  5}, { 14,  5}, { 16,  6}, { 17,  8}, { 12, 16}, { 10, 14}, {  9, 11},
+    {  9,  8}, { 10,  6}, { 11,  5}, { 18, 16}, { 17,  8}, { 17,  6}, { 19,  5}, { 21,  5},
+    { 23,  7}, { 24, 10}, { 24, 12}, { 23, 15}, { 22, 17}, { 20, 19}, { 18, 20}, { 15, 21},
+    { 12, 21}, {  9, 20}, {  7, 19}, {  5, 17}, {  4, 15}, {  3, 12}, {  3,  9}, {  4,  6},
+    {  5,  4}, {  7,  2}, {  9,  1}, { 12,  0}, { 15,  0}, { 18,  1}, { 20,  2}, { 21,  3},
+    { 19, 16}, { 18,  8}, { 18,  6}, { 19,  5},
+    /* Ascii 65 */
+    {  9, 21}, {  1,  0}, {  9, 21}, { 17,  0}, {  4,  7}, { 14,  7},
+    /* Ascii 66 */
+    {  4, 21}, {  4,  0}, {  4, 21}, { 13, 21}, { 16, 20}, { 17, 19}, { 18, 17}, { 18, 15},
+    { 17, 13}, { 16, 12}, { 13, 11}, {  4, 11}, { 13, 11}, { 16, 10}, { 17,  9}, { 18,  7},
+    { 18,  4}, { 17,  2}, { 16,  1}, { 13,  0}, {  4,  0},
+    /* Ascii 67 */
+    { 18, 16}, { 17, 18}, { 15, 20}, { 13, 21}, {  9, 21}, {  7, 20}, {  5, 18}, {  4, 16},
+    {  3, 13}, {  3,  8}, {  4,  5}, {  5,  3}, {  7,  1}, {  9,  0}, { 13,  0}, { 15,  1},
+    { 17,  3}, { 18,  5},
+    /* Ascii 68 */
+    {  4, 21}, {  4,  0}, {  4, 21}, { 11, 21}, { 14, 20}, { 16, 18}, { 17, 16}, { 18, 13},
+    { 18,  8}, { 17,  5}, { 16,  3}, { 14,  1}, { 11,  0}, {  4,  0},
+    /* Ascii 69 */
+    {  4, 21}, {  4,  0}, {  4, 21}, { 17, 21}, {  4, 11}, { 12, 11}, {  4,  0}, { 17,  0},
+    /* Ascii 70 */
+    {  4, 21}, {  4,  0}, {  4, 21}, { 17, 21}, {  4, 11}, { 12, 11},
+    /* Ascii 71 */
+    { 18, 16}, { 17, 18}, { 15, 20}, { 13, 21}, {  9, 21}, {  7, 20}, {  5, 18}, {  4, 16},
+    {  3, 13}, {  3,  8}, {  4,  5}, {  5,  3}, {  7,  1}, {  9,  0}, { 13,  0}, { 15,  1},
+    { 17,  3}, { 18,  5}, { 18,  8}, { 13,  8}, { 18,  8},
+    /* Ascii 72 */
+    {  4, 21}, {  4,  0}, { 18, 21}, { 18,  0}, {  4, 11}, { 18, 11},
+    /* Ascii 73 */
+    {  4, 21}, {  4,  0},
+    /* Ascii 74 */
+    { 12, 21}, { 12,  5}, { 11,  2}, { 10,  1}, {  8,  0}, {  6,  0}, {  4,  1}, {  3,  2},
+    {  2,  5}, {  2,  7},
+    /* Ascii 75 */
+    {  4, 21}, {  4,  0}, { 18, 21}, {  4,  7}, {  9, 12}, { 18,  0},
+    /* Ascii 76 */
+    {  4, 21}, {  4,  0}, {  4,  0}, { 16,  0},
+    /* Ascii 77 */
+    {  4, 21}, {  4,  0}, {  4, 21}, { 12,  0}, { 20, 21}, { 12,  0}, { 20, 21}, { 20,  0},
+    /* Ascii 78 */
+    {  4, 21}, {  4,  0}, {  4, 21}, { 18,  0}, { 18, 21}, { 18,  0},
+    /* Ascii 79 */
+    {  9, 21}, {  7, 20}, {  5, 18}, {  4, 16}, {  3, 13}, {  3,  8}, {  4,  5}, {  5,  3},
+    {  7,  1}, {  9,  0}, { 13,  0}, { 15,  1}, { 17,  3}, { 18,  5}, { 19,  8}, { 19, 13},
+    { 18, 16}, { 17, 18}, { 15, 20}, { 13, 21}, {  9, 21},
+    /* Ascii 80 */
+    {  4, 21}, {  4,  0}, {  4, 21}, { 13, 21}, { 16, 20}, { 17, 19}, { 18, 17}, { 18, 14},
+    { 17, 12}, { 16, 11}, { 13, 10}, {  4, 10},
+    /* Ascii 81 */
+    {  9, 21}, {  7, 20}, {  5, 18}, {  4, 16}, {  3, 13}, {  3,  8}, {  4,  5}, {  5,  3},
+    {  7,  1}, {  9,  0}, { 13,  0}, { 15,  1}, { 17,  3}, { 18,  5}, { 19,  8}, { 19, 13},
+    { 18, 16}, { 17, 18}, { 15, 20}, { 13, 21}, {  9, 21}, { 12,  4}, { 18, -2},
+    /* Ascii 82 */
+    {  4, 21}, {  4,  0}, {  4, 21}, { 13, 21}, { 16, 20}, { 17, 19}, { 18, 17}, { 18, 15},
+    { 17, 13}, { 16, 12}, { 13, 11}, {  4, 11}, { 11, 11}, { 18,  0},
+    /* Ascii 83 */
+    { 17, 18}, { 15, 20}, { 12, 21}, {  8, 21}, {  5, 20}, {  3, 18}, {  3, 16}, {  4, 14},
+    {  5, 13}, {  7, 12}, { 13, 10}, { 15,  9}, { 16,  8}, { 17,  6}, { 17,  3}, { 15,  1},
+    { 12,  0}, {  8,  0}, {  5,  1}, {  3,  3},
+    /* Ascii 84 */
+    {  8, 21}, {  8,  0}, {  1, 21}, { 15, 21},
+    /* Ascii 85 */
+    {  4, 21}, {  4,  6}, {  5,  3}, {  7,  1}, { 10,  0}, { 12,  0}, { 15,  1}, { 17,  3},
+    { 18,  6}, { 18, 21},
+    /* Ascii 86 */
+    {  1, 21}, {  9,  0}, { 17, 21}, {  9,  0},
+    /* Ascii 87 */
+    {  2, 21}, {  7,  0}, { 12, 21}, {  7,  0}, { 12, 21}, { 17,  0}, { 22, 21}, { 17,  0},
+    /* Ascii 88 */
+    {  3, 21}, { 17,  0}, { 17, 21}, {  3,  0},
+    /* Ascii 89 */
+    {  1, 21}, {  9, 11}, {  9,  0}, { 17, 21}, {  9, 11},
+    /* Ascii 90 */
+    { 17, 21}, {  3,  0}, {  3, 21}, { 17, 21}, {  3,  0}, { 17,  0},
+    /* Ascii 91 */
+    {  4, 25}, {  4, -7}, {  5, 25}, {  5, -7}, {  4, 25}, { 11, 25}, {  4, -7}, { 11, -7},
+    /* Ascii 92 */
+    {  0, 21}, { 14, -3},
+    /* Ascii 93 */
+    {  9, 25}, {  9, -7}, { 10, 25}, { 10, -7}, {  3, 25}, { 10, 25}, {  3, -7}, { 10, -7},
+    /* Ascii 94 */
+    {  6, 15}, {  8, 18}, { 10, 15}, {  3, 12}, {  8, 17}, { 13, 12}, {  8, 17}, {  8,  0},
+    /* Ascii 95 */
+    {  0, -2}, { 16, -2},
+    /* Ascii 96 */
+    {  6, 21}, {  5, 20}, {  4, 18}, {  4, 16}, {  5, 15}, {  6, 16}, {  5, 17},
+    /* Ascii 97 */
+    { 15, 14}, { 15,  0}, { 15, 11}, { 13, 13}, { 11, 14}, {  8, 14}, {  6, 13}, {  4, 11},
+    {  3,  8}, {  3,  6}, {  4,  3}, {  6,  1}, {  8,  0}, { 11,  0}, { 13,  1}, { 15,  3},
+    /* Ascii 98 */
+    {  4, 21}, {  4,  0}, {  4, 11}, {  6, 13}, {  8, 14}, { 11, 14}, { 13, 13}, { 15, 11},
+    { 16,  8}, { 16,  6}, { 15,  3}, { 13,  1}, { 11,  0}, {  8,  0}, {  6,  1}, {  4,  3},
+    /* Ascii 99 */
+    { 15, 11}, { 13, 13}, { 11, 14}, {  8, 14}, {  6, 13}, {  4, 11}, {  3,  8}, {  3,  6},
+    {  4,  3}, {  6,  1}, {  8,  0}, { 11,  0}, { 13,  1}, { 15,  3},
+    /* Ascii 100 */
+    { 15, 21}, { 15,  0}, { 15, 11}, { 13, 13}, { 11, 14}, {  8, 14}, {  6, 13}, {  4, 11},
+    {  3,  8}, {  3,  6}, {  4,  3}, {  6,  1}, {  8,  0}, { 11,  0}, { 13,  1}, { 15,  3},
+    /* Ascii 101 */
+    {  3,  8}, { 15,  8}, { 15, 10}, { 14, 12}, { 13, 13}, { 11, 14}, {  8, 14}, {  6, 13},
+    {  4, 11}, {  3,  8}, {  3,  6}, {  4,  3}, {  6,  1}, {  8,  0}, { 11,  0}, { 13,  1},
+    { 15,  3},
+    /* Ascii 102 */
+    { 10, 21}, {  8, 21}, {  6, 20}, {  5, 17}, {  5,  0}, {  2, 14}, {  9, 14},
+    /* Ascii 103 */
+    { 15, 14}, { 15, -2}, { 14, -5}, { 13, -6}, { 11, -7}, {  8, -7}, {  6, -6}, { 15, 11},
+    { 13, 13}, { 11, 14}, {  8, 14}, {  6, 13}, {  4, 11}, {  3,  8}, {  3,  6}, {  4,  3},
+    {  6,  1}, {  8,  0}, { 11,  0}, { 13,  1}, { 15,  3},
+    /* Ascii 104 */
+    {  4, 21}, {  4,  0}, {  4, 10}, {  7, 13}, {  9, 14}, { 12, 14}, { 14, 13}, { 15, 10},
+    { 15,  0},
+    /* Ascii 105 */
+    {  3, 21}, {  4, 20}, {  5, 21}, {  4, 22}, {  3, 21}, {  4, 14}, {  4,  0},
+    /* Ascii 106 */
+    {  5, 21}, {  6, 20}, {  7, 21}, {  6, 22}, {  5, 21}, {  6, 14}, {  6, -3}, {  5, -6},
+    {  3, -7}, {  1, -7},
+    /* Ascii 107 */
+    {  4, 21}, {  4,  0}, { 14, 14}, {  4,  4}, {  8,  8}, { 15,  0},
+    /* Ascii 108 */
+    {  4, 21}, {  4,  0},
+    /* Ascii 109 */
+    {  4, 14}, {  4,  0}, {  4, 10}, {  7, 13}, {  9, 14}, { 12, 14}, { 14, 13}, { 15, 10},
+    { 15,  0}, { 15, 10}, { 18, 13}, { 20, 14}, { 23, 14}, { 25, 13}, { 26, 10}, { 26,  0},
+    /* Ascii 110 */
+    {  4, 14}, {  4,  0}, {  4, 10}, {  7, 13}, {  9, 14}, { 12, 14}, { 14, 13}, { 15, 10},
+    { 15,  0},
+    /* Ascii 111 */
+    {  8, 14}, {  6, 13}, {  4, 11}, {  3,  8}, {  3,  6}, {  4,  3}, {  6,  1}, {  8,  0},
+    { 11,  0}, { 13,  1}, { 15,  3}, { 16,  6}, { 16,  8}, { 15, 11}, { 13, 13}, { 11, 14},
+    {  8, 14},
+    /* Ascii 112 */
+    {  4, 14}, {  4, -7}, {  4, 11}, {  6, 13}, {  8, 14}, { 11, 14}, { 13, 13}, { 15, 11},
+    { 16,  8}, { 16,  6}, { 15,  3}, { 13,  1}, { 11,  0}, {  8,  0}, {  6,  1}, {  4,  3},
+    /* Ascii 113 */
+    { 15, 14}, { 15, -7}, { 15, 11}, { 13, 13}, { 11, 14}, {  8, 14}, {  6, 13}, {  4, 11},
+    {  3,  8}, {  3,  6}, {  4,  3}, {  6,  1}, {  8,  0}, { 11,  0}, { 13,  1}, { 15,  3},
+    /* Ascii 114 */
+    {  4, 14}, {  4,  0}, {  4,  8}, {  5, 11}, {  7, 13}, {  9, 14}, { 12, 14},
+    /* Ascii 115 */
+    { 14, 11}, { 13, 13}, { 10, 14}, {  7, 14}, {  4, 13}, {  3, 11}, {  4,  9}, {  6,  8},
+    { 11,  7}, { 13,  6}, { 14,  4}, { 14,  3}, { 13,  1}, { 10,  0}, {  7,  0}, {  4,  1},
+    {  3,  3},
+    /* Ascii 116 */
+    {  5, 21}, {  5,  4}, {  6,  1}, {  8,  0}, { 10,  0}, {  2, 14}, {  9, 14},
+    /* Ascii 117 */
+    {  4, 14}, {  4,  4}, {  5,  1}, {  7,  0}, { 10,  0}, { 12,  1}, { 15,  4}, { 15, 14},
+    { 15,  0},
+    /* Ascii 118 */
+    {  2, 14}, {  8,  0}, { 14, 14}, {  8,  0},
+    /* Ascii 119 */
+    {  3, 14}, {  7,  0}, { 11, 14}, {  7,  0}, { 11, 14}, { 15,  0}, { 19, 14}, { 15,  0},
+    /* Ascii 120 */
+    {  3, 14}, { 14,  0}, { 14, 14}, {  3,  0},
+    /* Ascii 121 */
+    {  2, 14}, {  8,  0}, { 14, 14}, {  8,  0}, {  6, -4}, {  4, -6}, {  2, -7}, {  1, -7},
+    /* Ascii 122 */
+    { 14, 14}, {  3,  0}, {  3, 14}, { 14, 14}, {  3,  0}, { 14,  0},
+    /* Ascii 123 */
+    {  9, 25}, {  7, 24}, {  6, 23}, {  5, 21}, {  5, 19}, {  6, 17}, {  7, 16}, {  8, 14},
+    {  8, 12}, {  6, 10}, {  7, 24}, {  6, 22}, {  6, 20}, {  7, 18}, {  8, 17}, {  9, 15},
+    {  9, 13}, {  8, 11}, {  4,  9}, {  8,  7}, {  9,  5}, {  9,  3}, {  8,  1}, {  7,  0},
+    {  6, -2}, {  6, -4}, {  7, -6}, {  6,  8}, {  8,  6}, {  8,  4}, {  7,  2}, {  6,  1},
+    {  5, -1}, {  5, -3}, {  6, -5}, {  7, -6}, {  9, -7},
+    /* Ascii 124 */
+    {  4, 25}, {  4, -7},
+    /* Ascii 125 */
+    {  5, 25}, {  7, 24}, {  8, 23}, {  9, 21}, {  9, 19}, {  8, 17}, {  7, 16}, {  6, 14},
+    {  6, 12}, {  8, 10}, {  7, 24}, {  8, 22}, {  8, 20}, {  7, 18}, {  6, 17}, {  5, 15},
+    {  5, 13}, {  6, 11}, { 10,  9}, {  6,  7}, {  5,  5}, {  5,  3}, {  6,  1}, {  7,  0},
+    {  8, -2}, {  8, -4}, {  7, -6}, {  8,  8}, {  6,  6}, {  6,  4}, {  7,  2}, {  8,  1},
+    {  9, -1}, {  9, -3}, {  8, -5}, {  7, -6}, {  5, -7},
+    /* Ascii 126 */
+    {  3,  6}, {  3,  8}, {  4, 11}, {  6, 12}, {  8, 12}, { 10, 11}, { 14,  8}, { 16,  7},
+    { 18,  7}, { 20,  8}, { 21, 10}, {  3,  8}, {  4, 10}, {  6, 11}, {  8, 11}, { 10, 10},
+    { 14,  7}, { 16,  6}, { 18,  6}, { 20,  7}, { 21, 10}, { 21, 12},
 };
 
+static int is_glyph(char c) {
+    return c >= 32 && c <= 126;
+}
+
+static int has_strokes(char c) {
+    return is_glyph(c) && simplex_glyphs[c - 32].nstrokes != 0;
+}
+
+static int advance(char c) {
+    return is_glyph(c) ? simplex_glyphs[c - 32].spacing : 0;
+}
+
+//
+// One line of text, before alignment and clipping.
+//
+typedef struct {
+    int    start, length;               // trailing spaces are not included
+    int    width;                       // in font units
+    int    next;                        // start of the next line, or -1 after the last
+} text_line_t;
+
+//
+// Find the line of s that starts at start. Lines end at '\n', and, if
+// max_width is positive, at the last space that keeps them within max_width
+// font units. A word wider than max_width is broken between glyphs.
+//
+static void break_line(const char *s, int start, double max_width, text_line_t *line) {
+    int i, width = 0, space = -1, space_width = 0;
+
+    for (i = start; s[i] && s[i] != '\n'; i++) {
+        int a = advance(s[i]);
+        if (max_width > 0 && s[i] != ' ' && width + a > max_width && i > start) {
+            if (space >= 0) {
+                i     = space;
+                width = space_width;
+            }
+            line->next = i;
+            while (s[line->next] == ' ') line->next++;
+            break;
+        }
+        if (s[i] == ' ') {
+            space       = i;
+            space_width = width;
+        }
+        width += a;
+    }
+    if (!s[i])              line->next = -1;
+    else if (s[i] == '\n')  line->next = i + 1;
+
+    while (i > start && s[i - 1] == ' ') {
+        width -= advance(' ');
+        i--;
+    }
+    line->start  = start;
+    line->length = i - start;
+    line->width  = width;
+}
+
 int vector_font_simplex_measure(double scale, const char *string, double *out_width, double *out_height) {
+    text_line_t line;
+    int         pos = 0, nlines = 0, width = 0;
+    do {
+        break_line(string, pos, 0, &line);
+        if (line.width > width) width = line.width;
+        nlines++;
+        pos = line.next;
+    } while (pos >= 0);
+
+    *out_width  = width * scale;
+    *out_height = nlines * SIMPLEX_LINE_HEIGHT * scale;
     return 0;
 }
 
-int vector_font_simplex_draw(vector_display_t *display, double x, double y, double scale, const char *s) {
-    for (;;) {
-        char c = *s++;
-        if (!c)                break;
-        if (c < 32 || c > 126) continue;
-
-        int *chr = simplex[c - 32];
-
-        int nvertices = chr[0];
-        int spacing   = chr[1];
-
-        int is_drawing = 0;
-        int i;
-        for (i = 0; i < nvertices; i++) {
-            int vx = chr[2 + i * 2];
-            int vy = chr[2 + i * 2 + 1];
-            if (vx == -1 && vy == -1) {
-                if (is_drawing) {
-                    vector_display_end_draw(display);
-                    is_drawing = 0;
+//
+// Lays out text in a box one visible line at a time.
+//
+typedef struct {
+    const char *s;
+    double      x, y, width, height, scale;
+    int         flags;
+    double      max_width;              // for wrapping, in font units
+    int         pos;                    // start of the next line, or -1 after the last
+    double      baseline;               // of the next line
+
+    // the current line, after alignment and clipping
+    int         start, length;
+    double      line_x, line_y;         // origin of the first glyph
+} layout_t;
+
+#define LAYOUT_EPSILON (1e-6)
+
+static void layout_begin(layout_t *layout, double x, double y, double width, double height, double scale, int flags, const char *s) {
+    layout->s         = s;
+    layout->x         = x;
+    layout->y         = y;
+    layout->width     = width;
+    layout->height    = height;
+    layout->scale     = scale;
+    layout->flags     = flags;
+    layout->max_width = (flags & VECTOR_FONT_SIMPLEX_WRAP) && width > 0 ? width / scale : 0;
+    layout->pos       = 0;
+    layout->baseline  = y + SIMPLEX_ASCENT * scale;
+
+    if (flags & (VECTOR_FONT_SIMPLEX_ALIGN_MIDDLE | VECTOR_FONT_SIMPLEX_ALIGN_BOTTOM)) {
+        text_line_t line;
+        int         pos = 0, nlines = 0;
+        do {
+            break_line(s, pos, layout->max_width, &line);
+            nlines++;
+            pos = line.next;
+        } while (pos >= 0);
+
+        double extra = height - nlines * SIMPLEX_LINE_HEIGHT * scale;
+        layout->baseline += (flags & VECTOR_FONT_SIMPLEX_ALIGN_MIDDLE) ? extra / 2 : extra;
+    }
+}
+
+//
+// Move to the next line with something to draw. Returns 0 after the last one.
+//
+static int layout_next(layout_t *layout) {
+    const char *s     = layout->s;
+    double      scale = layout->scale;
+    int         clip  = layout->flags & VECTOR_FONT_SIMPLEX_CLIP;
+
+    while (layout->pos >= 0) {
+        text_line_t line;
+        double      baseline = layout->baseline;
+        break_line(s, layout->pos, layout->max_width, &line);
+        layout->pos       = line.next;
+        layout->baseline += SIMPLEX_LINE_HEIGHT * scale;
+
+        if (clip && layout->height > 0) {
+            if (baseline + SIMPLEX_DESCENT * scale > layout->y + layout->height + LAYOUT_EPSILON) {
+                layout->pos = -1;       // so is every line after it
+                break;
+            }
+            if (baseline - SIMPLEX_ASCENT * scale < layout->y - LAYOUT_EPSILON) continue;
+        }
+
+        double width = layout->width > 0 ? layout->width : 0;
+        double x     = layout->x;
+        if (layout->flags & VECTOR_FONT_SIMPLEX_ALIGN_CENTER) {
+            x += (width - line.width * scale) / 2;
+        } else if (layout->flags & VECTOR_FONT_SIMPLEX_ALIGN_RIGHT) {
+            x += width - line.width * scale;
+        }
+
+        int first = line.start, last = line.start + line.length;
+        if (clip && layout->width > 0) {
+            // keep the glyphs whose strokes are inside the box, which are contiguous
+            double gx = x, first_x = x;
+            int    i;
+            first = last;
+            for (i = line.start; i < line.start + line.length; i++) {
+                if (has_strokes(s[i])) {
+                    const signed char *box = simplex_glyphs[s[i] - 32].box;
+                    if (gx + box[0] * scale >= layout->x - LAYOUT_EPSILON &&
+                        gx + box[2] * scale <= layout->x + layout->width + LAYOUT_EPSILON) {
+                        if (first == last) {
+                            first   = i;
+                            first_x = gx;
+                        }
+                        last = i + 1;
+                    }
+                }
+                gx += advance(s[i]) * scale;
+            }
+            x = first_x;
+        }
+        if (first == last) continue;
+
+        layout->start  = first;
+        layout->length = last - first;
+        layout->line_x = x;
+        layout->line_y = baseline;
+        return 1;
+    }
+    return 0;
+}
+
+int vector_font_simplex_layout(double x, double y, double width, double height, double scale, int flags, const char *s,
+                               vector_font_simplex_glyph_t *out_glyphs, int max_glyphs, int *out_nglyphs) {
+    layout_t layout;
+    int      n = 0;
+
+    layout_begin(&layout, x, y, width, height, scale, flags, s);
+    while (layout_next(&layout)) {
+        double gx = layout.line_x;
+        int    i;
+        for (i = layout.start; i < layout.start + layout.length; i++) {
+            if (has_strokes(s[i])) {
+                if (n < max_glyphs) {
+                    out_glyphs[n].x = gx;
+                    out_glyphs[n].y = layout.line_y;
+                    out_glyphs[n].c = s[i];
                 }
-            } else if (!is_drawing) {
-                vector_display_begin_draw(display, x + vx * scale, y - vy * scale);
-                is_drawing = 1;
-            } else {
-                vector_display_draw_to(display, x + vx * scale, y - vy * scale);
+                n++;
             }
+            gx += advance(s[i]) * scale;
+        }
+    }
+    *out_nglyphs = n;
+    return 0;
+}
+
+//
+// Draw one character with its baseline origin at (x, y). Returns the distance
+// to the next character.
+//
+static double draw_char(vector_display_t *display, double x, double y, double scale, char c) {
+    const simplex_glyph_t *glyph   = &simplex_glyphs[c - 32];
+    const unsigned short  *strokes = &simplex_strokes[glyph->first_stroke];
+    const signed char    (*points)[2] = &simplex_points[strokes[0]];
+    int                    npoints = strokes[glyph->nstrokes] - strokes[0];
+
+    double xy[SIMPLEX_MAX_POINTS * 2];
+    int    counts[SIMPLEX_MAX_STROKES];
+    int i;
+    for (i = 0; i < glyph->nstrokes; i++) {
+        counts[i] = strokes[i + 1] - strokes[i];
+    }
+    for (i = 0; i < npoints; i++) {
+        xy[i * 2]     = x + points[i][0] * scale;
+        xy[i * 2 + 1] = y - points[i][1] * scale;
+    }
+    if (glyph->nstrokes) vector_display_draw_polylines(display, xy, counts, glyph->nstrokes);
+    return glyph->spacing * scale;
+}
+
+static void draw_string(vector_display_t *display, double x, double y, double scale, const char *s, int length) {
+    int i;
+    for (i = 0; i < length; i++) {
+        if (is_glyph(s[i])) x += draw_char(display, x, y, scale, s[i]);
+    }
+}
+
+int vector_font_simplex_draw(vector_display_t *display, double x, double y, double scale, const char *s) {
+    draw_string(display, x, y, scale, s, (int)strlen(s));
+    return 0;
+}
+
+int vector_font_simplex_draw_box(vector_display_t *display, double x, double y, double width, double height,
+                                 double scale, int flags, const char *s) {
+    layout_t layout;
+    layout_begin(&layout, x, y, width, height, scale, flags, s);
+    while (layout_next(&layout)) {
+        draw_string(display, layout.line_x, layout.line_y, scale, s + layout.start, layout.length);
+    }
+    return 0;
+}
+
+//
+// Tessellation cache.
+//
+// Glyphs and strings are recorded into display lists with their origin at
+// logical (0, 0), and copied into the frame with vector_display_append_list.
+// Box layouts are kept as the position and extent of each line, relative to
+// the box. All tables are set associative with least recently used
+// replacement, so the cache never grows and text that changes every frame
+// can't flush much of it at once.
+//
+#define GLYPH_CACHE_SETS        (64)
+#define STRING_CACHE_SETS       (128)
+#define LAYOUT_CACHE_SETS       (128)
+#define CACHE_WAYS              (8)
+#define STRING_CACHE_MAX_LENGTH (95)
+#define LAYOUT_CACHE_MAX_LENGTH (63)
+#define LAYOUT_CACHE_MAX_LINES  (4)
+
+//
+// Everything besides position that changes the tessellated output.
+//
+typedef struct {
+    double scale;                       // font scale times display scale
+    double thickness;                   // in framebuffer pixels
+    double r, g, b;
+} style_t;
+
+typedef struct {
+    vector_display_list_t *list;        // created on first use, then re-recorded
+    int      valid;
+    unsigned stamp;                     // last use
+    unsigned hash;
+    style_t  style;
+    double   origin_x, origin_y;        // where logical (0, 0) was in the framebuffer when recorded
+    int      length;
+    char     text[STRING_CACHE_MAX_LENGTH + 1];
+} cache_entry_t;
+
+typedef struct {
+    int    start, length;
+    double x, y;                        // relative to the box
+} layout_line_t;
+
+typedef struct {
+    int           valid;
+    unsigned      stamp;
+    unsigned      hash;
+    double        scale, width, height;
+    int           flags;
+    int           nlines;
+    layout_line_t lines[LAYOUT_CACHE_MAX_LINES];
+    int           length;
+    char          text[LAYOUT_CACHE_MAX_LENGTH + 1];
+} layout_entry_t;
+
+struct vector_font_simplex_cache {
+    vector_display_t *display;
+    unsigned          clock;
+    cache_entry_t     glyphs[GLYPH_CACHE_SETS][CACHE_WAYS];
+    cache_entry_t     strings[STRING_CACHE_SETS][CACHE_WAYS];
+    layout_entry_t    layouts[LAYOUT_CACHE_SETS][CACHE_WAYS];
+};
+
+int vector_font_simplex_cache_new(vector_display_t *display, vector_font_simplex_cache_t **out_cache) {
+    vector_font_simplex_cache_t *cache = (vector_font_simplex_cache_t*)vector_display_alloc(display, sizeof(vector_font_simplex_cache_t));
+    if (cache == NULL) return -1;
+    memset(cache, 0, sizeof(vector_font_simplex_cache_t));
+    cache->display = display;
+    *out_cache = cache;
+    return 0;
+}
+
+void vector_font_simplex_cache_delete(vector_font_simplex_cache_t *cache) {
+    cache_entry_t *entries = &cache->glyphs[0][0];
+    int            nentries = GLYPH_CACHE_SETS * CACHE_WAYS;
+    int i;
+    for (i = 0; i < nentries; i++) {
+        if (entries[i].list) vector_display_list_delete(entries[i].list);
+    }
+    entries  = &cache->strings[0][0];
+    nentries = STRING_CACHE_SETS * CACHE_WAYS;
+    for (i = 0; i < nentries; i++) {
+        if (entries[i].list) vector_display_list_delete(entries[i].list);
+    }
+    vector_display_free(cache->display, cache, sizeof(vector_font_simplex_cache_t));
+}
+
+int vector_font_simplex_cache_clear(vector_font_simplex_cache_t *cache) {
+    cache_entry_t *entries = &cache->glyphs[0][0];
+    int            nentries = GLYPH_CACHE_SETS * CACHE_WAYS;
+    int i;
+    for (i = 0; i < nentries; i++) {
+        entries[i].valid = 0;
+    }
+    entries  = &cache->strings[0][0];
+    nentries = STRING_CACHE_SETS * CACHE_WAYS;
+    for (i = 0; i < nentries; i++) {
+        entries[i].valid = 0;
+    }
+    layout_entry_t *layouts = &cache->layouts[0][0];
+    for (i = 0; i < LAYOUT_CACHE_SETS * CACHE_WAYS; i++) {
+        layouts[i].valid = 0;
+    }
+    return 0;
+}
+
+static unsigned hash_bytes(unsigned h, const void *data, size_t n) {
+    const unsigned char *p = (const unsigned char*)data;
+    size_t i;
+    for (i = 0; i < n; i++) {
+        h = (h ^ p[i]) * 16777619u;   // FNV-1a
+    }
+    return h;
+}
+
+static unsigned hash_key(const char *text, int length, const style_t *style) {
+    unsigned h = hash_bytes(2166136261u, text, length);
+    return hash_bytes(h, style, sizeof(style_t));
+}
+
+static int same_style(const style_t *a, const style_t *b) {
+    return a->scale == b->scale && a->thickness == b->thickness && a->r == b->r && a->g == b->g && a->b == b->b;
+}
+
+//
+// Look up text in a table. On a miss, returns the least recently used entry
+// of the set, cleared and keyed for text, with *out_hit set to 0.
+//
+static cache_entry_t *lookup(vector_font_simplex_cache_t *cache, cache_entry_t (*sets)[CACHE_WAYS], int nsets,
+                             const char *text, int length, const style_t *style, int *out_hit) {
+    unsigned       hash   = hash_key(text, length, style);
+    cache_entry_t *set    = sets[hash & (nsets - 1)];
+    cache_entry_t *victim = &set[0];
+    int i;
+
+    for (i = 0; i < CACHE_WAYS; i++) {
+        cache_entry_t *entry = &set[i];
+        if (entry->valid && entry->hash == hash && entry->length == length &&
+            same_style(&entry->style, style) && memcmp(entry->text, text, length) == 0) {
+            entry->stamp = cache->clock;
+            *out_hit = 1;
+            return entry;
+        }
+        if (!entry->valid) {
+            if (victim->valid) victim = entry;
+        } else if (victim->valid && (int)(entry->stamp - victim->stamp) < 0) {
+            victim = entry;
+        }
+    }
+
+    if (victim->list == NULL && vector_display_list_new(cache->display, &victim->list) != 0) return NULL;
+    victim->valid  = 0;
+    victim->stamp  = cache->clock;
+    victim->hash   = hash;
+    victim->style  = *style;
+    victim->length = length;
+    memcpy(victim->text, text, length);
+    *out_hit = 0;
+    return victim;
+}
+
+//
+// Record character c, drawn at logical (0, 0), into entry.
+//
+static int record_glyph(vector_font_simplex_cache_t *cache, cache_entry_t *entry, double scale, char c) {
+    double ds;
+    if (vector_display_begin_list(cache->display, entry->list) != 0) return -1;
+    vector_display_get_transform(cache->display, &entry->origin_x, &entry->origin_y, &ds);
+    draw_char(cache->display, 0, 0, scale, c);
+    vector_display_end_list(cache->display);
+    entry->valid = 1;
+    return 0;
+}
+
+//
+// The cached glyph for c, recording it if needed. NULL if it can't be cached,
+// for example while the display is recording a list.
+//
+static cache_entry_t *cached_glyph(vector_font_simplex_cache_t *cache, double scale, const style_t *style, char c) {
+    int            hit;
+    cache_entry_t *entry = lookup(cache, cache->glyphs, GLYPH_CACHE_SETS, &c, 1, style, &hit);
+    if (entry == NULL) return NULL;
+    if (!hit && record_glyph(cache, entry, scale, c) != 0) return NULL;
+    return entry;
+}
+
+static int append_entry(vector_font_simplex_cache_t *cache, cache_entry_t *entry, double x, double y) {
+    double ox, oy, ds;
+    vector_display_get_transform(cache->display, &ox, &oy, &ds);
+    return vector_display_append_list(cache->display, entry->list,
+                                      x * ds + ox - entry->origin_x,
+                                      y * ds + oy - entry->origin_y);
+}
+
+static void draw_glyphs(vector_font_simplex_cache_t *cache, double x, double y, double scale, const style_t *style, const char *s, int length) {
+    int i;
+    for (i = 0; i < length; i++) {
+        char           c     = s[i];
+        cache_entry_t *entry = has_strokes(c) ? cached_glyph(cache, scale, style, c) : NULL;
+        if (entry != NULL) {
+            append_entry(cache, entry, x, y);
+            x += advance(c) * scale;
+        } else if (is_glyph(c)) {
+            x += draw_char(cache->display, x, y, scale, c);
+        }
+    }
+}
+
+static int record_string(vector_font_simplex_cache_t *cache, cache_entry_t *entry, double scale, const style_t *style, const char *s, int length) {
+    double ds;
+    int    i;
+
+    // glyphs can't be recorded while the string is, so record them first
+    for (i = 0; i < length; i++) {
+        if (has_strokes(s[i])) cached_glyph(cache, scale, style, s[i]);
+    }
+
+    if (vector_display_begin_list(cache->display, entry->list) != 0) return -1;
+    vector_display_get_transform(cache->display, &entry->origin_x, &entry->origin_y, &ds);
+    draw_glyphs(cache, 0, 0, scale, style, s, length);
+    vector_display_end_list(cache->display);
+    entry->valid = 1;
+    return 0;
+}
+
+static int draw_string_cached(vector_font_simplex_cache_t *cache, double x, double y, double scale, const char *s, int length) {
+    vector_display_t *display = cache->display;
+    style_t           style;
+    double            ox, oy, ds;
+
+    vector_display_get_transform(display, &ox, &oy, &ds);
+    vector_display_get_thickness(display, &style.thickness);
+    vector_display_get_color(display, &style.r, &style.g, &style.b);
+    style.scale      = scale * ds;
+    style.thickness *= ds;
+    cache->clock++;
+
+    if (length <= STRING_CACHE_MAX_LENGTH) {
+        int            hit;
+        cache_entry_t *entry = lookup(cache, cache->strings, STRING_CACHE_SETS, s, length, &style, &hit);
+        if (entry != NULL && (hit || record_string(cache, entry, scale, &style, s, length) == 0)) {
+            return append_entry(cache, entry, x, y);
+        }
+    }
+
+    draw_glyphs(cache, x, y, scale, &style, s, length);
+    return 0;
+}
+
+int vector_font_simplex_draw_cached(vector_font_simplex_cache_t *cache, double x, double y, double scale, const char *s) {
+    return draw_string_cached(cache, x, y, scale, s, (int)strlen(s));
+}
+
+//
+// Look up the layout of s in a box. On a miss, lays it out and keeps it if it
+// is short enough. Returns NULL if it isn't.
+//
+static layout_entry_t *cached_layout(vector_font_simplex_cache_t *cache, double width, double height,
+                                     double scale, int flags, const char *s, int length) {
+    unsigned        hash   = hash_bytes(2166136261u, s, length);
+    layout_entry_t *set, *victim;
+    layout_t        layout;
+    int i;
+
+    if (length > LAYOUT_CACHE_MAX_LENGTH) return NULL;
+    hash   = hash_bytes(hash, &scale, sizeof(scale));
+    hash   = hash_bytes(hash, &width, sizeof(width));
+    hash   = hash_bytes(hash, &height, sizeof(height));
+    hash   = hash_bytes(hash, &flags, sizeof(flags));
+    set    = cache->layouts[hash & (LAYOUT_CACHE_SETS - 1)];
+    victim = &set[0];
+
+    for (i = 0; i < CACHE_WAYS; i++) {
+        layout_entry_t *entry = &set[i];
+        if (entry->valid && entry->hash == hash && entry->length == length &&
+            entry->scale == scale && entry->width == width && entry->height == height && entry->flags == flags &&
+            memcmp(entry->text, s, length) == 0) {
+            entry->stamp = cache->clock;
+            return entry;
+        }
+        if (!entry->valid) {
+            if (victim->valid) victim = entry;
+        } else if (victim->valid && (int)(entry->stamp - victim->stamp) < 0) {
+            victim = entry;
+        }
+    }
+
+    victim->valid  = 0;
+    victim->nlines = 0;
+    layout_begin(&layout, 0, 0, width, height, scale, flags, s);
+    while (layout_next(&layout)) {
+        if (victim->nlines == LAYOUT_CACHE_MAX_LINES) return NULL;
+        layout_line_t *line = &victim->lines[victim->nlines++];
+        line->start  = layout.start;
+        line->length = layout.length;
+        line->x      = layout.line_x;
+        line->y      = layout.line_y;
+    }
+
+    victim->valid  = 1;
+    victim->stamp  = cache->clock;
+    victim->hash   = hash;
+    victim->scale  = scale;
+    victim->width  = width;
+    victim->height = height;
+    victim->flags  = flags;
+    victim->length = length;
+    memcpy(victim->text, s, length);
+    return victim;
+}
+
+int vector_font_simplex_draw_box_cached(vector_font_simplex_cache_t *cache, double x, double y, double width, double height,
+                                        double scale, int flags, const char *s) {
+    int             length = (int)strlen(s);
+    layout_entry_t *entry;
+    int i;
+
+    cache->clock++;
+    entry = cached_layout(cache, width, height, scale, flags, s, length);
+
+    if (entry != NULL) {
+        for (i = 0; i < entry->nlines; i++) {
+            const layout_line_t *line = &entry->lines[i];
+            draw_string_cached(cache, x + line->x, y + line->y, scale, s + line->start, line->length);
+        }
+    } else {
+        layout_t layout;
+        layout_begin(&layout, x, y, width, height, scale, flags, s);
+        while (layout_next(&layout)) {
+            draw_string_cached(cache, layout.line_x, layout.line_y, scale, s + layout.start, layout.length);
+        }
+    }
+    return 0;
+}
+
+//
+// Text grid.
+//
+// Each row of cells is recorded into its own display list with its baseline
+// origin at logical (0, 0), and replayed with vector_display_draw_list. Rows
+// are kept in a ring, so scrolling only moves the first row. A changed row is
+// recorded into a new list, so that frames still fading out keep what they
+// drew.
+//
+#define SIMPLEX_CELL_WIDTH  (24)            // the widest glyph, 'm', is 22 units
+
+typedef struct {
+    char  c;
+    float r, g, b;
+} grid_cell_t;
+
+typedef struct {
+    vector_display_list_t *list;        // NULL while the row is blank
+    int          dirty;
+    double       origin_x, origin_y;    // where logical (0, 0) was in the framebuffer when recorded
+    grid_cell_t *cells;
+} grid_row_t;
+
+struct vector_font_simplex_grid {
+    vector_font_simplex_cache_t *cache;         // the caller's, which other grids and text may share
+    int          nrows, ncolumns;
+    int          top;                   // the row at the top of the grid
+    double       scale, thickness;      // as in style_t, when the rows were recorded
+    grid_row_t  *rows;
+    grid_cell_t *cells;
+};
+
+static void clear_row(vector_font_simplex_grid_t *grid, grid_row_t *row) {
+    int i;
+    for (i = 0; i < grid->ncolumns; i++) {
+        row->cells[i].c = ' ';
+        row->cells[i].r = row->cells[i].g = row->cells[i].b = 1.0f;
+    }
+    row->dirty = 1;
+}
+
+int vector_font_simplex_grid_new(vector_font_simplex_cache_t *cache, int rows, int columns, vector_font_simplex_grid_t **out_grid) {
+    vector_display_t *display = cache->display;
+    vector_font_simplex_grid_t *grid;
+    int i;
+
+    if (rows <= 0 || columns <= 0) return -1;
+    grid = (vector_font_simplex_grid_t*)vector_display_alloc(display, sizeof(vector_font_simplex_grid_t));
+    if (grid == NULL) return -1;
+    memset(grid, 0, sizeof(vector_font_simplex_grid_t));
+    grid->cache    = cache;
+    grid->nrows    = rows;
+    grid->ncolumns = columns;
+    grid->rows     = (grid_row_t*)vector_display_alloc(display, sizeof(grid_row_t) * rows);
+    grid->cells    = (grid_cell_t*)vector_display_alloc(display, sizeof(grid_cell_t) * rows * columns);
+    if (grid->rows == NULL || grid->cells == NULL) {
+        vector_font_simplex_grid_delete(grid);
+        return -1;
+    }
+    memset(grid->rows, 0, sizeof(grid_row_t) * rows);
+    for (i = 0; i < rows; i++) {
+        grid->rows[i].cells = &grid->cells[(size_t)i * columns];
+        clear_row(grid, &grid->rows[i]);
+    }
+    *out_grid = grid;
+    return 0;
+}
+
+void vector_font_simplex_grid_delete(vector_font_simplex_grid_t *grid) {
+    vector_display_t *display = grid->cache->display;
+    int i;
+    for (i = 0; grid->rows != NULL && i < grid->nrows; i++) {
+        if (grid->rows[i].list) vector_display_list_delete(grid->rows[i].list);
+    }
+    vector_display_free(display, grid->rows, sizeof(grid_row_t) * grid->nrows);
+    vector_display_free(display, grid->cells, sizeof(grid_cell_t) * grid->nrows * grid->ncolumns);
+    vector_display_free(display, grid, sizeof(vector_font_simplex_grid_t));
+}
+
+static grid_row_t *grid_row(vector_font_simplex_grid_t *grid, int row) {
+    return &grid->rows[(grid->top + row) % grid->nrows];
+}
+
+//
+// Change a cell, marking its row dirty if that changes what it shows.
+//
+static void set_cell(grid_row_t *row, int column, char c, float r, float g, float b) {
+    grid_cell_t *cell = &row->cells[column];
+    if (cell->c == c && (!has_strokes(c) || (cell->r == r && cell->g == g && cell->b == b))) return;
+    cell->c = c;
+    cell->r = r;
+    cell->g = g;
+    cell->b = b;
+    row->dirty = 1;
+}
+
+int vector_font_simplex_grid_set(vector_font_simplex_grid_t *grid, int row, int column, char c, double r, double g, double b) {
+    if (row < 0 || row >= grid->nrows || column < 0 || column >= grid->ncolumns) return -1;
+    set_cell(grid_row(grid, row), column, is_glyph(c) ? c : ' ', (float)r, (float)g, (float)b);
+    return 0;
+}
+
+int vector_font_simplex_grid_print(vector_font_simplex_grid_t *grid, int row, int column, double r, double g, double b, const char *s) {
+    grid_row_t *cells;
+    if (row < 0 || row >= grid->nrows || column < 0 || column >= grid->ncolumns) return -1;
+    cells = grid_row(grid, row);
+    for (; *s != '\0' && column < grid->ncolumns; s++, column++) {
+        set_cell(cells, column, is_glyph(*s) ? *s : ' ', (float)r, (float)g, (float)b);
+    }
+    return 0;
+}
+
+int vector_font_simplex_grid_clear(vector_font_simplex_grid_t *grid) {
+    int i;
+    for (i = 0; i < grid->nrows; i++) {
+        clear_row(grid, &grid->rows[i]);
+    }
+    return 0;
+}
+
+int vector_font_simplex_grid_scroll(vector_font_simplex_grid_t *grid, int lines) {
+    int i;
+    if (lines >= grid->nrows || -lines >= grid->nrows) return vector_font_simplex_grid_clear(grid);
+    grid->top = ((grid->top + lines) % grid->nrows + grid->nrows) % grid->nrows;
+    if (lines > 0) {
+        for (i = grid->nrows - lines; i < grid->nrows; i++) clear_row(grid, grid_row(grid, i));
+    } else {
+        for (i = 0; i < -lines; i++) clear_row(grid, grid_row(grid, i));
+    }
+    return 0;
+}
+
+int vector_font_simplex_grid_invalidate(vector_font_simplex_grid_t *grid) {
+    int i;
+    for (i = 0; i < grid->nrows; i++) {
+        grid->rows[i].dirty = 1;
+    }
+    return vector_font_simplex_cache_clear(grid->cache);
+}
+
+//
+// Where the glyph for c starts in its cell, in font units: its strokes are
+// centered.
+//
+static int cell_offset(char c) {
+    const simplex_glyph_t *glyph = &simplex_glyphs[c - 32];
+    return (SIMPLEX_CELL_WIDTH - glyph->box[0] - glyph->box[2]) / 2;
+}
+
+static int record_row(vector_font_simplex_grid_t *grid, grid_row_t *row, double scale, style_t *style) {
+    vector_display_t *display = grid->cache->display;
+    int    blank = 1;
+    double ds;
+    int i;
+
+    // glyphs can't be recorded while the row is, so record them first
+    grid->cache->clock++;
+    for (i = 0; i < grid->ncolumns; i++) {
+        const grid_cell_t *cell = &row->cells[i];
+        if (!has_strokes(cell->c)) continue;
+        style->r = cell->r;
+        style->g = cell->g;
+        style->b = cell->b;
+        vector_display_set_color(display, style->r, style->g, style->b);
+        cached_glyph(grid->cache, scale, style, cell->c);
+        blank = 0;
+    }
+
+    if (row->list) vector_display_list_delete(row->list);
+    row->list  = NULL;
+    row->dirty = 0;
+    if (blank) return 0;
+
+    if (vector_display_list_new(display, &row->list) != 0) return -1;
+    if (vector_display_begin_list(display, row->list) != 0) {
+        vector_display_list_delete(row->list);
+        row->list  = NULL;
+        row->dirty = 1;
+        return -1;
+    }
+    vector_display_get_transform(display, &row->origin_x, &row->origin_y, &ds);
+    for (i = 0; i < grid->ncolumns; i++) {
+        const grid_cell_t *cell = &row->cells[i];
+        if (!has_strokes(cell->c)) continue;
+        if (style->r != cell->r || style->g != cell->g || style->b != cell->b) {
+            style->r = cell->r;
+            style->g = cell->g;
+            style->b = cell->b;
+            vector_display_set_color(display, style->r, style->g, style->b);
         }
-        x += spacing * scale;
-        if (is_drawing) vector_display_end_draw(display);
+        draw_glyphs(grid->cache, (i * SIMPLEX_CELL_WIDTH + cell_offset(cell->c)) * scale, 0, scale, style, &cell->c, 1);
     }
+    vector_display_end_list(display);
     return 0;
 }
 
+int vector_font_simplex_grid_draw(vector_font_simplex_grid_t *grid, double x, double y, double scale) {
+    vector_display_t *display = grid->cache->display;
+    style_t           style;
+    double            ox, oy, ds, r, g, b;
+    int               result = 0;
+    int i;
+
+    vector_display_get_transform(display, &ox, &oy, &ds);
+    vector_display_get_thickness(display, &style.thickness);
+    vector_display_get_color(display, &r, &g, &b);
+    style.scale      = scale * ds;
+    style.thickness *= ds;
+    if (style.scale != grid->scale || style.thickness != grid->thickness) {
+        for (i = 0; i < grid->nrows; i++) grid->rows[i].dirty = 1;
+        grid->scale     = style.scale;
+        grid->thickness = style.thickness;
+    }
+
+    for (i = 0; i < grid->nrows; i++) {
+        grid_row_t *row = grid_row(grid, i);
+        if (row->dirty && record_row(grid, row, scale, &style) != 0) {
+            result = -1;
+            break;
+        }
+        if (row->list == NULL) continue;
+        if (vector_display_draw_list(display, row->list,
+                                     x * ds + ox - row->origin_x,
+                                     (y + (i * SIMPLEX_LINE_HEIGHT + SIMPLEX_ASCENT) * scale) * ds + oy - row->origin_y,
+                                     1.0) != 0) {
+            result = -1;
+            break;
+        }
+    }
 
+    vector_display_set_color(display, r, g, b);
+    return result;
+}
+
+void vector_font_simplex_grid_get_cell_size(double scale, double *out_width, double *out_height) {
+    *out_width  = SIMPLEX_CELL_WIDTH * scale;
+    *out_height = SIMPLEX_LINE_HEIGHT * scale;
+}
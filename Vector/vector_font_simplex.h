@@ -7,9 +7,139 @@
 extern "C" {
 #endif
 
-int vector_font_simplex_measure(double scale, const char *string, double *out_width, double *out_height);
+//
+// Draw a string with the baseline of its first glyph at (x, y).
+//
+// Glyphs are 21 units tall at scale 1, and y grows downward: a glyph's strokes
+// are above y, apart from descenders.
+//
 int vector_font_simplex_draw(vector_display_t *display, double x, double y, double scale, const char *s);
 
+//
+// Measure a string.
+//
+// '\n' starts a new line. out_width is the advance of the widest line, not
+// counting trailing spaces, and out_height is the number of lines times the
+// line height (32 units at scale 1).
+//
+int vector_font_simplex_measure(double scale, const char *string, double *out_width, double *out_height);
+
+//
+// Flags for laying out text in a box. Combine one horizontal alignment, one
+// vertical alignment and any of the others.
+//
+#define VECTOR_FONT_SIMPLEX_ALIGN_LEFT    (0)
+#define VECTOR_FONT_SIMPLEX_ALIGN_CENTER  (1)
+#define VECTOR_FONT_SIMPLEX_ALIGN_RIGHT   (2)
+#define VECTOR_FONT_SIMPLEX_ALIGN_TOP     (0)
+#define VECTOR_FONT_SIMPLEX_ALIGN_MIDDLE  (4)
+#define VECTOR_FONT_SIMPLEX_ALIGN_BOTTOM  (8)
+#define VECTOR_FONT_SIMPLEX_WRAP          (16)    // break lines at spaces to fit the box width
+#define VECTOR_FONT_SIMPLEX_CLIP          (32)    // drop glyphs and lines that aren't entirely inside the box
+
+//
+// A laid out glyph, positioned as for vector_font_simplex_draw.
+//
+typedef struct {
+    double x, y;
+    char   c;
+} vector_font_simplex_glyph_t;
+
+//
+// Lay out a string in the box with top left corner (x, y) and the given
+// width and height.
+//
+// '\n' starts a new line, and lines are spaced by the line height. A width or
+// height of 0 makes the box a line or point in that direction: text is then
+// aligned around it, and it isn't wrapped or clipped that way.
+//
+// Writes up to max_glyphs glyphs to out_glyphs, and sets out_nglyphs to the
+// number of glyphs there are to draw. Spaces aren't included.
+//
+int vector_font_simplex_layout(double x, double y, double width, double height, double scale, int flags, const char *s,
+                               vector_font_simplex_glyph_t *out_glyphs, int max_glyphs, int *out_nglyphs);
+
+//
+// Lay out and draw a string in a box, as for vector_font_simplex_layout.
+//
+int vector_font_simplex_draw_box(vector_display_t *display, double x, double y, double width, double height,
+                                 double scale, int flags, const char *s);
+
+//
+// A cache of tessellated glyphs and strings for one vector display.
+//
+// vector_font_simplex_draw_cached draws like vector_font_simplex_draw, but
+// tessellates each glyph only once per scale, thickness and color, and copies
+// strings it has drawn recently into the frame in one go.
+// vector_font_simplex_draw_box_cached also keeps the layouts of short strings,
+// so a label that doesn't change isn't laid out again. The cache has a fixed
+// size; the least recently used entries are replaced.
+//
+// Delete the cache before its display. Clear it after changing
+// vector_display_set_gpu_lines.
+//
+typedef struct vector_font_simplex_cache vector_font_simplex_cache_t;
+
+int  vector_font_simplex_cache_new(vector_display_t *display, vector_font_simplex_cache_t **out_cache);
+void vector_font_simplex_cache_delete(vector_font_simplex_cache_t *cache);
+int  vector_font_simplex_cache_clear(vector_font_simplex_cache_t *cache);
+int  vector_font_simplex_draw_cached(vector_font_simplex_cache_t *cache, double x, double y, double scale, const char *s);
+int  vector_font_simplex_draw_box_cached(vector_font_simplex_cache_t *cache, double x, double y, double width, double height,
+                                         double scale, int flags, const char *s);
+
+//
+// A grid of fixed size character cells, for terminals and consoles.
+//
+// Cells hold a character and a color, and start out as white spaces. Glyphs
+// are centered in cells 24 units wide and as tall as a line, 32 units, at
+// scale 1. Row 0 is at the top.
+//
+// The grid only tessellates rows whose cells changed since it was last drawn,
+// and scrolling moves rows without tessellating them again, so drawing a grid
+// that changes little costs little more than one display list per row. Like
+// vector_display_draw_list, vector_font_simplex_grid_draw fails while a list
+// is being recorded.
+//
+// Glyphs are tessellated through cache, which several grids and cached text
+// drawing on the same display can share, so each glyph is tessellated once
+// for all of them. Delete the grid before its cache, and the cache before the
+// display. Invalidate the grid after changing vector_display_set_gpu_lines;
+// that clears the cache too.
+//
+typedef struct vector_font_simplex_grid vector_font_simplex_grid_t;
+
+int  vector_font_simplex_grid_new(vector_font_simplex_cache_t *cache, int rows, int columns, vector_font_simplex_grid_t **out_grid);
+void vector_font_simplex_grid_delete(vector_font_simplex_grid_t *grid);
+
+//
+// Set one cell, or the cells from (row, column) onwards to the characters of
+// s, up to the end of the row. Characters the font doesn't have become spaces.
+//
+int  vector_font_simplex_grid_set(vector_font_simplex_grid_t *grid, int row, int column, char c, double r, double g, double b);
+int  vector_font_simplex_grid_print(vector_font_simplex_grid_t *grid, int row, int column, double r, double g, double b, const char *s);
+
+//
+// Clear all cells.
+//
+int  vector_font_simplex_grid_clear(vector_font_simplex_grid_t *grid);
+
+//
+// Move the rows up by lines, or down if lines is negative. Rows that move in
+// are cleared.
+//
+int  vector_font_simplex_grid_scroll(vector_font_simplex_grid_t *grid, int lines);
+
+//
+// Tessellate every row again at the next draw.
+//
+int  vector_font_simplex_grid_invalidate(vector_font_simplex_grid_t *grid);
+
+//
+// Draw the grid with the top left corner of its first cell at (x, y).
+//
+int  vector_font_simplex_grid_draw(vector_font_simplex_grid_t *grid, double x, double y, double scale);
+void vector_font_simplex_grid_get_cell_size(double scale, double *out_width, double *out_height);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,10 +6,8 @@
 int
 vector_shape_draw_line(vector_display_t *display, double x0, double y0, double x1, double y1)
 {
-    vector_display_begin_draw(display, x0, y0);
-    vector_display_draw_to(display, x1, y1);
-    vector_display_end_draw(display);
-    return 0;
+    double xy[] = { x0, y0, x1, y1 };
+    return vector_display_draw_segments(display, xy, 1);
 }
 
 int
@@ -17,26 +15,28 @@ vector_shape_draw_wheel(vector_display_t *display, double angle, double x, doubl
 {
     double spokeradius = radius - 2.0f;
     // draw spokes
-    vector_shape_draw_line(display,
+    double spokes[] = {
               x + spokeradius * sin(angle),
               y - spokeradius * cos(angle),
               x - spokeradius * sin(angle),
-              y + spokeradius * cos(angle));
-    vector_shape_draw_line(display,
+              y + spokeradius * cos(angle),
+
               x + spokeradius * sin(angle + M_PI / 4.0f),
               y - spokeradius * cos(angle + M_PI / 4.0f),
               x - spokeradius * sin(angle + M_PI / 4.0f),
-              y + spokeradius * cos(angle + M_PI / 4.0f));
-    vector_shape_draw_line(display,
+              y + spokeradius * cos(angle + M_PI / 4.0f),
+
               x + spokeradius * sin(angle + M_PI / 2.0f),
               y - spokeradius * cos(angle + M_PI / 2.0f),
               x - spokeradius * sin(angle + M_PI / 2.0f),
-              y + spokeradius * cos(angle + M_PI / 2.0f));
-    vector_shape_draw_line(display,
+              y + spokeradius * cos(angle + M_PI / 2.0f),
+
               x + spokeradius * sin(angle + 3.0f * M_PI / 4.0f),
               y - spokeradius * cos(angle + 3.0f * M_PI / 4.0f),
               x - spokeradius * sin(angle + 3.0f * M_PI / 4.0f),
-              y + spokeradius * cos(angle + 3.0f * M_PI / 4.0f));
+              y + spokeradius * cos(angle + 3.0f * M_PI / 4.0f),
+    };
+    vector_display_draw_segments(display, spokes, 4);
 
     double edgeangle = 0.0f;
     double angadjust = 0.0f;
@@ -76,13 +76,9 @@ vector_shape_draw_circle(vector_display_t *display, double x, double y, double r
 int
 vector_shape_draw_box(vector_display_t *display, double x, double y, double w, double h)
 {
-    vector_display_begin_draw(display, x, y);
-    vector_display_draw_to(display, x + w, y);
-    vector_display_draw_to(display, x + w, y + h);
-    vector_display_draw_to(display, x, y + h);
-    vector_display_draw_to(display, x, y);
-    vector_display_end_draw(display);
-    return 0;
+    double xy[] = { x, y,  x + w, y,  x + w, y + h,  x, y + h,  x, y };
+    int    count = 5;
+    return vector_display_draw_polylines(display, xy, &count, 1);
 }
 
 int
@@ -8,6 +8,7 @@
 #include "vector_shapes.h"
 
 static vector_display_t *display;
+static vector_font_simplex_cache_t *font_cache;
 static int dwidth;
 static int dheight;
 
@@ -26,10 +27,10 @@ VectorTestImpl_Draw()
     //
     //vector_font_simplex_draw(display, 100, 1300, 5.0, "Hello, World!");
     vector_display_set_color(display, 0.7f, 0.7f, 1.0f);
-    vector_font_simplex_draw(display, (50), (180), (3.5), "ABCDEFGHIJKLMNOPQRSTUVWXYZ");
-    vector_font_simplex_draw(display, (50), (360), (3.5), "abcdefghijklmnopqrstuvwxyz");
-    vector_font_simplex_draw(display, (50), (540), (3.5), buf);
-    vector_font_simplex_draw(display, (50), (720), (3.5), "!@#$%^&*()-=<>/?;:'\"{}[]|\\+=-_");
+    vector_font_simplex_draw_cached(font_cache, (50), (180), (3.5), "ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    vector_font_simplex_draw_cached(font_cache, (50), (360), (3.5), "abcdefghijklmnopqrstuvwxyz");
+    vector_font_simplex_draw_cached(font_cache, (50), (540), (3.5), buf);
+    vector_font_simplex_draw_cached(font_cache, (50), (720), (3.5), "!@#$%^&*()-=<>/?;:'\"{}[]|\\+=-_");
 
 
     //
@@ -113,6 +114,12 @@ VectorTestImpl_Init(int w, int h)
     }
 
     resize(w, h);
+
+    rc = vector_font_simplex_cache_new(display, &font_cache);
+    if (rc != 0) {
+        printf("Failed to create font cache: rc=%d", rc);
+        exit(1);
+    }
 }
 
 void
@@ -131,5 +138,6 @@ VectorTestImpl_Destroy()
         printf("Failed to tear down vector display: rc=%d", rc);
         exit(1);
     }
+    vector_font_simplex_cache_delete(font_cache);
     vector_display_delete(display);
 }